@@ -1,11 +1,72 @@
 ﻿
 #include "NPJSON.h"
+#include <limits.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdlib.h>
 
-#define NEW(TYPE, SIZE)        (TYPE *)NPJSON_Malloc(SIZE * sizeof(TYPE))
+#if defined(CFG_NPJSON_STATS) && !defined(_WIN32)
+#include <time.h>
+#endif
+
+#if !defined(CFG_NPJSON_NO_MMAP) || defined(CFG_NPJSON_STATS)
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+#if !defined(CFG_NPJSON_NO_THREAD)
+#if defined(_WIN32)
+#include <windows.h>
+#define NPJSON_THREAD
+#define NPJSON_THREAD_WIN32
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define NPJSON_THREAD
+#endif
+#endif
+
+#define NEW(TYPE, SIZE)        (NPJSON_STAT_ALLOC((SIZE) * sizeof(TYPE)), (TYPE *)NPJSON_Malloc((SIZE) * sizeof(TYPE)))
 #define DELETE(OBJ)            NPJSON_Free(OBJ)
-#define REDIM(TYPE, OBJ, SIZE) (TYPE *)NPJSON_Realloc(OBJ, SIZE * sizeof(TYPE))
+#define REDIM(TYPE, OBJ, SIZE) (NPJSON_STAT_ALLOC((SIZE) * sizeof(TYPE)), (TYPE *)NPJSON_Realloc(OBJ, (SIZE) * sizeof(TYPE)))
+
+// 指定分配器 A 为 NULL 时使用 NPJSON_Malloc/NPJSON_Free/NPJSON_Realloc
+#define ALLOC(A)                   ((A) != NPJSON_NULL ? (A) : &_NPJSON_DefaultAllocator)
+#define ANEW(A, TYPE, SIZE)        (NPJSON_STAT_ALLOC((SIZE) * sizeof(TYPE)), (TYPE *)ALLOC(A)->Malloc(ALLOC(A)->ctx, (SIZE) * sizeof(TYPE)))
+#define ADELETE(A, OBJ)            ALLOC(A)->Free(ALLOC(A)->ctx, (void *)(OBJ))
+#define AREDIM(A, TYPE, OBJ, SIZE) (NPJSON_STAT_ALLOC((SIZE) * sizeof(TYPE)), (TYPE *)ALLOC(A)->Realloc(ALLOC(A)->ctx, OBJ, (SIZE) * sizeof(TYPE)))
+
+// 线程局部变量
+#if defined(_MSC_VER)
+#define NPJSON_TLS __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define NPJSON_TLS __thread
+#else
+#define NPJSON_TLS _Thread_local
+#endif
+
+// 统计（CFG_NPJSON_STATS）
+#if defined(CFG_NPJSON_STATS)
+static NPJSON_TLS NPJSON_Stats _NPJSON_Stats;
+#define NPJSON_STAT_ADD(field, n) (_NPJSON_Stats.field += (n))
+#define NPJSON_STAT_ALLOC(size)   (_NPJSON_Stats.allocs++, _NPJSON_Stats.allocBytes += (size))
+#define NPJSON_STAT_DEPTH(level)               \
+    if ((uint32_t)(level) > _NPJSON_Stats.maxDepth) \
+    _NPJSON_Stats.maxDepth = (uint32_t)(level)
+#define NPJSON_STAT_BEGIN()      uint64_t __stat_t0 = _NPJSON_Clock()
+#define NPJSON_STAT_END(hist)    _NPJSON_StatLatency(_NPJSON_Stats.hist, _NPJSON_Clock() - __stat_t0)
+#else
+#define NPJSON_STAT_ADD(field, n) ((void)0)
+#define NPJSON_STAT_ALLOC(size)   ((void)0)
+#define NPJSON_STAT_DEPTH(level)  ((void)0)
+#define NPJSON_STAT_BEGIN()       ((void)0)
+#define NPJSON_STAT_END(hist)     ((void)0)
+#endif
 
 #define NPJSON_NULL 0
 
@@ -47,6 +108,83 @@ const NPJSON_t *NPJSON_Import(void)
     return &NPJSON;
 }
 
+static void *_NPJSON_DefaultMalloc(void *ctx, size_t size)
+{
+    (void)ctx;
+    return NPJSON_Malloc(size);
+}
+
+static void _NPJSON_DefaultFree(void *ctx, void *ptr)
+{
+    (void)ctx;
+    NPJSON_Free(ptr);
+}
+
+static void *_NPJSON_DefaultRealloc(void *ctx, void *ptr, size_t size)
+{
+    (void)ctx;
+    return NPJSON_Realloc(ptr, size);
+}
+
+static const NPJSON_Allocator _NPJSON_DefaultAllocator = {
+    _NPJSON_DefaultMalloc,
+    _NPJSON_DefaultFree,
+    _NPJSON_DefaultRealloc,
+    NPJSON_NULL,
+};
+
+#if defined(CFG_NPJSON_STATS)
+// 单调时钟（纳秒）
+static uint64_t _NPJSON_Clock(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER        now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return (uint64_t)clock() * (1000000000ULL / CLOCKS_PER_SEC);
+#endif
+}
+
+// 直方图第 i 格为 [2^i, 2^(i+1)) 纳秒
+static void _NPJSON_StatLatency(uint64_t *hist, uint64_t ns)
+{
+    int i = 0;
+    while (ns > 1 && i < NPJSON_STATS_BUCKETS - 1) {
+        ns >>= 1;
+        i++;
+    }
+    hist[i]++;
+}
+#endif
+
+bool NPJSON_GetStats(NPJSON_Stats *st)
+{
+    if (st == NPJSON_NULL)
+        return false;
+#if defined(CFG_NPJSON_STATS)
+    *st = _NPJSON_Stats;
+    return true;
+#else
+    memset(st, 0, sizeof(NPJSON_Stats));
+    return false;
+#endif
+}
+
+void NPJSON_ResetStats(void)
+{
+#if defined(CFG_NPJSON_STATS)
+    memset(&_NPJSON_Stats, 0, sizeof(NPJSON_Stats));
+#endif
+}
+
 static size_t CM_vsnprintf(char *buf, size_t maxlen, const char *format, va_list val)
 {
     if (maxlen == 0 || buf == NULL)
@@ -69,10 +207,650 @@ static size_t CM_snprintf(char *buf, size_t maxlen, const char *format, ...)
     return rs;
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 字符扫描 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+#if !defined(CFG_NPJSON_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NPJSON_SIMD_AVX2
+#define NPJSON_SIMD_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NPJSON_SIMD_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NPJSON_SIMD_NEON
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static int _NPJSON_Ctz(uint32_t v)
+{
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return (int)idx;
+}
+#else
+#define _NPJSON_Ctz(v) __builtin_ctz(v)
+#endif
+
+// 转义字符表 0：不需要转义 'u'：\u00XX
+static const char _NPJSON_EscTab[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '\"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0};
+
+// 查找第一个需要转义的字符（" \ 控制字符），返回偏移，没有返回 len
+static size_t _NPJSON_ScanEscape(const char *str, size_t len)
+{
+    size_t i = 0;
+#if defined(NPJSON_SIMD_AVX2)
+    const __m256i q32  = _mm256_set1_epi8('\"');
+    const __m256i bs32 = _mm256_set1_epi8('\\');
+    const __m256i ct32 = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(str + i));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, q32), _mm256_cmpeq_epi8(v, bs32)),
+                                    _mm256_cmpeq_epi8(_mm256_max_epu8(v, ct32), ct32));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+        if (mask != 0)
+            return i + _NPJSON_Ctz(mask);
+    }
+#endif
+#if defined(NPJSON_SIMD_SSE2)
+    const __m128i q  = _mm_set1_epi8('\"');
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i ct = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, bs)),
+                                 _mm_cmpeq_epi8(_mm_max_epu8(v, ct), ct));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask != 0)
+            return i + _NPJSON_Ctz(mask);
+    }
+#elif defined(NPJSON_SIMD_NEON)
+    const uint8x16_t q  = vdupq_n_u8('\"');
+    const uint8x16_t bs = vdupq_n_u8('\\');
+    const uint8x16_t ct = vdupq_n_u8(0x1F);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)str + i);
+        uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(v, q), vceqq_u8(v, bs)), vcleq_u8(v, ct));
+        if (vmaxvq_u8(m) != 0)
+            break;   // 块内位置交给逐字节处理
+    }
+#endif
+    for (; i < len; i++) {
+        if (_NPJSON_EscTab[(uint8_t)str[i]] != 0)
+            return i;
+    }
+    return len;
+}
+
+// 计算转义后长度
+static int _NPJSON_EscapeLength(const char *str, int len)
+{
+    int    n = len;
+    size_t i = 0;
+    if (len <= 0)
+        return 0;
+    while ((i += _NPJSON_ScanEscape(str + i, len - i)) < (size_t)len)
+        n += _NPJSON_EscTab[(uint8_t)str[i++]] == 'u' ? 5 : 1;
+    return n;
+}
+
+// 转义复制 esc_len 为 _NPJSON_EscapeLength 结果，返回写入结束位置
+static char *_NPJSON_EscapeCopy(char *idx, const char *str, int len, int esc_len)
+{
+    const char HEX[] = "0123456789abcdef";
+    if (esc_len == len) {
+        // 不需要转义
+        memcpy(idx, str, len);
+        return idx + len;
+    }
+    const char *strend = str + len;
+    while (str != strend) {
+        size_t n = _NPJSON_ScanEscape(str, strend - str);
+        memcpy(idx, str, n);
+        idx += n;
+        str += n;
+        if (str == strend)
+            break;
+        uint8_t ch = (uint8_t)*str++;
+        char    e  = _NPJSON_EscTab[ch];
+        *idx++     = '\\';
+        if (e == 'u') {
+            *idx++ = 'u';
+            *idx++ = '0';
+            *idx++ = '0';
+            *idx++ = HEX[ch >> 4];
+            *idx++ = HEX[ch & 0x0F];
+        } else
+            *idx++ = e;
+    }
+    return idx;
+}
+
+// 查找第一个结构字符（" { } [ ]），返回偏移，没有返回 len
+static size_t _NPJSON_ScanStruct(const char *str, size_t len)
+{
+    size_t i = 0;
+#if defined(NPJSON_SIMD_SSE2)
+    // [ ] 与 0x20 或运算后分别等于 { }
+    const __m128i q  = _mm_set1_epi8('\"');
+    const __m128i lb = _mm_set1_epi8('{');
+    const __m128i rb = _mm_set1_epi8('}');
+    const __m128i lc = _mm_set1_epi8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i l = _mm_or_si128(v, lc);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_or_si128(_mm_cmpeq_epi8(l, lb), _mm_cmpeq_epi8(l, rb)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask != 0)
+            return i + _NPJSON_Ctz(mask);
+    }
+#elif defined(NPJSON_SIMD_NEON)
+    const uint8x16_t q  = vdupq_n_u8('\"');
+    const uint8x16_t lb = vdupq_n_u8('{');
+    const uint8x16_t rb = vdupq_n_u8('}');
+    const uint8x16_t lc = vdupq_n_u8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)str + i);
+        uint8x16_t l = vorrq_u8(v, lc);
+        uint8x16_t m = vorrq_u8(vceqq_u8(v, q), vorrq_u8(vceqq_u8(l, lb), vceqq_u8(l, rb)));
+        if (vmaxvq_u8(m) != 0)
+            break;
+    }
+#endif
+    for (; i < len; i++) {
+        char ch = str[i] | 0x20;
+        if (str[i] == '\"' || ch == '{' || ch == '}')
+            return i;
+    }
+    return len;
+}
+
+// 查找字符串结束的 "，p 指向开始 " 之后，esc 返回是否包含转义，失败返回 null
+static const char *_NPJSON_StringEnd(const char *p, const char *strend, bool *esc)
+{
+    while (p != strend) {
+        p += _NPJSON_ScanEscape(p, strend - p);
+        if (p == strend)
+            break;
+        if (*p == '\"')
+            return p;
+        if (*p == '\\') {
+            if (esc != NPJSON_NULL)
+                *esc = true;
+            if (++p == strend)
+                break;
+        } else if (*p == '\r' || *p == '\n')
+            break;
+        p++;
+    }
+    return NPJSON_NULL;
+}
+
+// 查找匹配的 } 或 ]，p 指向 { 或 [，跳过字符串内容，失败返回 null
+static const char *_NPJSON_MatchBracket(const char *p, const char *strend)
+{
+#if defined(CFG_NPJSON_STATS)
+    const char *start = p;
+#endif
+    int lv = 0;
+    while (p != strend) {
+        p += _NPJSON_ScanStruct(p, strend - p);
+        if (p == strend)
+            break;
+        char ch = *p;
+        if (ch == '\"') {
+            p = _NPJSON_StringEnd(p + 1, strend, NPJSON_NULL);
+            if (p == NPJSON_NULL)
+                return NPJSON_NULL;
+        } else if (ch == '{' || ch == '[')
+            lv++;
+        else if (--lv == 0) {
+            NPJSON_STAT_ADD(scannedBytes, p - start + 1);
+            return p;
+        }
+        p++;
+    }
+    return NPJSON_NULL;
+}
+
+static int _NPJSON_Hex4(const char *p)
+{
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char ch = p[i];
+        v <<= 4;
+        if (ch >= '0' && ch <= '9')
+            v |= ch - '0';
+        else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f')
+            v |= (ch | 0x20) - 'a' + 10;
+        else
+            return -1;
+    }
+    return v;
+}
+
+// 字符串反转义 \uXXXX 转换为 UTF-8，结果长度不超过 len，失败返回 -1
+static int _NPJSON_Unescape(char *dst, const char *str, int len)
+{
+    char       *d      = dst;
+    const char *strend = str + len;
+    while (str != strend) {
+        const char *s = str;
+        while (str != strend && *str != '\\')
+            str++;
+        memcpy(d, s, str - s);
+        d += str - s;
+        if (str == strend)
+            break;
+        if (++str == strend)
+            return -1;
+        char ch = *str++;
+        switch (ch) {
+            case '\"':
+            case '\\':
+            case '/': *d++ = ch; break;
+            case 'b': *d++ = '\b'; break;
+            case 'f': *d++ = '\f'; break;
+            case 'n': *d++ = '\n'; break;
+            case 'r': *d++ = '\r'; break;
+            case 't': *d++ = '\t'; break;
+            case 'u': {
+                if (strend - str < 4)
+                    return -1;
+                long cp = _NPJSON_Hex4(str);
+                str += 4;
+                if (cp < 0 || (cp >= 0xDC00 && cp <= 0xDFFF))
+                    return -1;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // 代理对
+                    if (strend - str < 6 || str[0] != '\\' || str[1] != 'u')
+                        return -1;
+                    long lo = _NPJSON_Hex4(str + 2);
+                    if (lo < 0xDC00 || lo > 0xDFFF)
+                        return -1;
+                    str += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                if (cp < 0x80)
+                    *d++ = (char)cp;
+                else if (cp < 0x800) {
+                    *d++ = (char)(0xC0 | (cp >> 6));
+                    *d++ = (char)(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    *d++ = (char)(0xE0 | (cp >> 12));
+                    *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    *d++ = (char)(0x80 | (cp & 0x3F));
+                } else {
+                    *d++ = (char)(0xF0 | (cp >> 18));
+                    *d++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+                    *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    *d++ = (char)(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default: return -1;
+        }
+    }
+    return d - dst;
+}
+
+// 查找第一个非法 UTF-8 序列，返回其位置，全部合法返回 end
+static const char *_NPJSON_UTF8Invalid(const char *str, const char *strend)
+{
+    const uint8_t *p   = (const uint8_t *)str;
+    const uint8_t *end = (const uint8_t *)strend;
+    while (p != end) {
+        // ASCII 快速跳过
+#if defined(NPJSON_SIMD_AVX2)
+        while (end - p >= 32 && _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)p)) == 0)
+            p += 32;
+#endif
+#if defined(NPJSON_SIMD_SSE2)
+        while (end - p >= 16 && _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p)) == 0)
+            p += 16;
+#elif defined(NPJSON_SIMD_NEON)
+        while (end - p >= 16 && vmaxvq_u8(vld1q_u8(p)) < 0x80)
+            p += 16;
+#endif
+        while (p != end && *p < 0x80)
+            p++;
+        if (p == end)
+            break;
+        uint8_t c = *p;
+        int     n;
+        uint8_t lo = 0x80, hi = 0xBF;   // 第二字节范围，排除超长编码、代理区、超过 U+10FFFF
+        if (c >= 0xC2 && c <= 0xDF)
+            n = 1;
+        else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+            if (c == 0xE0)
+                lo = 0xA0;
+            else if (c == 0xED)
+                hi = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+            if (c == 0xF0)
+                lo = 0x90;
+            else if (c == 0xF4)
+                hi = 0x8F;
+        } else
+            return (const char *)p;
+        if (end - p <= n || p[1] < lo || p[1] > hi)
+            return (const char *)p;
+        for (int i = 2; i <= n; i++) {
+            if ((p[i] & 0xC0) != 0x80)
+                return (const char *)p;
+        }
+        p += n + 1;
+    }
+    return strend;
+}
+
+bool NPJSON_CheckUTF8(const char *str, size_t len)
+{
+    if (str == NPJSON_NULL)
+        return len == 0;
+    return _NPJSON_UTF8Invalid(str, str + len) == str + len;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 严格校验 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+static const char *_NPJSON_SkipSpace(const char *p, const char *strend)
+{
+    while (p != strend && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        p++;
+    return p;
+}
+
+// 校验字符串，p 指向开始 "，成功返回结束 " 之后，失败返回 null 并由 at 返回位置
+static const char *_NPJSON_ValidateString(const char *p, const char *strend, const char **at)
+{
+    p++;
+    while (true) {
+        size_t      n   = _NPJSON_ScanEscape(p, strend - p);
+        const char *bad = _NPJSON_UTF8Invalid(p, p + n);
+        if (bad != p + n) {
+            *at = bad;
+            return NPJSON_NULL;
+        }
+        p += n;
+        if (p == strend || (uint8_t)*p < 0x20) {
+            *at = p;   // 未结束或未转义的控制字符
+            return NPJSON_NULL;
+        }
+        if (*p == '\"')
+            return p + 1;
+        // 转义
+        *at = p;
+        if (++p == strend)
+            return NPJSON_NULL;
+        switch (*p) {
+            case '\"':
+            case '\\':
+            case '/':
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't': p++; break;
+            case 'u':
+                if (strend - p < 5 || _NPJSON_Hex4(p + 1) < 0)
+                    return NPJSON_NULL;
+                p += 5;
+                break;
+            default: return NPJSON_NULL;
+        }
+    }
+}
+
+// 校验数字 number = [ minus ] int [ frac ] [ exp ]，失败返回 null
+static const char *_NPJSON_ValidateNumber(const char *p, const char *strend)
+{
+    if (p != strend && *p == '-')
+        p++;
+    if (p == strend || *p < '0' || *p > '9')
+        return NPJSON_NULL;
+    if (*p++ != '0') {
+        while (p != strend && *p >= '0' && *p <= '9')
+            p++;
+    }
+    if (p != strend && *p == '.') {
+        if (++p == strend || *p < '0' || *p > '9')
+            return NPJSON_NULL;
+        while (p != strend && *p >= '0' && *p <= '9')
+            p++;
+    }
+    if (p != strend && (*p | 0x20) == 'e') {
+        if (++p != strend && (*p == '+' || *p == '-'))
+            p++;
+        if (p == strend || *p < '0' || *p > '9')
+            return NPJSON_NULL;
+        while (p != strend && *p >= '0' && *p <= '9')
+            p++;
+    }
+    return p;
+}
+
+// 校验字面量 true false null
+static const char *_NPJSON_ValidateLiteral(const char *p, const char *strend, const char *lit, size_t n)
+{
+    if ((size_t)(strend - p) < n || memcmp(p, lit, n) != 0)
+        return NPJSON_NULL;
+    return p + n;
+}
+
+#define _NPJSON_BitGet(st, i) (((st)[(i) >> 6] >> ((i) & 63)) & 1)
+
+bool NPJSON_Validate(const char *str, size_t len, const char **err)
+{
+    uint64_t    stack[(NPJSON_MAX_DEPTH + 63) / 64];   // 位栈 每层 1 位 1：数组 0：对象
+    int         depth   = 0;
+    bool        isArray = false;
+    bool        member  = false;   // 值之前需要成员名
+    const char *strend  = str + len;
+    const char *p       = str;
+    const char *at      = str;
+    if (str == NPJSON_NULL) {
+        if (err != NPJSON_NULL)
+            *err = NPJSON_NULL;
+        return false;
+    }
+    while (true) {
+        p  = _NPJSON_SkipSpace(p, strend);
+        at = p;
+        if (member) {
+            if (p == strend || *p != '\"' || (p = _NPJSON_ValidateString(p, strend, &at)) == NPJSON_NULL)
+                break;
+            p  = _NPJSON_SkipSpace(p, strend);
+            at = p;
+            if (p == strend || *p != ':')
+                break;
+            p  = _NPJSON_SkipSpace(p + 1, strend);
+            at = p;
+        }
+        if (p == strend)
+            break;
+        if (*p == '{' || *p == '[') {
+            if (depth == NPJSON_MAX_DEPTH)
+                break;
+            isArray = *p == '[';
+            if (isArray)
+                stack[depth >> 6] |= (uint64_t)1 << (depth & 63);
+            else
+                stack[depth >> 6] &= ~((uint64_t)1 << (depth & 63));
+            depth++;
+            p  = _NPJSON_SkipSpace(p + 1, strend);
+            at = p;
+            if (p == strend || *p != (isArray ? ']' : '}')) {
+                member = !isArray;
+                continue;
+            }
+            depth--;   // 空容器
+            p++;
+        } else {
+            switch (*p) {
+                case '\"': p = _NPJSON_ValidateString(p, strend, &at); break;
+                case 't': p = _NPJSON_ValidateLiteral(p, strend, "true", 4); break;
+                case 'f': p = _NPJSON_ValidateLiteral(p, strend, "false", 5); break;
+                case 'n': p = _NPJSON_ValidateLiteral(p, strend, "null", 4); break;
+                default: p = _NPJSON_ValidateNumber(p, strend); break;
+            }
+            if (p == NPJSON_NULL)
+                break;
+        }
+        // 值之后：结束括号 或 ,
+        while (true) {
+            p  = _NPJSON_SkipSpace(p, strend);
+            at = p;
+            if (depth == 0 || p == strend)
+                break;
+            isArray = _NPJSON_BitGet(stack, depth - 1);
+            if (*p != (isArray ? ']' : '}'))
+                break;
+            depth--;
+            p++;
+        }
+        if (depth == 0) {
+            if (p == strend)
+                return true;
+            break;
+        }
+        if (p == strend || *p != ',')
+            break;
+        p++;
+        member = !isArray;
+    }
+    if (err != NPJSON_NULL)
+        *err = at;
+    return false;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //                                             | JSON 解析 |
 // ---------------------------------------------------------------------------------------------------------------------
 
+// 确保解码缓存大小
+static bool _NPJSON_CheckBuffer(NPJSON_Result *re, int size)
+{
+    if (re->bufsize > size)
+        return true;
+    char *tmp = re->buf == NPJSON_NULL ? ANEW(re->alloc, char, size + 1) : AREDIM(re->alloc, char, re->buf, size + 1);
+    if (tmp == NPJSON_NULL)
+        return false;
+    re->buf     = tmp;
+    re->bufsize = size + 1;
+    return true;
+}
+
+// 设置字符串值，包含转义时解码到缓存
+static bool _NPJSON_ResolveString(NPJSON_Result *re, const char *str, int len, bool esc)
+{
+    if (esc) {
+        if (!_NPJSON_CheckBuffer(re, len))
+            return false;
+        len = _NPJSON_Unescape(re->buf, str, len);
+        if (len < 0)
+            return false;
+        str = re->buf;
+    }
+#if defined(CFG_NPJSON_UTF8_CHECK)
+    if (!NPJSON_CheckUTF8(str, len))
+        return false;
+#endif
+    re->Val.String.ptr    = str;
+    re->Val.String.length = len;
+    return true;
+}
+
+// 设置对象名称，超过 NPJSON_NAME_LEN 截断
+static bool _NPJSON_ResolveName(NPJSON_Result *re, const char *str, int len, bool esc)
+{
+    if (!_NPJSON_ResolveString(re, str, len, esc))
+        return false;
+    int n = re->Val.String.length;
+    if (n > NPJSON_NAME_LEN)
+        n = NPJSON_NAME_LEN;
+    memcpy(re->name, re->Val.String.ptr, n);
+    re->name[n]           = '\0';
+    re->Val.String.ptr    = NPJSON_NULL;
+    re->Val.String.length = 0;
+    return true;
+}
+
+// 获取值范围，返回值之后的分隔符位置，失败返回 null
+static const char *_NPJSON_ValueEnd(const char *p, const char *strend)
+{
+    if (*p == '{' || *p == '[') {
+        p = _NPJSON_MatchBracket(p, strend);
+        if (p == NPJSON_NULL)
+            return NPJSON_NULL;
+        p++;
+    } else if (*p == '\"') {
+        p = _NPJSON_StringEnd(p + 1, strend, NPJSON_NULL);
+        if (p == NPJSON_NULL)
+            return NPJSON_NULL;
+        p++;
+    } else {
+        // 数值
+        while (p != strend && *p != ',' && *p != ']' && *p != '}') {
+            if (*p == '{' || *p == '[')
+                return NPJSON_NULL;
+            p++;
+        }
+    }
+    SKIPBLANK;
+    return p == strend ? NPJSON_NULL : p;
+}
+
+// 数值 [str, strend) 是否为整数（不含 . e E）
+static bool _NPJSON_IsInteger(const char *str, const char *strend)
+{
+    for (const char *p = str + 1; p < strend; p++) {
+        if (*p == '.' || (*p | 0x20) == 'e')
+            return false;
+    }
+    return true;
+}
+
+// 数值转换 [str, strend) 为数值范围，返回是否为整数
+static bool _NPJSON_ResolveNumber(const char *str, const char *strend, long long *value, double *number)
+{
+    // 安全检查 ， atoll、atof 是不安全的
+    bool        isXs = false;   // 是否为小数
+    bool        isE  = false;
+    const char *p    = str + 1;
+    while (p != strend) {
+        if (*p == 'e' || *p == 'E')
+            isE = true;
+        if (*p == '.')
+            isXs = true;
+        p++;
+    }
+    *number = atof(str);
+    if (isE) {
+        // 科学计数
+        if (*number >= 9223372036854775807.0 || *number <= -9223372036854775808.0)
+            *value = *number > 0 ? INT64_MAX : INT64_MIN;
+        else
+            *value = (long long)*number;
+    } else
+        *value = atoll(str);
+    return !isXs && !isE;
+}
+
 const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const char *str, const char *strend, void *obj)
 {
     // 获取值
@@ -83,70 +861,36 @@ const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const
     re->isNumber   = 0;
     re->isObject   = 0;
     re->isString   = 0;
+    re->isRaw      = 0;
     re->err        = str;
     do {
         char ch = *str;
         if (ch == '\"') {
             // 字符串处理
-            str++;
-            const char *tstr = str;
-            while (str != strend &&
-                   !(*str == '\"' && *(str - 1) != '\\') &&
-                   *str != '\r' &&
-                   *str != '\n')
-                str++;
-            if (str == strend || *str != '\"')
+            bool        esc  = false;
+            const char *tstr = ++str;
+            str              = _NPJSON_StringEnd(str, strend, &esc);
+            if (str == NPJSON_NULL || !_NPJSON_ResolveString(re, tstr, str - tstr, esc))
                 return NPJSON_NULL;
-            re->Val.String.ptr    = tstr;
-            re->Val.String.length = str - tstr;
-            re->isString          = 1;
-            if (!fun(re->name, re, re->ArrIdx, obj))
+            re->isString = 1;
+            if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                 return NPJSON_NULL;
             re->Val.String.length = 0;
             re->Val.String.ptr    = NPJSON_NULL;
             str++;
             break;
-        } else if (ch == '{') {
-            // JSON对象处理
-            re->str = str++;
-            int lv  = 1;
-            while (str != strend) {
-                if (*str == '{')
-                    lv++;
-                if (*str == '}')
-                    lv--;
-                if (lv < 0)
-                    break;
-                if (lv == 0)
-                    re->Strlength = str - re->str + 1;
-                str++;
-            }
-            if (lv != 0)
-                return NPJSON_NULL;
-            re->isObject = 1;
-            if (!fun(re->name, re, re->ArrIdx, obj))
-                return NPJSON_NULL;
-            break;
-        } else if (ch == '[') {
-            // JSON数组处理
-            re->str = str++;
-            int lv  = 1;
-            while (str != strend) {
-                if (*str == '[')
-                    lv++;
-                if (*str == ']')
-                    lv--;
-                if (lv < 0)
-                    break;
-                if (lv == 0)
-                    re->Strlength = str - re->str + 1;
-                str++;
-            }
-            if (lv != 0)
+        } else if (ch == '{' || ch == '[') {
+            // JSON对象、数组处理
+            const char *e = _NPJSON_MatchBracket(str, strend);
+            if (e == NPJSON_NULL || (*e == '}') != (ch == '{'))
                 return NPJSON_NULL;
-            re->isArray = 1;
-            if (!fun(re->name, re, re->ArrIdx, obj))
+            re->str       = str;
+            re->Strlength = e - str + 1;
+            re->isObject  = ch == '{';
+            re->isArray   = ch == '[';
+            if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                 return NPJSON_NULL;
+            str = e + 1;
             break;
         } else if (IS_STRING(ch)) {
             // 二值量处理
@@ -157,7 +901,7 @@ const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const
                 re->isBinValue   = 1;
                 re->Val.BinValue = true;
                 re->Val.Value    = 1;
-                if (!fun(re->name, re, re->ArrIdx, obj))
+                if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                     return NPJSON_NULL;
                 str += sizeof(STR_TRUE) - 1;
                 re->isBinValue = 0;
@@ -167,7 +911,7 @@ const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const
                 re->isBinValue   = 1;
                 re->Val.BinValue = false;
                 re->Val.Value    = 0;
-                if (!fun(re->name, re, re->ArrIdx, obj))
+                if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                     return NPJSON_NULL;
                 str += sizeof(STR_FLASE) - 1;
                 re->isBinValue = 0;
@@ -175,37 +919,33 @@ const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const
             }
             if (strend - str >= (int)sizeof(STR_NULL) - 1 && memcmp(str, STR_NULL, sizeof(STR_NULL) - 1) == 0) {
                 re->isNull = 1;
-                if (!fun(re->name, re, re->ArrIdx, obj))
+                if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                     return NPJSON_NULL;
                 str += sizeof(STR_NULL) - 1;
                 break;
             }
             return NPJSON_NULL;
         } else if (IS_NUMBER(ch)) {
-            const char *tstr = str;
-            // 安全检查 ， atoll、atof 是不安全的
-            bool isXs = false;   // 是否为小数
-            bool isE  = false;
-            str++;
-            while (str != strend) {
-                if (*str == 'e' || *str == 'E')
-                    isE = true;
-                if (*str == '.')
-                    isXs = true;
-                str++;
-            }
-            if (isE) {
-                // 科学计数
-                re->Val.Number = atof(tstr);
-                re->Val.Value  = (long long)re->Val.Number;
+            // 原文 去掉尾部空白
+            const char *e = strend;
+            while (e != str && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\f' || e[-1] == '\r' || e[-1] == '\n'))
+                e--;
+            re->Val.Raw.ptr    = str;
+            re->Val.Raw.length = e - str;
+            re->isNumber       = 1;
+            if (re->lazyNumber) {
+                // 只分类 读取时再转换 原文会原样输出，不符合数字语法时解析失败
+                if (_NPJSON_ValidateNumber(str, e) != e)
+                    return NPJSON_NULL;
+                re->isRaw     = 1;
+                re->isInteger = _NPJSON_IsInteger(str, e);
             } else {
-                re->Val.Number = atof(tstr);
-                re->Val.Value  = atoll(tstr);
+                re->isRaw        = 0;
+                re->isInteger    = _NPJSON_ResolveNumber(str, strend, &re->Val.Value, &re->Val.Number);
+                re->Val.BinValue = re->Val.Value != 0;
             }
-            re->isNumber     = 1;
-            re->isInteger    = !isXs;
-            re->Val.BinValue = re->Val.Value != 0;
-            if (!fun(re->name, re, re->ArrIdx, obj))
+            str = strend;
+            if (NPJSON_STAT_ADD(callbacks, 1), !fun(re->name, re, re->ArrIdx, obj))
                 return NPJSON_NULL;
             break;
         } else
@@ -217,14 +957,43 @@ const char *NPJSON_ResolveValue(NPJSON_Result *re, NPJSON_ResolveFunc fun, const
     return p;
 }
 
+// 延迟转换的数值 第一次读取时转换 原文保留在 Val.Raw
+static void _NPJSON_ResultConvert(NPJSON_Result *re)
+{
+    if (!re->isRaw)
+        return;
+    _NPJSON_ResolveNumber(re->Val.Raw.ptr, re->Val.Raw.ptr + re->Val.Raw.length, &re->Val.Value, &re->Val.Number);
+    re->Val.BinValue = re->Val.Value != 0;
+    re->isRaw        = 0;
+}
+
+long long NPJSON_ResultGetInt(NPJSON_Result *re)
+{
+    if (re == NPJSON_NULL)
+        return 0;
+    _NPJSON_ResultConvert(re);
+    return re->Val.Value;
+}
+
+double NPJSON_ResultGetNumber(NPJSON_Result *re)
+{
+    if (re == NPJSON_NULL)
+        return 0;
+    _NPJSON_ResultConvert(re);
+    return re->Val.Number;
+}
+
 bool NPJSON_ResolveExev(NPJSON_Result *re, NPJSON_ResolveFunc fun, void *obj, bool getvalue)
 {
+    (void)getvalue;
     if (re == NPJSON_NULL || re->str == NPJSON_NULL || re->Strlength <= 0 || fun == NPJSON_NULL)
         return false;
     const char *p      = re->str;
     const char *strend = re->str + re->Strlength;
     re->str            = NPJSON_NULL;
     re->Strlength      = 0;
+    NPJSON_STAT_ADD(scannedBytes, strend - p);
+    NPJSON_STAT_DEPTH(re->level);
     SKIPBLANK;
     *re->name = '\0';
     re->err   = p;
@@ -238,16 +1007,11 @@ bool NPJSON_ResolveExev(NPJSON_Result *re, NPJSON_ResolveFunc fun, void *obj, bo
             if (*p != '\"')
                 return false;
             re->err       = p;
-            const char *s = ++p;
-            while (p != strend && (p[-1] == '\\' || (*p != '\"' && *p != '\r' && *p != '\n')))
-                p++;
-            if (p == strend || *p != '\"')
+            bool        esc = false;
+            const char *s   = ++p;
+            p               = _NPJSON_StringEnd(p, strend, &esc);
+            if (p == NPJSON_NULL || !_NPJSON_ResolveName(re, s, p - s, esc))
                 return false;   // 对象名称获取失败
-            int n = p - s;
-            if (n > NPJSON_NAME_LEN)
-                n = NPJSON_NAME_LEN;
-            memcpy(re->name, s, n);
-            re->name[n] = '\0';
             // 检查 :
             p++;
             SKIPBLANK;
@@ -258,45 +1022,8 @@ bool NPJSON_ResolveExev(NPJSON_Result *re, NPJSON_ResolveFunc fun, void *obj, bo
             SKIPBLANK;
             s = p;
             // 获取对象范围
-            if (*s == '[' || *s == '{') {
-                // 对象
-                int lv = 1;
-                while (p != strend) {
-                    if (lv == 1 && *p == '}')
-                        break;
-                    if ((*s == '{' && *p == '{') || (*s == '[' && *p == '['))
-                        lv++;
-                    else if ((*s == '{' && *p == '}') || (*s == '[' && *p == ']'))
-                        lv--;
-                    if (lv < 0)
-                        return false;
-                    if (lv == 1 && *p == ',')
-                        break;
-                    if (lv == 0 && ((*s == '{' && *p == '}') || (*s == '[' && *p == ']')))
-                        break;
-                    p++;
-                }
-            } else if (*s == '\"') {
-                // 字符串
-                p++;
-                while (p != strend) {
-                    if (p[-1] != '\\' && *p == '\"')
-                        break;
-                    p++;
-                }
-                if (*p == '\"')
-                    p++;
-            } else {
-                // 数值
-                while (p != strend) {
-                    if (*p == '{' || *p == '[' || *p == ']')
-                        return false;
-                    if (*p == ',' || *p == ']' || *p == '}')
-                        break;
-                    p++;
-                }
-            }
-            if (p == strend)
+            p = _NPJSON_ValueEnd(s, strend);
+            if (p == NPJSON_NULL)
                 return false;
             re->err = s;
             // 获取对象值
@@ -314,35 +1041,8 @@ bool NPJSON_ResolveExev(NPJSON_Result *re, NPJSON_ResolveFunc fun, void *obj, bo
             // 获取对象值
             const char *s = p;
             re->err       = s;
-            if (*s == '[' || *s == '{') {
-                // 对象
-                int lv = 1;
-                while (p != strend) {
-                    if (lv == 1 && *p == ']')
-                        break;
-                    if ((*s == '{' && *p == '{') || (*s == '[' && *p == '['))
-                        lv++;
-                    else if ((*s == '{' && *p == '}') || (*s == '[' && *p == ']'))
-                        lv--;
-                    if (lv < 0)
-                        return false;
-                    if (lv == 1 && *p == ',')
-                        break;
-                    if (lv == 0 && ((*s == '{' && *p == '}') || (*s == '[' && *p == ']')))
-                        break;
-                    p++;
-                }
-            } else {
-                // 数值
-                while (p != strend) {
-                    if (*p == '{' || *p == '[')
-                        return false;
-                    if (*p == ',' || *p == ']' || *p == '}')
-                        break;
-                    p++;
-                }
-            }
-            if (p == strend)
+            p             = _NPJSON_ValueEnd(s, strend);
+            if (p == NPJSON_NULL)
                 return false;
             re->err = s;
             // 获取对象值
@@ -361,6 +1061,8 @@ static bool _NPJSON_ResolveExev(NPJSON_Result *re, void *obj, NPJSON_ResolveFunc
 {
     if (fun == NPJSON_NULL || re == NPJSON_NULL)
         return 0;
+    if (re->level + 2 > NPJSON_MAX_DEPTH)
+        return false;   // 超出最大嵌套深度
     // 保存状态
     int idx    = re->ArrIdx;
     int lv     = re->level++;
@@ -372,13 +1074,60 @@ static bool _NPJSON_ResolveExev(NPJSON_Result *re, void *obj, NPJSON_ResolveFunc
     return res;
 }
 
-bool NPJSON_Resolve(const char *str, int length, void *obj, NPJSON_ResolveFunc fun, const char **err)
+// 共享缓存 data 为独立分配或紧跟在结构体之后
+struct _NPJSON_Buffer
+{
+    volatile long           refs;    // 引用计数
+    char *                  data;    // 缓存数据
+    const NPJSON_Allocator *alloc;   // 分配器
+};
+
+#if defined(_MSC_VER)
+#define NPJSON_ATOMIC_INC(v) _InterlockedIncrement(v)
+#define NPJSON_ATOMIC_DEC(v) _InterlockedDecrement(v)
+#elif defined(__GNUC__) || defined(__clang__)
+#define NPJSON_ATOMIC_INC(v) __atomic_add_fetch(v, 1, __ATOMIC_RELAXED)
+#define NPJSON_ATOMIC_DEC(v) __atomic_sub_fetch(v, 1, __ATOMIC_ACQ_REL)
+#else
+#define NPJSON_ATOMIC_INC(v) (++*(v))   // 无原子操作时仅限单线程
+#define NPJSON_ATOMIC_DEC(v) (--*(v))
+#endif
+
+// 创建共享缓存 data 为 NULL 时在结构体之后分配 size 字节
+static NPJSON_Buffer *_NPJSON_BufferCreate(const NPJSON_Allocator *alloc, char *data, size_t size)
+{
+    NPJSON_Buffer *b = ANEW(alloc, NPJSON_Buffer, 1 + (data == NPJSON_NULL ? (size + sizeof(NPJSON_Buffer) - 1) / sizeof(NPJSON_Buffer) : 0));
+    if (b == NPJSON_NULL)
+        return NPJSON_NULL;
+    b->refs  = 1;
+    b->alloc = alloc;
+    b->data = data == NPJSON_NULL ? (char *)(b + 1) : data;
+    return b;
+}
+
+static NPJSON_Buffer *_NPJSON_BufferRetain(NPJSON_Buffer *b)
 {
+    if (b != NPJSON_NULL)
+        NPJSON_ATOMIC_INC(&b->refs);
+    return b;
+}
+
+static void _NPJSON_BufferRelease(NPJSON_Buffer *b)
+{
+    if (b == NPJSON_NULL || NPJSON_ATOMIC_DEC(&b->refs) != 0)
+        return;
+    if (b->data != (char *)(b + 1))
+        ADELETE(b->alloc, b->data);
+    ADELETE(b->alloc, b);
+}
+
+static bool _NPJSON_ResolveShared(const char *str, int length, NPJSON_Buffer *share, const NPJSON_Allocator *alloc, bool lazy, void *obj, NPJSON_ResolveFunc fun, const char **err)
+{
+    NPJSON_STAT_BEGIN();
     if (str == NPJSON_NULL || length <= 0 || fun == NPJSON_NULL)
         return false;
     if (err != NPJSON_NULL)
         *err = str;
-    int         lv     = 1;
     const char *p      = str;
     const char *strend = str + length;
     while (p != strend && *p != '{')
@@ -386,19 +1135,14 @@ bool NPJSON_Resolve(const char *str, int length, void *obj, NPJSON_ResolveFunc f
     if (p == strend)
         return false;
     const char *s = p;
-    p++;
-    while (p != strend && lv > 0) {
-        if (*p == '{')
-            lv++;
-        else if (*p == '}')
-            lv--;
-        p++;
-    }
-    if (lv != 0)
+    p             = _NPJSON_MatchBracket(s, strend);
+    if (p == NPJSON_NULL || *p != '}')
         return false;
+    p++;
     NPJSON_Result re;
     memset(&re, 0, sizeof(re));
-    re.name = NEW(char, NPJSON_NAME_LEN + 1);
+    re.alloc = alloc;
+    re.name  = ANEW(alloc, char, NPJSON_NAME_LEN + 1);
     if (re.name == NPJSON_NULL)
         return 0;
     re.err       = s;
@@ -407,18 +1151,40 @@ bool NPJSON_Resolve(const char *str, int length, void *obj, NPJSON_ResolveFunc f
     re.ArrIdx    = 0;
     re.level     = 0;
     re.Resolve   = _NPJSON_ResolveExev;
+    re.share     = share;
+    re.lazyNumber = lazy;
     bool flag    = NPJSON_ResolveExev(&re, fun, obj, true);
-    DELETE(re.name);
+    ADELETE(alloc, re.name);
+    if (re.buf != NPJSON_NULL)
+        ADELETE(alloc, re.buf);
     if (err != NPJSON_NULL)
         *err = flag ? NPJSON_NULL : re.err;
+    NPJSON_STAT_ADD(resolveCalls, 1);
+    NPJSON_STAT_ADD(inputBytes, length);
+    NPJSON_STAT_END(resolveLatency);
     return flag;
 }
 
+bool NPJSON_Resolve(const char *str, int length, void *obj, NPJSON_ResolveFunc fun, const char **err)
+{
+    return _NPJSON_ResolveShared(str, length, NPJSON_NULL, NPJSON_NULL, false, obj, fun, err);
+}
+
+bool NPJSON_ResolveEx(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ResolveFunc fun, const char **err)
+{
+    return _NPJSON_ResolveShared(str, length, NPJSON_NULL, alloc, false, obj, fun, err);
+}
+
+bool NPJSON_ResolveLazy(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ResolveFunc fun, const char **err)
+{
+    return _NPJSON_ResolveShared(str, length, NPJSON_NULL, alloc, true, obj, fun, err);
+}
+
 static bool _NPJSON_ResolveExevObject(NPJSON_RObject *re, void *obj, NPJSON_ResolveFunc fun)
 {
     if (re == NPJSON_NULL)
         return false;
-    return NPJSON_Resolve(re->str, re->Strlength, obj, fun, NPJSON_NULL);
+    return _NPJSON_ResolveShared(re->str, re->Strlength, re->share, re->alloc, false, obj, fun, NPJSON_NULL);
 }
 
 NPJSON_RObject NPJSON_CreateUnSafeObject(const NPJSON_Result *re)
@@ -428,9 +1194,13 @@ NPJSON_RObject NPJSON_CreateUnSafeObject(const NPJSON_Result *re)
     obj.str       = NPJSON_NULL;
     obj.Strlength = 0;
     obj.isSafe    = false;
+    obj.share     = NPJSON_NULL;
+    obj.alloc     = NPJSON_NULL;
     if (re != NPJSON_NULL) {
         obj.str       = re->str;
         obj.Strlength = re->Strlength;
+        obj.share     = re->share;   // 借用 不增加引用
+        obj.alloc     = re->alloc;
     }
     return obj;
 }
@@ -442,8 +1212,15 @@ NPJSON_RObject NPJSON_CreateSafeObject(const NPJSON_Result *re)
     obj.str       = NPJSON_NULL;
     obj.Strlength = 0;
     obj.isSafe    = true;
-    if (re != NPJSON_NULL && re->Strlength > 0 && re->str != NPJSON_NULL) {
-        char *tmp = NEW(char, re->Strlength);
+    obj.share     = NPJSON_NULL;
+    obj.alloc     = re != NPJSON_NULL ? re->alloc : NPJSON_NULL;
+    if (re != NPJSON_NULL && re->Strlength > 0 && re->str != NPJSON_NULL && re->share != NPJSON_NULL) {
+        // 共享缓存片段
+        obj.str       = re->str;
+        obj.Strlength = re->Strlength;
+        obj.share     = _NPJSON_BufferRetain(re->share);
+    } else if (re != NPJSON_NULL && re->Strlength > 0 && re->str != NPJSON_NULL) {
+        char *tmp = ANEW(obj.alloc, char, re->Strlength);
         if (tmp != NPJSON_NULL) {
             memcpy(tmp, re->str, re->Strlength);
             obj.str       = tmp;
@@ -460,7 +1237,13 @@ NPJSON_RObject NPJSON_RObjectUnSafeToSafe(NPJSON_RObject *re)
     obj.str       = NPJSON_NULL;
     obj.Strlength = 0;
     obj.isSafe    = true;
-    if (re != NPJSON_NULL && !re->isSafe && re->str != NPJSON_NULL && re->Strlength > 0) {
+    obj.share     = NPJSON_NULL;
+    obj.alloc     = re != NPJSON_NULL ? re->alloc : NPJSON_NULL;
+    if (re != NPJSON_NULL && !re->isSafe && re->str != NPJSON_NULL && re->Strlength > 0 && re->share != NPJSON_NULL) {
+        obj.str       = re->str;
+        obj.Strlength = re->Strlength;
+        obj.share     = _NPJSON_BufferRetain(re->share);
+    } else if (re != NPJSON_NULL && !re->isSafe && re->str != NPJSON_NULL && re->Strlength > 0) {
         const char *str    = re->str;
         const char *strend = str + re->Strlength;
         while (str != strend && *str != '{')
@@ -469,11 +1252,11 @@ NPJSON_RObject NPJSON_RObjectUnSafeToSafe(NPJSON_RObject *re)
             strend--;
         int length = strend - str + 1;
         if (length > 0) {
-            char *tmp = NEW(char, length);
+            char *tmp = ANEW(obj.alloc, char, length);
             if (tmp != NPJSON_NULL) {
                 memcpy(tmp, str, length);
                 obj.str       = tmp;
-                obj.Strlength = re->Strlength;
+                obj.Strlength = length;
             }
         }
     }
@@ -487,6 +1270,8 @@ NPJSON_RObject NPJSON_ResolveToSafeObject(const char *str, int length)
     obj.str       = NPJSON_NULL;
     obj.Strlength = 0;
     obj.isSafe    = true;
+    obj.share     = NPJSON_NULL;
+    obj.alloc     = NPJSON_NULL;
     if (str != NPJSON_NULL && length > 0) {
         char *tmp = NEW(char, length + 1);
         if (tmp != NPJSON_NULL) {
@@ -503,25 +1288,86 @@ void NPJSON_DeleteSafeObject(NPJSON_RObject *re)
 {
     if (re == NPJSON_NULL || !re->isSafe || re->str == NPJSON_NULL)
         return;
-    DELETE((void *)re->str);
+    if (re->share != NPJSON_NULL)
+        _NPJSON_BufferRelease(re->share);
+    else
+        ADELETE(re->alloc, re->str);
     re->str       = NPJSON_NULL;
     re->Strlength = 0;
+    re->share     = NPJSON_NULL;
     return;
 }
 
+NPJSON_RObject NPJSON_ResolveToSharedObject(const char *str, int length)
+{
+    NPJSON_RObject obj;
+    obj.Resolve   = _NPJSON_ResolveExevObject;
+    obj.str       = NPJSON_NULL;
+    obj.Strlength = 0;
+    obj.isSafe    = true;
+    obj.share     = NPJSON_NULL;
+    obj.alloc     = NPJSON_NULL;
+    if (str != NPJSON_NULL && length > 0) {
+        // 引用计数与数据一次分配
+        NPJSON_Buffer *b = _NPJSON_BufferCreate(NPJSON_NULL, NPJSON_NULL, length + 1);
+        if (b != NPJSON_NULL) {
+            memcpy(b->data, str, length);
+            b->data[length] = '\0';
+            obj.str         = b->data;
+            obj.Strlength   = length;
+            obj.share       = b;
+        }
+    }
+    return obj;
+}
+
+bool NPJSON_RObjectShare(NPJSON_RObject *re)
+{
+    if (re == NPJSON_NULL || !re->isSafe || re->str == NPJSON_NULL)
+        return false;
+    if (re->share != NPJSON_NULL)
+        return true;
+    re->share = _NPJSON_BufferCreate(re->alloc, (char *)re->str, 0);
+    return re->share != NPJSON_NULL;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //                                             | JSON 生成 |
 // ---------------------------------------------------------------------------------------------------------------------
 
+static bool _NPJSON_Flush(NPJSON_Synthesizer *syn)
+{
+    size_t n = syn->idx - syn->str;
+    if (n == 0)
+        return true;
+    if (!syn->sink(syn->sink_ctx, syn->str, n))
+        return false;
+    syn->idx = syn->str;
+    return true;
+}
+
 static bool _NPJSON_CheckCacheSize(NPJSON_Synthesizer *syn, int size)
 {
 #define _ALIGN(n, m) (n <= 0 ? 0 : ((n)-1) / (m) + 1)
+    if (syn->str == NPJSON_NULL || size < 0)
+        return false;
     if (syn->endidx - syn->idx > size)
         return true;
+    // 流式输出先把已有内容交出去，只有单个元素超过块大小时才扩容
+    if (syn->sink != NPJSON_NULL) {
+        if (!_NPJSON_Flush(syn))
+            return false;
+        if (syn->endidx - syn->idx > size)
+            return true;
+    }
+    // 总长度受 int 限制
+    if ((long long)(syn->endidx - syn->str) + size + 1 > 0x7FFFFFFF - 512)
+        return false;
     int len = syn->endidx - syn->str + size + 1;
     // 512 对齐
     len       = _ALIGN(len, 512) * 512;
-    char *tmp = REDIM(char, syn->str, len);
+    char *tmp = AREDIM(syn->alloc, char, syn->str, len);
+    NPJSON_STAT_ADD(synthReallocs, 1);
     if (tmp == NPJSON_NULL)
         return false;
     syn->idx    = tmp + (syn->idx - syn->str);
@@ -530,162 +1376,301 @@ static bool _NPJSON_CheckCacheSize(NPJSON_Synthesizer *syn, int size)
     return true;
 }
 
-char *_NPJSON_SetName(char *idx, char *endidx, const char *name)
+// 写入大块数据，流式输出时按块分段，不会扩容
+static bool _NPJSON_Write(NPJSON_Synthesizer *syn, const char *data, int size)
+{
+    while (syn->sink != NPJSON_NULL && syn->endidx - syn->idx <= size) {
+        int n = syn->endidx - syn->idx - 1;
+        memcpy(syn->idx, data, n);
+        syn->idx += n;
+        data += n;
+        size -= n;
+        if (!_NPJSON_Flush(syn))
+            return false;
+    }
+    if (!_NPJSON_CheckCacheSize(syn, size))
+        return false;
+    memcpy(syn->idx, data, size);
+    syn->idx += size;
+    return true;
+}
+
+static void _NPJSON_SetComma(NPJSON_Synthesizer *syn)
+{
+    if (syn->comma)
+        *syn->idx++ = ',';
+    syn->comma = true;
+}
+
+// 对象名称 raw：已包含引号和冒号的 "name":
+typedef struct
+{
+    const char *str;   // null：数组元素，没有名称
+    int         len;
+    int         esc;   // 转义后长度
+    bool        raw;
+} _NPJSON_Key;
+
+static _NPJSON_Key _NPJSON_NameKey(const char *name)
+{
+    _NPJSON_Key k;
+    k.str = name;
+    k.len = name == NPJSON_NULL ? 0 : strlen(name);
+    k.esc = _NPJSON_EscapeLength(name, k.len);
+    k.raw = false;
+    return k;
+}
+
+static _NPJSON_Key _NPJSON_RawKey(const char *key, int key_len)
+{
+    _NPJSON_Key k;
+    k.str = key;
+    k.len = key == NPJSON_NULL ? 0 : key_len;
+    k.esc = k.len;
+    k.raw = true;
+    return k;
+}
+
+// 名称写入长度
+static int _NPJSON_KeySize(const _NPJSON_Key *k)
+{
+    if (k->str == NPJSON_NULL)
+        return 0;
+    return k->raw ? k->len : k->esc + 3;
+}
+
+static char *_NPJSON_SetName(char *idx, const _NPJSON_Key *k)
 {
+    if (k->str == NPJSON_NULL)
+        return idx;
+    if (k->raw) {
+        memcpy(idx, k->str, k->len);
+        return idx + k->len;
+    }
     *idx++ = '\"';
-    while (idx != endidx && *name != '\0')
-        *idx++ = *name++;
+    idx    = _NPJSON_EscapeCopy(idx, k->str, k->len, k->esc);
     *idx++ = '\"';
     *idx++ = ':';
     return idx;
 }
 
-static bool _NPJSON_StartObject(NPJSON_Synthesizer *re, const char *name)
+// 快速整数格式化，返回长度
+static int _NPJSON_FormatInt(char *buf, long long value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    int name_len = name == NPJSON_NULL ? 1 : strlen(name);
-    if (!_NPJSON_CheckCacheSize(re, name_len + 5))
-        return false;
-    if (name != NPJSON_NULL)
-        re->idx = _NPJSON_SetName(re->idx, re->endidx, name);
-    *re->idx++ = '{';
-    return true;
+    static const char DIGITS[] = "00010203040506070809"
+                                 "10111213141516171819"
+                                 "20212223242526272829"
+                                 "30313233343536373839"
+                                 "40414243444546474849"
+                                 "50515253545556575859"
+                                 "60616263646566676869"
+                                 "70717273747576777879"
+                                 "80818283848586878889"
+                                 "90919293949596979899";
+    char               tmp[24];
+    char *             p = tmp + sizeof(tmp);
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    while (v >= 100) {
+        unsigned idx = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--p = DIGITS[idx + 1];
+        *--p = DIGITS[idx];
+    }
+    if (v >= 10) {
+        *--p = DIGITS[v * 2 + 1];
+        *--p = DIGITS[v * 2];
+    } else
+        *--p = (char)('0' + v);
+    if (value < 0)
+        *--p = '-';
+    int len = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, len);
+    return len;
 }
 
-static bool _NPJSON_EndObject(NPJSON_Synthesizer *re)
+// 浮点格式化，NaN、Infinity 输出 null，返回长度
+static int _NPJSON_FormatNumber(char *buf, int size, double value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    if (!_NPJSON_CheckCacheSize(re, 3))
-        return false;
-    // 去除对象最后一个 ,
-    char *idx = re->idx - 1;
-    while (idx != re->str && *idx == ' ')
-        idx--;
-    if (*idx == ',')
-        re->idx = idx;
-    *re->idx++ = '}';
-    *re->idx++ = ',';
+    if ((value * 0) != 0) {
+        memcpy(buf, "null", 4);
+        return 4;
+    }
+    return CM_snprintf(buf, size, "%lg", value);
+}
+
+// 流式输出超长字符串时分段转义写入，不扩容
+static bool _NPJSON_WriteEscape(NPJSON_Synthesizer *re, const char *str, int len)
+{
+    const char *strend = str + len;
+    while (str != strend) {
+        size_t n = _NPJSON_ScanEscape(str, strend - str);
+        if (!_NPJSON_Write(re, str, n))
+            return false;
+        str += n;
+        if (str == strend)
+            break;
+        if (!_NPJSON_CheckCacheSize(re, 6))
+            return false;
+        re->idx = _NPJSON_EscapeCopy(re->idx, str, 1, _NPJSON_EscapeLength(str, 1));
+        str++;
+    }
     return true;
 }
 
-static bool _NPJSON_StartArray(NPJSON_Synthesizer *re, const char *name)
+// 写入 ,"name"{ 或 ,"name"[
+static bool _NPJSON_KeyStart(NPJSON_Synthesizer *re, const _NPJSON_Key *k, char ch)
 {
     if (re == NPJSON_NULL)
         return false;
-    int name_len = name == NPJSON_NULL ? 1 : strlen(name);
-    if (!_NPJSON_CheckCacheSize(re, name_len + 5))
+    if (!_NPJSON_CheckCacheSize(re, _NPJSON_KeySize(k) + 2))
         return false;
-    if (name != NPJSON_NULL)
-        re->idx = _NPJSON_SetName(re->idx, re->endidx, name);
-    *re->idx++ = '[';
+    _NPJSON_SetComma(re);
+    re->idx    = _NPJSON_SetName(re->idx, k);
+    *re->idx++ = ch;
+    re->comma  = false;
     return true;
 }
 
-static bool _NPJSON_EndArray(NPJSON_Synthesizer *re)
+// 写入 ,"name":value 值为已格式化的文本
+static bool _NPJSON_KeyText(NPJSON_Synthesizer *re, const _NPJSON_Key *k, const char *value, int value_len)
 {
     if (re == NPJSON_NULL)
         return false;
-    if (!_NPJSON_CheckCacheSize(re, 3))
+    if (!_NPJSON_CheckCacheSize(re, _NPJSON_KeySize(k) + value_len + 1))
         return false;
-    // 去除对象最后一个 ,
-    char *idx = re->idx - 1;
-    while (idx != re->str && *idx == ' ')
-        idx--;
-    if (*idx == ',')
-        re->idx = idx;
-    *re->idx++ = ']';
-    *re->idx++ = ',';
+    _NPJSON_SetComma(re);
+    re->idx = _NPJSON_SetName(re->idx, k);
+    memcpy(re->idx, value, value_len);
+    re->idx += value_len;
     return true;
 }
 
-static bool _NPJSON_AddInt(NPJSON_Synthesizer *re, const char *name, long long value)
+static bool _NPJSON_KeyInt(NPJSON_Synthesizer *re, const _NPJSON_Key *k, long long value)
 {
-    if (re == NPJSON_NULL || name == NPJSON_NULL)
-        return false;
-    int  name_len = strlen(name);
     char tmp[32];
-    int  len = CM_snprintf(tmp, sizeof(tmp), "%lld", value);
-    if (!_NPJSON_CheckCacheSize(re, name_len + len + 5))
-        return false;
-    re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":%s,", name, tmp);
-    return true;
+    return _NPJSON_KeyText(re, k, tmp, _NPJSON_FormatInt(tmp, value));
 }
 
-static bool _NPJSON_AddNumber(NPJSON_Synthesizer *re, const char *name, double value)
+static bool _NPJSON_KeyNumber(NPJSON_Synthesizer *re, const _NPJSON_Key *k, double value)
 {
-    if (re == NPJSON_NULL || name == NPJSON_NULL)
-        return false;
-    int  name_len = strlen(name);
     char tmp[32];
-    bool isval = (value * 0) == 0;
-    int  len   = isval ? snprintf(tmp, sizeof(tmp), "%lg", value) : 4;
-    if (!_NPJSON_CheckCacheSize(re, name_len + len + 5))
-        return false;
-    if (!isval)   // 检查NaN和Infinity
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":null,", name);
-    else
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":%lg,", name, value);
-    return true;
+    return _NPJSON_KeyText(re, k, tmp, _NPJSON_FormatNumber(tmp, sizeof(tmp), value));
 }
 
-static bool _NPJSON_AddString(NPJSON_Synthesizer *re, const char *name, const char *value)
+static bool _NPJSON_KeyBool(NPJSON_Synthesizer *re, const _NPJSON_Key *k, bool value)
 {
-    if (re == NPJSON_NULL || name == NPJSON_NULL)
-        return false;
-    int name_len  = strlen(name);
-    int value_len = value == NPJSON_NULL ? 4 : strlen(value);
-    if (!_NPJSON_CheckCacheSize(re, name_len + value_len + 6))
+    return value ? _NPJSON_KeyText(re, k, "true", 4) : _NPJSON_KeyText(re, k, "false", 5);
+}
+
+static bool _NPJSON_KeyString(NPJSON_Synthesizer *re, const _NPJSON_Key *k, const char *value)
+{
+    if (re == NPJSON_NULL)
         return false;
     if (value == NPJSON_NULL)
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":null,", name);
-    else
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":\"%s\",", name, value);
+        return _NPJSON_KeyText(re, k, "null", 4);
+    int key_len   = _NPJSON_KeySize(k);
+    int value_len = strlen(value);
+    int value_esc = _NPJSON_EscapeLength(value, value_len);
+    int size      = key_len + value_esc + 3;
+    if (re->sink != NPJSON_NULL && size >= re->endidx - re->str) {
+        // 流式输出超长字符串
+        if (!_NPJSON_CheckCacheSize(re, key_len + 2))
+            return false;
+        _NPJSON_SetComma(re);
+        re->idx    = _NPJSON_SetName(re->idx, k);
+        *re->idx++ = '\"';
+        if (!_NPJSON_WriteEscape(re, value, value_len) || !_NPJSON_CheckCacheSize(re, 1))
+            return false;
+        *re->idx++ = '\"';
+        return true;
+    }
+    if (!_NPJSON_CheckCacheSize(re, size))
+        return false;
+    _NPJSON_SetComma(re);
+    re->idx    = _NPJSON_SetName(re->idx, k);
+    *re->idx++ = '\"';
+    re->idx    = _NPJSON_EscapeCopy(re->idx, value, value_len, value_esc);
+    *re->idx++ = '\"';
     return true;
 }
 
-static bool _NPJSON_AddBool(NPJSON_Synthesizer *re, const char *name, bool value)
+static bool _NPJSON_KeyObject(NPJSON_Synthesizer *re, const _NPJSON_Key *k, const char *str, int Strlength)
+{
+    if (Strlength <= 0 || str == NPJSON_NULL)
+        return _NPJSON_KeyText(re, k, "null", 4);
+    if (!_NPJSON_KeyText(re, k, "", 0))
+        return false;
+    return _NPJSON_Write(re, str, Strlength);
+}
+
+static bool _NPJSON_StartObject(NPJSON_Synthesizer *re, const char *name)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyStart(re, &k, '{');
+}
+
+static bool _NPJSON_EndObject(NPJSON_Synthesizer *re)
 {
-    if (re == NPJSON_NULL || name == NPJSON_NULL)
+    if (re == NPJSON_NULL)
         return false;
-    int         name_len   = strlen(name);
-    const char *STR_BOOL[] = {"false", "true"};
-    if (!_NPJSON_CheckCacheSize(re, name_len + strlen(STR_BOOL[value]) + 4))
+    if (!_NPJSON_CheckCacheSize(re, 2))
         return false;
-    re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":%s,", name, STR_BOOL[value]);
+    *re->idx++ = '}';
+    re->comma  = true;
     return true;
 }
 
-static bool _NPJSON_AddObject(NPJSON_Synthesizer *re, const char *name, const char *str, int Strlength)
+static bool _NPJSON_StartArray(NPJSON_Synthesizer *re, const char *name)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyStart(re, &k, '[');
+}
+
+static bool _NPJSON_EndArray(NPJSON_Synthesizer *re)
 {
-    if (re == NPJSON_NULL || name == NPJSON_NULL)
+    if (re == NPJSON_NULL)
         return false;
-    if (Strlength <= 0)
-        str = NPJSON_NULL;
-    int name_len  = strlen(name);
-    int value_len = str == NPJSON_NULL ? 4 : Strlength;
-    if (!_NPJSON_CheckCacheSize(re, name_len + value_len + 4))   //"":,
+    if (!_NPJSON_CheckCacheSize(re, 2))
         return false;
-    if (str == NPJSON_NULL)
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\":null,", name);
-    else {
-        re->idx = _NPJSON_SetName(re->idx, re->endidx, name);
-        memcpy(re->idx, str, Strlength);
-        re->idx += Strlength;
-        *re->idx++ = ',';
-    }
+    *re->idx++ = ']';
+    re->comma  = true;
     return true;
 }
 
+static bool _NPJSON_AddInt(NPJSON_Synthesizer *re, const char *name, long long value)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyInt(re, &k, value);
+}
+
+static bool _NPJSON_AddNumber(NPJSON_Synthesizer *re, const char *name, double value)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyNumber(re, &k, value);
+}
+
+static bool _NPJSON_AddString(NPJSON_Synthesizer *re, const char *name, const char *value)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyString(re, &k, value);
+}
+
+static bool _NPJSON_AddBool(NPJSON_Synthesizer *re, const char *name, bool value)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyBool(re, &k, value);
+}
+
 static bool _NPJSON_AddSObject(NPJSON_Synthesizer *re, const char *name, const NPJSON_SObject *obj)
 {
-    return _NPJSON_AddObject(re, name, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyObject(re, &k, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
 }
 
 static bool _NPJSON_AddRObject(NPJSON_Synthesizer *re, const char *name, const NPJSON_RObject *obj)
 {
-    return _NPJSON_AddObject(re, name, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return name != NPJSON_NULL && _NPJSON_KeyObject(re, &k, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
 }
 
 const _NPJSON_Synthesizer_AddEvent _AddEvent = {
@@ -696,88 +1681,36 @@ const _NPJSON_Synthesizer_AddEvent _AddEvent = {
     _NPJSON_AddSObject,
     _NPJSON_AddRObject};
 
+static const _NPJSON_Key _NoKey = {NPJSON_NULL, 0, 0, false};
+
 static bool _NPJSON_AddItemInt(NPJSON_Synthesizer *re, long long value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    char tmp[32];
-    int  len = CM_snprintf(tmp, sizeof(tmp), "%lld", value);
-    if (!_NPJSON_CheckCacheSize(re, len + 1))
-        return false;
-    re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "%s,", tmp);
-    return true;
+    return _NPJSON_KeyInt(re, &_NoKey, value);
 }
 
 static bool _NPJSON_AddItemNumber(NPJSON_Synthesizer *re, double value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    char tmp[32];
-    bool isval = (value * 0) == 0;
-    int  len   = isval ? snprintf(tmp, sizeof(tmp), "%lg", value) : 4;
-    if (!_NPJSON_CheckCacheSize(re, len + 6))
-        return false;
-    if (!isval)   // 检查NaN和Infinity
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "null,");
-    else
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "%lg,", value);
-    return true;
+    return _NPJSON_KeyNumber(re, &_NoKey, value);
 }
 
 static bool _NPJSON_AddItemString(NPJSON_Synthesizer *re, const char *value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    int value_len = value == NPJSON_NULL ? 5 : strlen(value);
-    if (!_NPJSON_CheckCacheSize(re, value_len + 3))
-        return false;
-    if (value == NPJSON_NULL)
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "null,");
-    else {
-        int len = CM_snprintf(re->idx, re->endidx - re->idx, "\"%s\",", value);
-        re->idx += len;
-    }
-    return true;
+    return _NPJSON_KeyString(re, &_NoKey, value);
 }
 
 static bool _NPJSON_AddItemBool(NPJSON_Synthesizer *re, bool value)
 {
-    if (re == NPJSON_NULL)
-        return false;
-    const char *STR_BOOL[] = {"false", "true"};
-    if (!_NPJSON_CheckCacheSize(re, strlen(STR_BOOL[value]) + 1))
-        return false;
-    re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "%s,", STR_BOOL[value]);
-    return true;
-}
-
-static bool _NPJSON_AddItemObject(NPJSON_Synthesizer *re, const char *str, int Strlength)
-{
-    if (re == NPJSON_NULL)
-        return false;
-    if (Strlength <= 0)
-        str = NPJSON_NULL;
-    int value_len = str == NPJSON_NULL ? 4 : Strlength;
-    if (!_NPJSON_CheckCacheSize(re, value_len + 2))   //,
-        return false;
-    if (str == NPJSON_NULL)
-        re->idx += CM_snprintf(re->idx, re->endidx - re->idx, "null,");
-    else {
-        memcpy(re->idx, str, Strlength);
-        re->idx += Strlength;
-        *re->idx++ = ',';
-    }
-    return true;
+    return _NPJSON_KeyBool(re, &_NoKey, value);
 }
 
 static bool _NPJSON_AddItemSObject(NPJSON_Synthesizer *re, const NPJSON_SObject *obj)
 {
-    return _NPJSON_AddItemObject(re, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+    return _NPJSON_KeyObject(re, &_NoKey, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
 }
 
 static bool _NPJSON_AddItemRObject(NPJSON_Synthesizer *re, const NPJSON_RObject *obj)
 {
-    return _NPJSON_AddItemObject(re, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+    return _NPJSON_KeyObject(re, &_NoKey, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
 }
 
 const _NPJSON_Synthesizer_AddArrayEvent _AddArrayEvent = {
@@ -788,52 +1721,382 @@ const _NPJSON_Synthesizer_AddArrayEvent _AddArrayEvent = {
     _NPJSON_AddItemSObject,
     _NPJSON_AddItemRObject};
 
-NPJSON_Synthesizer NPJSON_CreateSynthesizer(int size)
+static bool _NPJSON_AddKeyInt(NPJSON_Synthesizer *re, const char *key, int key_len, long long value)
 {
-    if (size < 32)
-        size = 32;
-    NPJSON_Synthesizer syn;
-    syn.idx    = NPJSON_NULL;
-    syn.endidx = NPJSON_NULL;
-    syn.str    = NEW(char, size + 1);
-    if (syn.str != NPJSON_NULL) {
-        syn.idx    = syn.str;
-        syn.endidx = syn.str + size;
-        *syn.idx++ = '{';
-    }
-    syn.EndObject   = _NPJSON_EndObject;
-    syn.StartObject = _NPJSON_StartObject;
-    syn.StartArray  = _NPJSON_StartArray;
-    syn.EndArray    = _NPJSON_EndArray;
-
-    syn.Add          = &_AddEvent;
-    syn.AddArrayItem = &_AddArrayEvent;
-    return syn;
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyInt(re, &k, value);
 }
 
-NPJSON_Synthesizer NPJSON_SynthesizerClone(const NPJSON_Synthesizer *sn)
+static bool _NPJSON_AddKeyNumber(NPJSON_Synthesizer *re, const char *key, int key_len, double value)
 {
-    if (sn == NPJSON_NULL || sn->str == NPJSON_NULL)
-        return NPJSON_CreateSynthesizer(0);
-    NPJSON_Synthesizer re = *sn;
-    re.idx = re.endidx = NPJSON_NULL;
-    int len            = sn->endidx - sn->str;
-    re.str             = NEW(char, len + 1);
-    if (re.str != NPJSON_NULL) {
-        memcpy(re.str, sn->str, len);
-        re.idx    = re.str + (sn->idx - sn->str);
-        re.endidx = re.str + len;
-    }
-    return re;
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyNumber(re, &k, value);
 }
 
-void NPJSON_DeleteSynthesizer(NPJSON_Synthesizer *re)
+static bool _NPJSON_AddKeyString(NPJSON_Synthesizer *re, const char *key, int key_len, const char *value)
 {
-    if (re == NPJSON_NULL || re->str == NPJSON_NULL)
-        return;
-    DELETE(re->str);
-    re->str = re->idx = re->endidx = NPJSON_NULL;
-    return;
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyString(re, &k, value);
+}
+
+static bool _NPJSON_AddKeyBool(NPJSON_Synthesizer *re, const char *key, int key_len, bool value)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyBool(re, &k, value);
+}
+
+static bool _NPJSON_AddKeySObject(NPJSON_Synthesizer *re, const char *key, int key_len, const NPJSON_SObject *obj)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyObject(re, &k, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+}
+
+static bool _NPJSON_AddKeyRObject(NPJSON_Synthesizer *re, const char *key, int key_len, const NPJSON_RObject *obj)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyObject(re, &k, obj == NPJSON_NULL ? NPJSON_NULL : obj->str, obj == NPJSON_NULL ? 0 : obj->Strlength);
+}
+
+static bool _NPJSON_AddKeyStartObject(NPJSON_Synthesizer *re, const char *key, int key_len)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyStart(re, &k, '{');
+}
+
+static bool _NPJSON_AddKeyStartArray(NPJSON_Synthesizer *re, const char *key, int key_len)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyStart(re, &k, '[');
+}
+
+// 批量数组元素类型
+enum
+{
+    _NPJSON_LIST_INT32,
+    _NPJSON_LIST_INT64,
+    _NPJSON_LIST_FLOAT,
+    _NPJSON_LIST_DOUBLE,
+    _NPJSON_LIST_BOOL,
+};
+
+// 写入 ,"name":[ ... ] 按元素最大长度预留空间，流式输出时按块分段
+static bool _NPJSON_KeyList(NPJSON_Synthesizer *re, const _NPJSON_Key *k, int type, const void *value, int count)
+{
+    // 单个元素最大长度（含 ,）
+    const int SIZE[] = {12, 21, 16, 16, 6};
+    // 每次预留上限，超长数组分段预留，避免 n * per 溢出
+    const int BLOCK = 1 << 24;
+    if (re == NPJSON_NULL || (value == NPJSON_NULL && count > 0))
+        return false;
+    if (!_NPJSON_KeyStart(re, k, '['))
+        return false;
+    int per = SIZE[type];
+    int i   = 0;
+    while (i < count) {
+        int n = count - i;
+        if (re->sink != NPJSON_NULL && (long long)n * per >= re->endidx - re->str)
+            n = (int)((re->endidx - re->str - 1) / per);
+        if ((long long)n * per > BLOCK)
+            n = BLOCK / per;
+        if (n <= 0)
+            n = 1;
+        if (!_NPJSON_CheckCacheSize(re, n * per))
+            return false;
+        char *idx = re->idx;
+        int   end = i + n;
+        switch (type) {
+            case _NPJSON_LIST_INT32:
+                for (; i < end; i++) {
+                    *idx = ',';
+                    idx += i != 0;
+                    idx += _NPJSON_FormatInt(idx, ((const int32_t *)value)[i]);
+                }
+                break;
+            case _NPJSON_LIST_INT64:
+                for (; i < end; i++) {
+                    *idx = ',';
+                    idx += i != 0;
+                    idx += _NPJSON_FormatInt(idx, ((const int64_t *)value)[i]);
+                }
+                break;
+            case _NPJSON_LIST_FLOAT:
+                for (; i < end; i++) {
+                    *idx = ',';
+                    idx += i != 0;
+                    idx += _NPJSON_FormatNumber(idx, re->endidx - idx, ((const float *)value)[i]);
+                }
+                break;
+            case _NPJSON_LIST_DOUBLE:
+                for (; i < end; i++) {
+                    *idx = ',';
+                    idx += i != 0;
+                    idx += _NPJSON_FormatNumber(idx, re->endidx - idx, ((const double *)value)[i]);
+                }
+                break;
+            default:
+                for (; i < end; i++) {
+                    *idx = ',';
+                    idx += i != 0;
+                    if (((const bool *)value)[i]) {
+                        memcpy(idx, "true", 4);
+                        idx += 4;
+                    } else {
+                        memcpy(idx, "false", 5);
+                        idx += 5;
+                    }
+                }
+                break;
+        }
+        re->idx = idx;
+    }
+    re->comma = count > 0;
+    return _NPJSON_EndArray(re);
+}
+
+static bool _NPJSON_AddListInt32(NPJSON_Synthesizer *re, const char *name, const int32_t *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_INT32, value, count);
+}
+
+static bool _NPJSON_AddListInt64(NPJSON_Synthesizer *re, const char *name, const int64_t *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_INT64, value, count);
+}
+
+static bool _NPJSON_AddListFloat(NPJSON_Synthesizer *re, const char *name, const float *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_FLOAT, value, count);
+}
+
+static bool _NPJSON_AddListDouble(NPJSON_Synthesizer *re, const char *name, const double *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_DOUBLE, value, count);
+}
+
+static bool _NPJSON_AddListBool(NPJSON_Synthesizer *re, const char *name, const bool *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_BOOL, value, count);
+}
+
+static bool _NPJSON_KeyListString(NPJSON_Synthesizer *re, const _NPJSON_Key *k, const char *const *value, int count)
+{
+    // 每段元素数量 长度、转义后长度每个元素只计算一次
+    enum { CHUNK = 256 };
+    // 每次预留上限，与 _NPJSON_KeyList 相同
+    const int BLOCK = 1 << 24;
+    int       len[CHUNK];   // 原长度 -1：null
+    int       esc[CHUNK];   // 输出宽度（含引号 不含 ,）
+    if (re == NPJSON_NULL || (value == NPJSON_NULL && count > 0))
+        return false;
+    if (!_NPJSON_KeyStart(re, k, '['))
+        return false;
+    for (int i = 0; i < count;) {
+        int n = count - i < CHUNK ? count - i : CHUNK;
+        for (int j = 0; j < n; j++) {
+            const char *v = value[i + j];
+            if (v == NPJSON_NULL) {
+                len[j] = -1;
+                esc[j] = 4;
+            } else {
+                len[j] = strlen(v);
+                esc[j] = _NPJSON_EscapeLength(v, len[j]) + 2;
+            }
+        }
+        for (int j = 0; j < n;) {
+            // 一次预留尽可能多的元素 流式输出不超过缓存块
+            long long room = re->sink != NPJSON_NULL ? re->endidx - re->str - 1 : BLOCK;
+            long long size = esc[j] + 1;
+            int       m    = j + 1;
+            while (m < n && size + esc[m] + 1 <= room)
+                size += esc[m++] + 1;
+            if (re->sink != NPJSON_NULL && len[j] >= 0 && size > room) {
+                // 流式输出超长字符串
+                if (!_NPJSON_CheckCacheSize(re, 2))
+                    return false;
+                *re->idx = ',';
+                re->idx += i + j != 0;
+                *re->idx++ = '\"';
+                if (!_NPJSON_WriteEscape(re, value[i + j], len[j]) || !_NPJSON_CheckCacheSize(re, 1))
+                    return false;
+                *re->idx++ = '\"';
+                j++;
+                continue;
+            }
+            if (size > 0x7FFFFFFF || !_NPJSON_CheckCacheSize(re, (int)size))
+                return false;
+            char *idx = re->idx;
+            for (; j < m; j++) {
+                *idx = ',';
+                idx += i + j != 0;
+                if (len[j] < 0) {
+                    memcpy(idx, "null", 4);
+                    idx += 4;
+                    continue;
+                }
+                *idx++ = '\"';
+                idx    = _NPJSON_EscapeCopy(idx, value[i + j], len[j], esc[j] - 2);
+                *idx++ = '\"';
+            }
+            re->idx = idx;
+        }
+        i += n;
+    }
+    re->comma = count > 0;
+    return _NPJSON_EndArray(re);
+}
+
+static bool _NPJSON_AddListString(NPJSON_Synthesizer *re, const char *name, const char *const *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    return _NPJSON_KeyListString(re, &k, value, count);
+}
+
+static bool _NPJSON_AddKeyListInt32(NPJSON_Synthesizer *re, const char *key, int key_len, const int32_t *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_INT32, value, count);
+}
+
+static bool _NPJSON_AddKeyListInt64(NPJSON_Synthesizer *re, const char *key, int key_len, const int64_t *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_INT64, value, count);
+}
+
+static bool _NPJSON_AddKeyListFloat(NPJSON_Synthesizer *re, const char *key, int key_len, const float *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_FLOAT, value, count);
+}
+
+static bool _NPJSON_AddKeyListDouble(NPJSON_Synthesizer *re, const char *key, int key_len, const double *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_DOUBLE, value, count);
+}
+
+static bool _NPJSON_AddKeyListBool(NPJSON_Synthesizer *re, const char *key, int key_len, const bool *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyList(re, &k, _NPJSON_LIST_BOOL, value, count);
+}
+
+static bool _NPJSON_AddKeyListString(NPJSON_Synthesizer *re, const char *key, int key_len, const char *const *value, int count)
+{
+    _NPJSON_Key k = _NPJSON_RawKey(key, key_len);
+    return _NPJSON_KeyListString(re, &k, value, count);
+}
+
+const _NPJSON_Synthesizer_AddKeyEvent _AddKeyEvent = {
+    _NPJSON_AddKeyInt,
+    _NPJSON_AddKeyNumber,
+    _NPJSON_AddKeyString,
+    _NPJSON_AddKeyBool,
+    _NPJSON_AddKeySObject,
+    _NPJSON_AddKeyRObject,
+    _NPJSON_AddKeyStartObject,
+    _NPJSON_AddKeyStartArray,
+    _NPJSON_AddKeyListInt32,
+    _NPJSON_AddKeyListInt64,
+    _NPJSON_AddKeyListFloat,
+    _NPJSON_AddKeyListDouble,
+    _NPJSON_AddKeyListBool,
+    _NPJSON_AddKeyListString};
+
+const _NPJSON_Synthesizer_AddListEvent _AddListEvent = {
+    _NPJSON_AddListInt32,
+    _NPJSON_AddListInt64,
+    _NPJSON_AddListFloat,
+    _NPJSON_AddListDouble,
+    _NPJSON_AddListBool,
+    _NPJSON_AddListString};
+
+NPJSON_Synthesizer NPJSON_CreateSynthesizerEx(int size, const NPJSON_Allocator *alloc)
+{
+    if (size < 32)
+        size = 32;
+    NPJSON_Synthesizer syn;
+    syn.idx      = NPJSON_NULL;
+    syn.endidx   = NPJSON_NULL;
+    syn.comma    = false;
+    syn.sink     = NPJSON_NULL;
+    syn.sink_ctx = NPJSON_NULL;
+    syn.alloc    = alloc;
+    syn.str      = ANEW(alloc, char, size + 1);
+    if (syn.str != NPJSON_NULL) {
+        syn.idx    = syn.str;
+        syn.endidx = syn.str + size;
+        *syn.idx++ = '{';
+    }
+    syn.EndObject   = _NPJSON_EndObject;
+    syn.StartObject = _NPJSON_StartObject;
+    syn.StartArray  = _NPJSON_StartArray;
+    syn.EndArray    = _NPJSON_EndArray;
+
+    syn.Add          = &_AddEvent;
+    syn.AddArrayItem = &_AddArrayEvent;
+    syn.AddKey       = &_AddKeyEvent;
+    syn.AddList      = &_AddListEvent;
+    return syn;
+}
+
+NPJSON_Synthesizer NPJSON_CreateSynthesizer(int size)
+{
+    return NPJSON_CreateSynthesizerEx(size, NPJSON_NULL);
+}
+
+NPJSON_Synthesizer NPJSON_CreateStreamSynthesizer(int size, NPJSON_SinkFunc sink, void *ctx)
+{
+    NPJSON_Synthesizer syn = NPJSON_CreateSynthesizer(size);
+    if (sink == NPJSON_NULL)
+        NPJSON_DeleteSynthesizer(&syn);
+    syn.sink     = sink;
+    syn.sink_ctx = ctx;
+    return syn;
+}
+
+bool NPJSON_StreamSynthesizerEnd(NPJSON_Synthesizer *re)
+{
+    if (re == NPJSON_NULL || re->sink == NPJSON_NULL)
+        return false;
+    bool flag = _NPJSON_CheckCacheSize(re, 1);
+    if (flag) {
+        *re->idx++ = '}';
+        flag       = _NPJSON_Flush(re);
+    }
+    NPJSON_DeleteSynthesizer(re);
+    return flag;
+}
+
+NPJSON_Synthesizer NPJSON_SynthesizerClone(const NPJSON_Synthesizer *sn)
+{
+    // 流式合成器已输出的内容无法复制
+    if (sn == NPJSON_NULL || sn->str == NPJSON_NULL || sn->sink != NPJSON_NULL)
+        return NPJSON_CreateSynthesizerEx(0, sn != NPJSON_NULL ? sn->alloc : NPJSON_NULL);
+    NPJSON_Synthesizer re = *sn;
+    re.idx = re.endidx = NPJSON_NULL;
+    int len            = sn->endidx - sn->str;
+    re.str             = ANEW(sn->alloc, char, len + 1);
+    if (re.str != NPJSON_NULL) {
+        memcpy(re.str, sn->str, len);
+        re.idx    = re.str + (sn->idx - sn->str);
+        re.endidx = re.str + len;
+    }
+    return re;
+}
+
+void NPJSON_DeleteSynthesizer(NPJSON_Synthesizer *re)
+{
+    if (re == NPJSON_NULL || re->str == NPJSON_NULL)
+        return;
+    ADELETE(re->alloc, re->str);
+    re->str = re->idx = re->endidx = NPJSON_NULL;
+    return;
 }
 
 NPJSON_SObject NPJSON_CreateSObject(NPJSON_Synthesizer *re)
@@ -841,13 +2104,9 @@ NPJSON_SObject NPJSON_CreateSObject(NPJSON_Synthesizer *re)
     NPJSON_SObject sobj;
     sobj.str       = NPJSON_NULL;
     sobj.Strlength = 0;
-    if (re != NPJSON_NULL && re->str != NPJSON_NULL && _NPJSON_CheckCacheSize(re, 2)) {
-        // 去除对象最后一个 ,
-        char *idx = re->idx - 1;
-        while (idx != re->str && *idx == ' ')
-            idx--;
-        if (*idx == ',')
-            re->idx = idx;
+    sobj.share     = NPJSON_NULL;
+    sobj.alloc     = re != NPJSON_NULL ? re->alloc : NPJSON_NULL;
+    if (re != NPJSON_NULL && re->sink == NPJSON_NULL && re->str != NPJSON_NULL && _NPJSON_CheckCacheSize(re, 2)) {
         *re->idx++     = '}';
         *re->idx       = '\0';
         sobj.str       = re->str;
@@ -862,12 +2121,26 @@ void NPJSON_DeleteSObject(NPJSON_SObject *re)
 {
     if (re == NPJSON_NULL || re->str == NPJSON_NULL)
         return;
-    DELETE(re->str);
+    if (re->share != NPJSON_NULL)
+        _NPJSON_BufferRelease(re->share);
+    else
+        ADELETE(re->alloc, re->str);
     re->Strlength = 0;
     re->str       = NPJSON_NULL;
+    re->share     = NPJSON_NULL;
     return;
 }
 
+bool NPJSON_SObjectShare(NPJSON_SObject *re)
+{
+    if (re == NPJSON_NULL || re->str == NPJSON_NULL)
+        return false;
+    if (re->share != NPJSON_NULL)
+        return true;
+    re->share = _NPJSON_BufferCreate(re->alloc, re->str, 0);
+    return re->share != NPJSON_NULL;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 //                                             | 对象转换 |
 // ---------------------------------------------------------------------------------------------------------------------
@@ -875,13 +2148,20 @@ void NPJSON_DeleteSObject(NPJSON_SObject *re)
 NPJSON_RObject NPJSON_SObjectToSafeRObject(NPJSON_SObject *re)
 {
     NPJSON_RObject r;
-    r.isSafe  = true;
-    r.Resolve = _NPJSON_ResolveExevObject;
+    r.isSafe    = true;
+    r.Resolve   = _NPJSON_ResolveExevObject;
+    r.str       = NPJSON_NULL;
+    r.Strlength = 0;
+    r.share     = NPJSON_NULL;
+    r.alloc     = NPJSON_NULL;
     if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0) {
         r.str         = re->str;
         r.Strlength   = re->Strlength;
+        r.share       = re->share;
+        r.alloc       = re->alloc;
         re->str       = NPJSON_NULL;
         re->Strlength = 0;
+        re->share     = NPJSON_NULL;
     }
     return r;
 }
@@ -891,11 +2171,16 @@ NPJSON_SObject NPJSON_SafeRObjectToSObject(NPJSON_RObject *re)
     NPJSON_SObject s;
     s.str       = NPJSON_NULL;
     s.Strlength = 0;
+    s.share     = NPJSON_NULL;
+    s.alloc     = NPJSON_NULL;
     if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->isSafe && re->Strlength > 0) {
         s.str         = (char *)re->str;   // 安全对象，可以强制转换
         s.Strlength   = re->Strlength;
+        s.share       = re->share;
+        s.alloc       = re->alloc;
         re->str       = NPJSON_NULL;
         re->Strlength = 0;
+        re->share     = NPJSON_NULL;
     }
     return s;
 }
@@ -903,10 +2188,19 @@ NPJSON_SObject NPJSON_SafeRObjectToSObject(NPJSON_RObject *re)
 NPJSON_RObject NPJSON_SafeRObjectClone(const NPJSON_RObject *re)
 {
     NPJSON_RObject r;
-    r.isSafe  = true;
-    r.Resolve = _NPJSON_ResolveExevObject;
-    if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0) {
-        char *tmp = NEW(char, re->Strlength);
+    r.isSafe    = true;
+    r.Resolve   = _NPJSON_ResolveExevObject;
+    r.str       = NPJSON_NULL;
+    r.Strlength = 0;
+    r.share     = NPJSON_NULL;
+    r.alloc     = re != NPJSON_NULL ? re->alloc : NPJSON_NULL;
+    if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0 && re->share != NPJSON_NULL) {
+        // 共享模式 只增加引用计数
+        r.str       = re->str;
+        r.Strlength = re->Strlength;
+        r.share     = _NPJSON_BufferRetain(re->share);
+    } else if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0) {
+        char *tmp = ANEW(r.alloc, char, re->Strlength);
         if (tmp != NPJSON_NULL) {
             memcpy(tmp, re->str, re->Strlength);
             r.str       = tmp;
@@ -921,8 +2215,15 @@ NPJSON_SObject NPJSON_SObjectClone(const NPJSON_SObject *re)
     NPJSON_SObject s;
     s.str       = NPJSON_NULL;
     s.Strlength = 0;
-    if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0) {
-        char *tmp = NEW(char, re->Strlength);
+    s.share     = NPJSON_NULL;
+    s.alloc     = re != NPJSON_NULL ? re->alloc : NPJSON_NULL;
+    if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0 && re->share != NPJSON_NULL) {
+        // 共享模式 只增加引用计数
+        s.str       = re->str;
+        s.Strlength = re->Strlength;
+        s.share     = _NPJSON_BufferRetain(re->share);
+    } else if (re != NPJSON_NULL && re->str != NPJSON_NULL && re->Strlength > 0) {
+        char *tmp = ANEW(s.alloc, char, re->Strlength);
         if (tmp != NPJSON_NULL) {
             memcpy(tmp, re->str, re->Strlength);
             s.str       = tmp;
@@ -932,139 +2233,3383 @@ NPJSON_SObject NPJSON_SObjectClone(const NPJSON_SObject *re)
     return s;
 }
 
-static void NPJSON_Builder_fix(NPJSONNode *n)
-{
-    if (n == NPJSON_NULL || (n->isObject == 0 && n->isArray == 0))
-        return;
-    // 再次尾插
-    NPJSONNode *t = n->Val.Object;
-    NPJSONNode *p = NPJSON_NULL;
-    while (t != NPJSON_NULL) {
-        NPJSONNode *r = t;
-        t             = t->next;
-        r->next       = p;
-        p             = r;
-    }
-    n->Val.Object = p;
-    return;
-}
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 文本修改 |
+// ---------------------------------------------------------------------------------------------------------------------
 
-static bool NPJSON_Builder_func(const char *name, NPJSON_Result *re, int index, void *obj)
+// 成员名是否等于路径段 名称包含转义时先解码
+static bool _NPJSON_KeyEqual(const char *key, int key_len, bool esc, const char *seg, int seg_len)
 {
-    NPJSONNode **n = (NPJSONNode **)obj;
-    if ((*n)->isObject == 0 && (*n)->isArray == 0)
-        return false;
-    NPJSONNode *tmp = NEW(NPJSONNode, 1);
-    if (tmp == NPJSON_NULL)
-        return false;
-    memset(tmp, 0, sizeof(NPJSONNode));
-    if (name != NPJSON_NULL && *name != '\0') {
-        int name_len = strlen(name);
-        tmp->name    = NEW(char, name_len + 1);
-        if (tmp->name == NPJSON_NULL) {
-            DELETE(tmp);
+    char buf[256];
+    if (esc) {
+        if (key_len > (int)sizeof(buf))
             return false;
-        }
-        memcpy(tmp->name, name, name_len + 1);
-    }
-
-    // 尾插法
-    tmp->next        = (*n)->Val.Object;
-    (*n)->Val.Object = tmp;
-    (*n)->Val.ChildCount++;
-
-    // 设置值
-    tmp->level      = re->level;
-    tmp->ArrIdx     = index;
-    tmp->isBinValue = re->isBinValue;
-    tmp->isNull     = re->isNull;
-    tmp->isNumber   = re->isNumber;
-    tmp->isObject   = re->isObject;
-    tmp->isString   = re->isString;
-    tmp->isArray    = re->isArray;
-    tmp->isInteger  = re->isInteger;
-    if (re->isBinValue)
-        tmp->Val.BinValue = re->Val.BinValue;
-    else if (re->isInteger || re->isNumber) {
-        tmp->Val.Number = re->Val.Number;
-        tmp->Val.Value  = re->Val.Value;
-    } else if (tmp->isString) {
-        char *str = NEW(char, (re->Val.String.length + 1));
-        if (str != NPJSON_NULL) {
-            memcpy(str, re->Val.String.ptr, re->Val.String.length);
-            str[re->Val.String.length] = '\0';
-            tmp->Val.String            = str;
-        }
-    } else if (tmp->isObject || tmp->isArray) {
-        bool rs = re->Resolve(re, &tmp, NPJSON_Builder_func);
-        NPJSON_Builder_fix(tmp);   // 顺序修正
-        return rs;
+        key_len = _NPJSON_Unescape(buf, key, key_len);
+        key     = buf;
     }
-    return true;
+    return key_len == seg_len && memcmp(key, seg, seg_len) == 0;
 }
 
-NPJSONNode *NPJSON_Builder(const char *str, size_t len, const char **err)
+// 按路径定位值 path 以 . 分隔，数组使用十进制下标，空路径为根值
+// 成功返回值开始位置，end 返回值结束位置（不含尾随空白）
+static const char *_NPJSON_PathValue(const char *str, const char *strend, const char *path, const char **end)
 {
-    if (str == NPJSON_NULL || len <= 0)
-        return NPJSON_NULL;
-    NPJSONNode *n = NEW(NPJSONNode, 1);
-    if (n == NPJSON_NULL)
+    const char *p = str;
+    SKIPBLANK;
+    while (p != strend && path != NPJSON_NULL && *path != '\0') {
+        const char *dot     = strchr(path, '.');
+        int         seg_len = dot == NPJSON_NULL ? (int)strlen(path) : (int)(dot - path);
+        const char *seg     = path;
+        path                = dot == NPJSON_NULL ? NPJSON_NULL : dot + 1;
+        if (*p == '{') {
+            // 逐个成员比较名称 不匹配的值按括号跳过
+            p++;
+            while (true) {
+                SKIPBLANK;
+                if (p == strend || *p != '\"')
+                    return NPJSON_NULL;
+                bool        esc = false;
+                const char *key = p + 1;
+                p               = _NPJSON_StringEnd(key, strend, &esc);
+                if (p == NPJSON_NULL)
+                    return NPJSON_NULL;
+                bool hit = _NPJSON_KeyEqual(key, p - key, esc, seg, seg_len);
+                p++;
+                SKIPBLANK;
+                if (p == strend || *p != ':')
+                    return NPJSON_NULL;
+                p++;
+                SKIPBLANK;
+                if (p == strend)
+                    return NPJSON_NULL;
+                if (hit)
+                    break;
+                p = _NPJSON_ValueEnd(p, strend);
+                if (p == NPJSON_NULL || *p != ',')
+                    return NPJSON_NULL;   // 未找到
+                p++;
+            }
+        } else if (*p == '[') {
+            int idx = 0;
+            for (int i = 0; i < seg_len; i++) {
+                if (seg[i] < '0' || seg[i] > '9' || idx > (INT_MAX - 9) / 10)
+                    return NPJSON_NULL;
+                idx = idx * 10 + seg[i] - '0';
+            }
+            if (seg_len == 0)
+                return NPJSON_NULL;
+            p++;
+            SKIPBLANK;
+            if (p == strend || *p == ']')
+                return NPJSON_NULL;
+            while (idx-- > 0) {
+                p = _NPJSON_ValueEnd(p, strend);
+                if (p == NPJSON_NULL || *p != ',')
+                    return NPJSON_NULL;   // 下标越界
+                p++;
+                SKIPBLANK;
+                if (p == strend)
+                    return NPJSON_NULL;
+            }
+        } else
+            return NPJSON_NULL;
+    }
+    if (p == strend)
         return NPJSON_NULL;
-    memset(n, 0, sizeof(NPJSONNode));
-    n->isObject = 1;
-    n->level    = 0;
-    bool re     = NPJSON.Parsing.Resolve(str, len, &n, NPJSON_Builder_func, err);
-    if (re) {
-        NPJSON_Builder_fix(n);   // 顺序修正
-        return n;
+    const char *e;
+    if (*p == '{' || *p == '[') {
+        e = _NPJSON_MatchBracket(p, strend);
+        if (e == NPJSON_NULL || (*e == '}') != (*p == '{'))
+            return NPJSON_NULL;
+        e++;
+    } else if (*p == '\"') {
+        e = _NPJSON_StringEnd(p + 1, strend, NPJSON_NULL);
+        if (e == NPJSON_NULL)
+            return NPJSON_NULL;
+        e++;
     } else {
-        NPJSON_Release(&n);
-        return NPJSON_NULL;
+        e = p;
+        while (e != strend && *e != ',' && *e != ']' && *e != '}' && *e != ' ' && *e != '\t' && *e != '\r' && *e != '\n')
+            e++;
+        if (e == p)
+            return NPJSON_NULL;
     }
+    *end = e;
+    return p;
 }
 
-void NPJSON_Release(NPJSONNode **n)
+// 替换 [off, off + old) 为 value 共享缓存写时复制，独占缓存只移动尾部
+// 独占缓存的容量未知（安全对象按 Strlength 分配），只在 *len 之内或新分配的缓存写结束符
+static bool _NPJSON_Splice(char **str, int *len, NPJSON_Buffer **share, const NPJSON_Allocator *alloc, size_t off, size_t old, const char *value, size_t value_len)
 {
-    if (n == NPJSON_NULL || *n == NPJSON_NULL)
-        return;
-    NPJSONNode *p = (*n);
-    while (p != NPJSON_NULL) {
-        NPJSONNode *t = p;
-        p             = p->next;
-        if (t->isString && t->Val.String != NPJSON_NULL)
-            DELETE(t->Val.String);
-        if (t->name != NPJSON_NULL)
-            DELETE(t->name);
-        if (t->isObject && t->Val.Object != NPJSON_NULL)
-            NPJSON_Release(&(t->Val.Object));
-        DELETE(t);
+    size_t tail = *len - off - old;
+    size_t n    = *len - old + value_len;
+    if (n > INT_MAX - 1)
+        return false;
+    char *d    = *str;
+    bool  term = value_len != old;   // 等长替换时原有结束符（若有）位置不变
+    if (*share != NPJSON_NULL) {
+        // 其他引用仍使用原内容 按新长度一次分配
+        d = ANEW(alloc, char, n + 1);
+        if (d == NPJSON_NULL)
+            return false;
+        memcpy(d, *str, off);
+        memcpy(d + off + value_len, *str + off + old, tail);
+        _NPJSON_BufferRelease(*share);
+        *share = NPJSON_NULL;
+        term   = true;
+    } else {
+        if (value_len > old) {
+            d = AREDIM(alloc, char, d, n + 1);
+            if (d == NPJSON_NULL)
+                return false;
+        }
+        memmove(d + off + value_len, d + off + old, tail);
     }
-    *n = NPJSON_NULL;
-    return;
+    memcpy(d + off, value, value_len);
+    if (term)
+        d[n] = '\0';
+    *str = d;
+    *len = (int)n;
+    return true;
 }
 
-NPJSONNode *NPJSON_Find(NPJSONNode *n, const char *name)
+bool NPJSON_SObjectPatch(NPJSON_SObject *re, const char *path, const char *value, int value_len)
 {
-    if (name == NPJSON_NULL || *name == '\0' || n == NPJSON_NULL || n->isObject == 0)
-        return NPJSON_NULL;
-    n = n->Val.Object;
-    while (n != NPJSON_NULL) {
-        NPJSONNode *t = n;
-        n             = n->next;
-        if (strcmp(t->name, name) == 0)
-            return t;
-    }
-    return NPJSON_NULL;
+    const char *end;
+    if (re == NPJSON_NULL || re->str == NPJSON_NULL || value == NPJSON_NULL || value_len <= 0)
+        return false;
+    const char *v = _NPJSON_PathValue(re->str, re->str + re->Strlength, path, &end);
+    if (v == NPJSON_NULL)
+        return false;
+    return _NPJSON_Splice(&re->str, &re->Strlength, &re->share, re->alloc, v - re->str, end - v, value, value_len);
 }
 
-size_t NPJSON_GetChildCount(NPJSONNode *n)
+bool NPJSON_RObjectPatch(NPJSON_RObject *re, const char *path, const char *value, int value_len)
 {
-    if (n == NPJSON_NULL)
-        return 0;
-    return n->isObject || n->isArray ? n->Val.ChildCount : 0;
-}
+    const char *end;
+    if (re == NPJSON_NULL || !re->isSafe || re->str == NPJSON_NULL || value == NPJSON_NULL || value_len <= 0)
+        return false;
+    const char *v = _NPJSON_PathValue(re->str, re->str + re->Strlength, path, &end);
+    if (v == NPJSON_NULL)
+        return false;
+    char *str = (char *)re->str;
+    if (!_NPJSON_Splice(&str, &re->Strlength, &re->share, re->alloc, v - re->str, end - v, value, value_len))
+        return false;
+    re->str = str;
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 格式化 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+#define NPJSON_STREAM_BLOCK 4096   // 流式输出块大小
+
+// 查找第一个空白（含控制字符）或 "，返回偏移，没有返回 len
+static size_t _NPJSON_ScanSpaceQuote(const char *str, size_t len)
+{
+    size_t i = 0;
+#if defined(NPJSON_SIMD_SSE2)
+    const __m128i q  = _mm_set1_epi8('\"');
+    const __m128i sp = _mm_set1_epi8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        __m128i  v    = _mm_loadu_si128((const __m128i *)(str + i));
+        __m128i  m    = _mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(_mm_max_epu8(v, sp), sp));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask != 0)
+            return i + _NPJSON_Ctz(mask);
+    }
+#elif defined(NPJSON_SIMD_NEON)
+    const uint8x16_t q  = vdupq_n_u8('\"');
+    const uint8x16_t sp = vdupq_n_u8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)str + i);
+        if (vmaxvq_u8(vorrq_u8(vceqq_u8(v, q), vcleq_u8(v, sp))) != 0)
+            break;
+    }
+#endif
+    for (; i < len; i++) {
+        if ((uint8_t)str[i] <= 0x20 || str[i] == '\"')
+            return i;
+    }
+    return len;
+}
+
+// 创建不带根对象 { 的合成器
+static NPJSON_Synthesizer _NPJSON_CreateRawSynthesizer(int size, NPJSON_SinkFunc sink, void *ctx)
+{
+    NPJSON_Synthesizer syn = sink == NPJSON_NULL ? NPJSON_CreateSynthesizer(size) : NPJSON_CreateStreamSynthesizer(size, sink, ctx);
+    syn.idx                = syn.str;
+    return syn;
+}
+
+// 换行并缩进
+static bool _NPJSON_NewLine(NPJSON_Synthesizer *syn, int indent, int lv)
+{
+    const char SPACE[] = "\n                                                               ";
+    int        n       = indent * lv;
+    if (!_NPJSON_Write(syn, SPACE, 1))
+        return false;
+    while (n > 0) {
+        int m = n < (int)sizeof(SPACE) - 2 ? n : (int)sizeof(SPACE) - 2;
+        if (!_NPJSON_Write(syn, SPACE + 1, m))
+            return false;
+        n -= m;
+    }
+    return true;
+}
+
+// 单次扫描重新格式化 indent < 0 压缩
+static bool _NPJSON_Reformat(NPJSON_Synthesizer *syn, const char *str, size_t len, int indent, const char **err)
+{
+    const char *p      = str;
+    const char *strend = str + len;
+    int         lv     = 0;
+    if (syn->str == NPJSON_NULL)
+        return false;
+    while (p != strend) {
+        if (err != NPJSON_NULL)
+            *err = p;
+        const char *s = p;
+        if (indent < 0) {
+            // 压缩：非空白内容整段复制
+            p += _NPJSON_ScanSpaceQuote(p, strend - p);
+            if (!_NPJSON_Write(syn, s, p - s))
+                return false;
+            if (p == strend)
+                break;
+            s = p;
+        }
+        char ch = *p;
+        if (ch == '\"') {
+            p = _NPJSON_StringEnd(p + 1, strend, NPJSON_NULL);
+            if (p == NPJSON_NULL)
+                return false;
+            p++;
+            if (!_NPJSON_Write(syn, s, p - s))
+                return false;
+        } else if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+            p++;
+        } else if ((uint8_t)ch < 0x20) {
+            return false;
+        } else if (ch == '{' || ch == '[') {
+            p++;
+            SKIPBLANK;
+            if (!_NPJSON_Write(syn, s, 1))
+                return false;
+            if (p != strend && (*p == '}' || *p == ']')) {
+                // 空对象
+                if (!_NPJSON_Write(syn, p++, 1))
+                    return false;
+            } else if (!_NPJSON_NewLine(syn, indent, ++lv))
+                return false;
+        } else if (ch == '}' || ch == ']') {
+            if (--lv < 0 || !_NPJSON_NewLine(syn, indent, lv) || !_NPJSON_Write(syn, p++, 1))
+                return false;
+        } else if (ch == ',') {
+            if (!_NPJSON_Write(syn, p++, 1) || !_NPJSON_NewLine(syn, indent, lv))
+                return false;
+        } else if (ch == ':') {
+            if (!_NPJSON_Write(syn, ": ", 2))
+                return false;
+            p++;
+        } else {
+            // 数值、二值量
+            while (p != strend && (uint8_t)*p > 0x20 && *p != ',' && *p != ':' && *p != '\"' &&
+                   (*p | 0x20) != '{' && (*p | 0x20) != '}')
+                p++;
+            if (!_NPJSON_Write(syn, s, p - s))
+                return false;
+        }
+    }
+    if (err != NPJSON_NULL)
+        *err = NPJSON_NULL;
+    return true;
+}
+
+static bool _NPJSON_ReformatToSObject(const char *str, size_t len, int indent, NPJSON_SObject *out, const char **err)
+{
+    if (out == NPJSON_NULL)
+        return false;
+    out->str       = NPJSON_NULL;
+    out->Strlength = 0;
+    out->share     = NPJSON_NULL;
+    out->alloc     = NPJSON_NULL;
+    if (str == NPJSON_NULL)
+        return false;
+    // 压缩结果不会超过原长度，只分配一次
+    NPJSON_Synthesizer syn = _NPJSON_CreateRawSynthesizer(indent < 0 ? len + 1 : len + len / 2, NPJSON_NULL, NPJSON_NULL);
+    if (!_NPJSON_Reformat(&syn, str, len, indent, err) || !_NPJSON_CheckCacheSize(&syn, 1)) {
+        NPJSON_DeleteSynthesizer(&syn);
+        return false;
+    }
+    *syn.idx       = '\0';
+    out->str       = syn.str;
+    out->Strlength = syn.idx - syn.str;
+    return true;
+}
+
+static bool _NPJSON_ReformatToSink(const char *str, size_t len, int indent, NPJSON_SinkFunc sink, void *ctx, const char **err)
+{
+    if (str == NPJSON_NULL || sink == NPJSON_NULL)
+        return false;
+    NPJSON_Synthesizer syn  = _NPJSON_CreateRawSynthesizer(NPJSON_STREAM_BLOCK, sink, ctx);
+    bool               flag = _NPJSON_Reformat(&syn, str, len, indent, err) && _NPJSON_Flush(&syn);
+    NPJSON_DeleteSynthesizer(&syn);
+    return flag;
+}
+
+bool NPJSON_Minify(const char *str, size_t len, NPJSON_SObject *out, const char **err)
+{
+    return _NPJSON_ReformatToSObject(str, len, -1, out, err);
+}
+
+bool NPJSON_Beautify(const char *str, size_t len, int indent, NPJSON_SObject *out, const char **err)
+{
+    return _NPJSON_ReformatToSObject(str, len, indent < 0 ? 0 : indent, out, err);
+}
+
+bool NPJSON_MinifyToSink(const char *str, size_t len, NPJSON_SinkFunc sink, void *ctx, const char **err)
+{
+    return _NPJSON_ReformatToSink(str, len, -1, sink, ctx, err);
+}
+
+bool NPJSON_BeautifyToSink(const char *str, size_t len, int indent, NPJSON_SinkFunc sink, void *ctx, const char **err)
+{
+    return _NPJSON_ReformatToSink(str, len, indent < 0 ? 0 : indent, sink, ctx, err);
+}
+
+// 括号索引 第 k 个 { 或 [ （按出现顺序）的匹配位置
+typedef struct
+{
+    uint32_t close;   // 匹配的 } 或 ] 相对根对象的偏移（未闭合时为父括号序号）
+    uint32_t next;    // 匹配位置之后的下一个括号序号
+} _NPJSON_Bracket;
+
+#define NPJSON_BRACKET_NONE 0xFFFFFFFFU
+#define NPJSON_LOCAL_FRAMES 32   // 栈上帧数，更深时扩展到堆上
+
+// 一遍扫描建立括号索引，p 指向根对象的 {，返回括号数量，失败返回 0
+static uint32_t _NPJSON_BracketIndex(const char *p, const char *strend, const NPJSON_Allocator *alloc, _NPJSON_Bracket **out)
+{
+    const char *     root  = p;
+    _NPJSON_Bracket *idx   = NPJSON_NULL;
+    uint32_t         count = 0;
+    uint32_t         cap   = 0;
+    uint32_t         top   = NPJSON_BRACKET_NONE;   // 未闭合的括号以 close 字段串成栈
+    while (p != strend) {
+        p += _NPJSON_ScanStruct(p, strend - p);
+        if (p == strend)
+            break;
+        char ch = *p;
+        if (ch == '\"') {
+            p = _NPJSON_StringEnd(p + 1, strend, NPJSON_NULL);
+            if (p == NPJSON_NULL)
+                break;
+        } else if (ch == '{' || ch == '[') {
+            if (count == cap) {
+                cap                  = cap == 0 ? 64 : cap * 2;
+                _NPJSON_Bracket *tmp = idx == NPJSON_NULL ? ANEW(alloc, _NPJSON_Bracket, cap) : AREDIM(alloc, _NPJSON_Bracket, idx, cap);
+                if (tmp == NPJSON_NULL)
+                    break;
+                idx = tmp;
+            }
+            idx[count].close = top;
+            idx[count].next  = 0;
+            top              = count++;
+        } else {
+            uint32_t cur    = top;
+            top             = idx[cur].close;
+            idx[cur].close  = (uint32_t)(p - root);
+            idx[cur].next   = count;
+            if (top == NPJSON_BRACKET_NONE) {
+                NPJSON_STAT_ADD(scannedBytes, p - root + 1);
+                *out = idx;
+                return count;
+            }
+        }
+        p++;
+    }
+    if (idx != NPJSON_NULL)
+        ADELETE(alloc, idx);
+    return 0;
+}
+
+// 扫描栈帧
+typedef struct
+{
+    bool isArray;   // 数组
+    int  idx;       // 数组索引
+} _NPJSON_ScanFrame;
+
+// 标量回调转换
+typedef struct
+{
+    NPJSON_ScanFunc   fun;
+    void *            obj;
+    NPJSON_ScanResult rs;
+} _NPJSON_ScanCtx;
+
+static bool _NPJSON_ScanValue(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    _NPJSON_ScanCtx *ctx = (_NPJSON_ScanCtx *)obj;
+    ctx->rs              = ctx->fun(name, re, index, ctx->obj);
+    return ctx->rs != NPJSON_STOP;
+}
+
+bool NPJSON_ScanEx(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ScanFunc fun, const char **err)
+{
+    if (str == NPJSON_NULL || length <= 0 || fun == NPJSON_NULL)
+        return false;
+    if (err != NPJSON_NULL)
+        *err = str;
+    NPJSON_STAT_ADD(resolveCalls, 1);
+    NPJSON_STAT_ADD(inputBytes, length);
+    const char *p      = str;
+    const char *strend = str + length;
+    while (p != strend && *p != '{')
+        p++;
+    if (p == strend)
+        return false;
+    const char *     root = p;
+    _NPJSON_Bracket *idx  = NPJSON_NULL;
+    if (_NPJSON_BracketIndex(root, strend, alloc, &idx) == 0)
+        return false;
+    strend = root + idx[0].close + 1;
+
+    char          name[NPJSON_NAME_LEN + 1];
+    NPJSON_Result re;
+    memset(&re, 0, sizeof(re));
+    re.alloc   = alloc;
+    re.name    = name;
+    re.Resolve = _NPJSON_ResolveExev;
+    *name      = '\0';
+
+    _NPJSON_ScanCtx    ctx = {fun, obj, NPJSON_CONTINUE};
+    _NPJSON_ScanFrame  local[NPJSON_LOCAL_FRAMES];
+    _NPJSON_ScanFrame *stack = local;
+    int                cap   = NPJSON_LOCAL_FRAMES;
+    int                top   = 0;
+    uint32_t           k     = 1;   // 下一个括号序号
+    bool               ok    = false;
+    stack[0].isArray         = false;
+    stack[0].idx             = 0;
+    p                        = root + 1;
+    for (;;) {
+        _NPJSON_ScanFrame *f = &stack[top];
+        SKIPBLANK;
+        if (p == strend)
+            break;
+        re.err = p;
+        if (*p == (f->isArray ? ']' : '}')) {
+            p++;
+            if (top == 0) {
+                ok = true;
+                break;
+            }
+            f = &stack[--top];
+        } else {
+            if (f->isArray)
+                *name = '\0';
+            else {
+                // 对象名称
+                if (*p != '\"')
+                    break;
+                bool        esc = false;
+                const char *s   = ++p;
+                p               = _NPJSON_StringEnd(p, strend, &esc);
+                if (p == NPJSON_NULL || !_NPJSON_ResolveName(&re, s, p - s, esc))
+                    break;
+                p++;
+                SKIPBLANK;
+                if (p == strend || *p != ':')
+                    break;
+                p++;
+                SKIPBLANK;
+                if (p == strend)
+                    break;
+                re.err = p;
+            }
+            re.level  = top;
+            re.ArrIdx = f->isArray ? f->idx : 0;
+            if (*p == '{' || *p == '[') {
+                // 由索引直接得到范围
+                const char *e = root + idx[k].close;
+                if ((*e == '}') != (*p == '{'))
+                    break;
+                re.isArray = re.isBinValue = re.isInteger = re.isNull = re.isNumber = re.isString = 0;
+                re.isObject  = *p == '{';
+                re.isArray   = *p == '[';
+                re.str       = p;
+                re.Strlength = e - p + 1;
+                NPJSON_STAT_ADD(callbacks, 1);
+                NPJSON_ScanResult rs = fun(name, &re, re.ArrIdx, obj);
+                re.str               = NPJSON_NULL;
+                re.Strlength         = 0;
+                if (rs == NPJSON_STOP)
+                    break;
+                if (rs == NPJSON_SKIP) {
+                    // 跳过整个值
+                    p = e + 1;
+                    k = idx[k].next;
+                } else {
+                    // 入栈
+                    if (top + 2 > NPJSON_MAX_DEPTH)
+                        break;
+                    if (top + 1 == cap) {
+                        _NPJSON_ScanFrame *tmp = stack == local ? ANEW(alloc, _NPJSON_ScanFrame, cap * 2)
+                                                                : AREDIM(alloc, _NPJSON_ScanFrame, stack, cap * 2);
+                        if (tmp == NPJSON_NULL)
+                            break;
+                        if (stack == local)
+                            memcpy(tmp, local, sizeof(local));
+                        stack = tmp;
+                        cap *= 2;
+                    }
+                    top++;
+                    stack[top].isArray = *p == '[';
+                    stack[top].idx     = 0;
+                    NPJSON_STAT_DEPTH(top);
+                    p++;
+                    k++;
+                    continue;
+                }
+            } else if (*p == '\"') {
+                bool        esc = false;
+                const char *s   = ++p;
+                p               = _NPJSON_StringEnd(p, strend, &esc);
+                if (p == NPJSON_NULL || !_NPJSON_ResolveString(&re, s, p - s, esc))
+                    break;
+                p++;
+                re.isArray = re.isBinValue = re.isInteger = re.isNull = re.isNumber = re.isObject = 0;
+                re.isString = 1;
+                NPJSON_STAT_ADD(callbacks, 1);
+                if (fun(name, &re, re.ArrIdx, obj) == NPJSON_STOP)
+                    break;
+            } else {
+                const char *e = _NPJSON_ValueEnd(p, strend);
+                if (e == NPJSON_NULL || NPJSON_ResolveValue(&re, _NPJSON_ScanValue, p, e, &ctx) != e)
+                    break;
+                p = e;
+            }
+        }
+        // 分隔符
+        f->idx++;
+        SKIPBLANK;
+        if (p == strend)
+            break;
+        if (*p == ',')
+            p++;
+        else if (*p != (f->isArray ? ']' : '}'))
+            break;
+    }
+    if (stack != local)
+        ADELETE(alloc, stack);
+    ADELETE(alloc, idx);
+    if (re.buf != NPJSON_NULL)
+        ADELETE(alloc, re.buf);
+    if (err != NPJSON_NULL)
+        *err = ok ? NPJSON_NULL : (p == NPJSON_NULL ? re.err : p);
+    return ok;
+}
+
+bool NPJSON_Scan(const char *str, int length, void *obj, NPJSON_ScanFunc fun, const char **err)
+{
+    return NPJSON_ScanEx(str, length, NPJSON_NULL, obj, fun, err);
+}
+
+static const NPJSON_Option _DefaultOption = {false, NPJSON_NULL, 0, NPJSON_NULL, NPJSON_NULL, NPJSON_NULL, false};
+
+// 投影前缀树节点（根节点 name 为空）
+struct _NPJSON_Projection
+{
+    struct _NPJSON_Projection *child;   // 第一个子成员
+    struct _NPJSON_Projection *next;    // 兄弟成员
+    bool                       whole;   // 路径终点 保留整个值
+    char *                     name;    // 成员名称（紧跟在结构体之后）
+    const NPJSON_Allocator *   alloc;   // 分配器（仅根节点记录）
+    long                       gen;     // 创建序号（仅根节点记录） 解析缓存以此区分投影
+};
+
+// 投影创建序号 地址可能被删除后新建的投影复用 解析缓存不能按地址区分
+static volatile long _NPJSON_ProjectionGen;
+
+static NPJSON_Projection *_NPJSON_ProjectionFind(const NPJSON_Projection *p, const char *name, int len)
+{
+    for (NPJSON_Projection *c = p->child; c != NPJSON_NULL; c = c->next)
+        if (strncmp(c->name, name, len) == 0 && c->name[len] == '\0')
+            return c;
+    return NPJSON_NULL;
+}
+
+NPJSON_Projection *NPJSON_CreateProjection(const char *const *paths, int count)
+{
+    return NPJSON_CreateProjectionEx(paths, count, NPJSON_NULL);
+}
+
+NPJSON_Projection *NPJSON_CreateProjectionEx(const char *const *paths, int count, const NPJSON_Allocator *alloc)
+{
+    NPJSON_Projection *root = ANEW(alloc, NPJSON_Projection, 1);
+    if (root == NPJSON_NULL)
+        return NPJSON_NULL;
+    memset(root, 0, sizeof(NPJSON_Projection));
+    root->alloc = alloc;
+    root->gen   = NPJSON_ATOMIC_INC(&_NPJSON_ProjectionGen);
+    for (int i = 0; i < count; i++) {
+        NPJSON_Projection *n = root;
+        const char *       s = paths[i];
+        if (s == NPJSON_NULL)
+            continue;
+        while (*s != '\0' && !n->whole) {
+            const char *e = strchr(s, '.');
+            int         len = e == NPJSON_NULL ? (int)strlen(s) : (int)(e - s);
+            // 与解析一致 名称超过 NPJSON_NAME_LEN 截断
+            int                key = len > NPJSON_NAME_LEN ? NPJSON_NAME_LEN : len;
+            NPJSON_Projection *c   = _NPJSON_ProjectionFind(n, s, key);
+            if (c == NPJSON_NULL) {
+                c = (NPJSON_Projection *)ANEW(alloc, char, sizeof(NPJSON_Projection) + key + 1);
+                if (c == NPJSON_NULL) {
+                    NPJSON_DeleteProjection(root);
+                    return NPJSON_NULL;
+                }
+                memset(c, 0, sizeof(NPJSON_Projection));
+                c->name = (char *)(c + 1);
+                memcpy(c->name, s, key);
+                c->name[key] = '\0';
+                c->next      = n->child;
+                n->child     = c;
+            }
+            n = c;
+            s += len;
+            if (*s == '.')
+                s++;
+        }
+        n->whole = true;   // 较短的路径包含其后代
+    }
+    return root;
+}
+
+void NPJSON_DeleteProjection(NPJSON_Projection *p)
+{
+    const NPJSON_Allocator *alloc = p == NPJSON_NULL ? NPJSON_NULL : p->alloc;
+    // 子树拼接到兄弟链表末尾，不使用递归
+    while (p != NPJSON_NULL) {
+        NPJSON_Projection *t = p;
+        p                    = p->next;
+        if (t->child != NPJSON_NULL) {
+            NPJSON_Projection *c = t->child;
+            while (c->next != NPJSON_NULL)
+                c = c->next;
+            c->next = p;
+            p       = t->child;
+        }
+        ADELETE(alloc, t);
+    }
+}
+
+// 构建栈帧
+typedef struct
+{
+    NPJSONNode *             node;   // 当前对象或数组
+    NPJSONNode **            tail;   // 尾插位置
+    int                      idx;    // 数组索引
+    const NPJSON_Projection *proj;   // 投影 NULL 保留全部
+} _NPJSON_BuildFrame;
+
+// 构建上下文
+typedef struct
+{
+    _NPJSON_BuildFrame * frame;   // 当前帧
+    const NPJSON_Option *opt;
+} _NPJSON_BuilderCtx;
+
+// 数值追加到紧凑数组
+static bool _NPJSON_PackedAdd(NPJSONNode *n, NPJSON_Result *re, const NPJSON_Allocator *alloc)
+{
+    size_t cnt = n->Val.Packed.Count;
+    _NPJSON_ResultConvert(re);   // 紧凑数组需要数值
+    if (!n->isPacked) {
+        n->isPacked         = 1;
+        n->isPackedInt      = re->isInteger;
+        n->Val.Packed.Data  = NPJSON_NULL;
+        n->Val.Packed.Count = 0;
+    }
+    // 容量为 8 起的 2 的幂
+    if (cnt == 0 || (cnt >= 8 && (cnt & (cnt - 1)) == 0)) {
+        size_t cap = cnt == 0 ? 8 : cnt * 2;
+        void * tmp = cnt == 0 ? ANEW(alloc, int64_t, cap) : AREDIM(alloc, int64_t, n->Val.Packed.Data, cap);
+        if (tmp == NPJSON_NULL)
+            return false;
+        n->Val.Packed.Data = tmp;
+    }
+    if (n->isPackedInt && !re->isInteger) {
+        // 出现小数，整体转换为 double
+        int64_t *iv = (int64_t *)n->Val.Packed.Data;
+        double * dv = (double *)n->Val.Packed.Data;
+        for (size_t i = 0; i < cnt; i++)
+            dv[i] = (double)iv[i];
+        n->isPackedInt = 0;
+    }
+    if (n->isPackedInt)
+        ((int64_t *)n->Val.Packed.Data)[cnt] = re->Val.Value;
+    else
+        ((double *)n->Val.Packed.Data)[cnt] = re->Val.Number;
+    n->Val.Packed.Count = cnt + 1;
+    return true;
+}
+
+// 紧凑数组还原为节点（出现非数值元素），返回最后一个节点的 next 位置，失败返回 null
+static NPJSONNode **_NPJSON_Unpack(NPJSONNode *n, int level, const NPJSON_Allocator *alloc)
+{
+    void *       data = n->Val.Packed.Data;
+    size_t       cnt  = n->Val.Packed.Count;
+    NPJSONNode **tail = &n->Val.Object;
+    *tail             = NPJSON_NULL;
+    for (size_t i = 0; i < cnt; i++) {
+        NPJSONNode *tmp = ANEW(alloc, NPJSONNode, 1);
+        if (tmp == NPJSON_NULL) {
+            // 恢复紧凑存储
+            NPJSON_ReleaseEx(&n->Val.Object, alloc);
+            n->Val.Packed.Data  = data;
+            n->Val.Packed.Count = cnt;
+            return NPJSON_NULL;
+        }
+        memset(tmp, 0, sizeof(NPJSONNode));
+        NPJSON_STAT_ADD(nodes, 1);
+        tmp->level    = level;
+        tmp->ArrIdx   = (int)i;
+        tmp->isNumber = 1;
+        if (n->isPackedInt) {
+            tmp->isInteger  = 1;
+            tmp->Val.Value  = ((int64_t *)data)[i];
+            tmp->Val.Number = (double)tmp->Val.Value;
+        } else {
+            tmp->Val.Number = ((double *)data)[i];
+            tmp->Val.Value  = (long long)tmp->Val.Number;
+        }
+        *tail = tmp;
+        tail  = &tmp->next;
+    }
+    ADELETE(alloc, data);
+    n->isPacked       = 0;
+    n->isPackedInt    = 0;
+    n->Val.ChildCount = cnt;
+    return tail;
+}
+
+// 在当前帧尾部追加节点
+static NPJSONNode *_NPJSON_BuildAppend(_NPJSON_BuildFrame *f, const char *name, int level, const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = f->node;
+    if (n->isPacked) {
+        f->tail = _NPJSON_Unpack(n, level, alloc);
+        if (f->tail == NPJSON_NULL)
+            return NPJSON_NULL;
+    }
+    NPJSONNode *tmp = ANEW(alloc, NPJSONNode, 1);
+    if (tmp == NPJSON_NULL)
+        return NPJSON_NULL;
+    memset(tmp, 0, sizeof(NPJSONNode));
+    NPJSON_STAT_ADD(nodes, 1);
+    if (name != NPJSON_NULL && *name != '\0') {
+        int name_len = strlen(name);
+        tmp->name    = ANEW(alloc, char, name_len + 1);
+        if (tmp->name == NPJSON_NULL) {
+            ADELETE(alloc, tmp);
+            return NPJSON_NULL;
+        }
+        memcpy(tmp->name, name, name_len + 1);
+    }
+    tmp->level  = level;
+    tmp->ArrIdx = n->isArray ? f->idx : 0;
+    *f->tail    = tmp;
+    f->tail     = &tmp->next;
+    n->Val.ChildCount++;
+    return tmp;
+}
+
+// 数值原文 不超过 15 字节保存在节点内
+static bool _NPJSON_SetRaw(NPJSONNode *n, const char *raw, size_t len, const NPJSON_Allocator *alloc)
+{
+    n->isRaw = 1;
+    if (len < sizeof(n->Val.Raw)) {
+        memcpy(n->Val.Raw, raw, len);
+        n->Val.Raw[len] = '\0';
+        return true;
+    }
+    char *str = ANEW(alloc, char, len + 1);
+    if (str == NPJSON_NULL)
+        return false;
+    memcpy(str, raw, len);
+    str[len]          = '\0';
+    n->isRawPtr       = 1;
+    n->Val.StrPtr     = str;
+    n->Val.StrLength  = len;
+    return true;
+}
+
+// 标量值（由 NPJSON_ResolveValue 回调）
+static bool NPJSON_Builder_func(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    _NPJSON_BuilderCtx *    ctx   = (_NPJSON_BuilderCtx *)obj;
+    NPJSONNode *            n     = ctx->frame->node;
+    const NPJSON_Allocator *alloc = ctx->opt->alloc;
+    if (ctx->opt->filter != NPJSON_NULL) {
+        NPJSON_ScanResult rs = ctx->opt->filter(name, re, index, ctx->opt->filterCtx);
+        if (rs != NPJSON_CONTINUE)
+            return rs == NPJSON_SKIP;
+    }
+    if (n->isArray && ctx->opt->packed && re->isNumber && (n->isPacked || n->Val.Object == NPJSON_NULL))
+        return _NPJSON_PackedAdd(n, re, alloc);
+    NPJSONNode *tmp = _NPJSON_BuildAppend(ctx->frame, name, re->level, alloc);
+    if (tmp == NPJSON_NULL)
+        return false;
+    tmp->isBinValue = re->isBinValue;
+    tmp->isNull     = re->isNull;
+    tmp->isNumber   = re->isNumber;
+    tmp->isString   = re->isString;
+    tmp->isInteger  = re->isInteger;
+    if (re->isBinValue)
+        tmp->Val.BinValue = re->Val.BinValue;
+    else if (re->isRaw)
+        return _NPJSON_SetRaw(tmp, re->Val.Raw.ptr, re->Val.Raw.length, alloc);
+    else if (re->isInteger || re->isNumber) {
+        tmp->Val.Number = re->Val.Number;
+        tmp->Val.Value  = re->Val.Value;
+    } else if (tmp->isString) {
+        char *str = ANEW(alloc, char, (re->Val.String.length + 1));
+        if (str == NPJSON_NULL)
+            return false;
+        memcpy(str, re->Val.String.ptr, re->Val.String.length);
+        str[re->Val.String.length] = '\0';
+        tmp->Val.String            = str;
+        tmp->Val.StrLength         = re->Val.String.length;
+    }
+    return true;
+}
+
+// 单遍非递归构建，嵌套由显式栈维护，每个字节只扫描一次
+static bool _NPJSON_Build(NPJSONNode *root, const char *str, size_t len, const NPJSON_Option *opt, const char **err)
+{
+    const NPJSON_Allocator *alloc    = opt->alloc;
+    int                     maxDepth = opt->maxDepth > 0 ? opt->maxDepth : NPJSON_MAX_DEPTH;
+    const char *            p        = str;
+    const char *            strend   = str + len;
+    while (p != strend && *p != '{')
+        p++;
+    if (p == strend) {
+        if (err != NPJSON_NULL)
+            *err = str;
+        return false;
+    }
+    NPJSON_STAT_ADD(scannedBytes, strend - p);
+    char          name[NPJSON_NAME_LEN + 1];
+    NPJSON_Result re;
+    memset(&re, 0, sizeof(re));
+    re.alloc      = alloc;
+    re.name       = name;
+    re.lazyNumber = opt->lazyNumber;
+    *name         = '\0';
+
+    _NPJSON_BuildFrame  local[NPJSON_LOCAL_FRAMES];
+    _NPJSON_BuildFrame *stack = local;
+    int                 cap   = NPJSON_LOCAL_FRAMES;
+    int                 top   = 0;
+    bool                ok    = false;
+    stack[0].node             = root;
+    stack[0].tail             = &root->Val.Object;
+    stack[0].idx              = 0;
+    stack[0].proj             = opt->projection != NPJSON_NULL && !opt->projection->whole ? opt->projection : NPJSON_NULL;
+    _NPJSON_BuilderCtx ctx    = {stack, opt};
+    p++;
+    for (;;) {
+        _NPJSON_BuildFrame *f = &stack[top];
+        SKIPBLANK;
+        if (p == strend)
+            break;
+        re.err = p;
+        if (*p == (f->node->isArray ? ']' : '}')) {
+            // 出栈
+            p++;
+            if (top == 0) {
+                ok = true;
+                break;
+            }
+            f = &stack[--top];
+        } else {
+            if (f->node->isArray)
+                *name = '\0';
+            else {
+                // 对象名称
+                if (*p != '\"')
+                    break;
+                bool        esc = false;
+                const char *s   = ++p;
+                p               = _NPJSON_StringEnd(p, strend, &esc);
+                if (p == NPJSON_NULL || !_NPJSON_ResolveName(&re, s, p - s, esc))
+                    break;
+                p++;
+                SKIPBLANK;
+                if (p == strend || *p != ':')
+                    break;
+                p++;
+                SKIPBLANK;
+                if (p == strend)
+                    break;
+                re.err = p;
+            }
+            re.level  = top;
+            re.ArrIdx = f->node->isArray ? f->idx : 0;
+            // 投影 数组对其元素透明，标量只在路径终点内保留
+            const NPJSON_Projection *proj = f->proj;
+            NPJSON_ScanResult        rs   = NPJSON_CONTINUE;
+            if (proj != NPJSON_NULL) {
+                if (!f->node->isArray) {
+                    proj = _NPJSON_ProjectionFind(f->proj, name, (int)strlen(name));
+                    if (proj == NPJSON_NULL)
+                        rs = NPJSON_SKIP;
+                    else if (proj->whole)
+                        proj = NPJSON_NULL;
+                }
+                if (proj != NPJSON_NULL && *p != '{' && *p != '[')
+                    rs = NPJSON_SKIP;
+            }
+            if (rs == NPJSON_CONTINUE && (*p == '{' || *p == '[') && opt->filter != NPJSON_NULL) {
+                // 过滤 容器尚未匹配，Strlength 为 0
+                re.isArray = re.isBinValue = re.isInteger = re.isNull = re.isNumber = re.isString = 0;
+                re.isObject = *p == '{';
+                re.isArray  = *p == '[';
+                re.str      = p;
+                rs          = opt->filter(name, &re, re.ArrIdx, opt->filterCtx);
+                re.str      = NPJSON_NULL;
+                if (rs == NPJSON_STOP)
+                    break;
+            }
+            ctx.frame = f;
+            if (rs == NPJSON_SKIP) {
+                // 跳过整个值 不解码、不分配
+                const char *e = _NPJSON_ValueEnd(p, strend);
+                if (e == NPJSON_NULL)
+                    break;
+                p = e;
+            } else if (*p == '{' || *p == '[') {
+                // 入栈
+                if (top + 2 > maxDepth)
+                    break;
+                if (top + 1 == cap) {
+                    _NPJSON_BuildFrame *tmp = stack == local ? ANEW(alloc, _NPJSON_BuildFrame, cap * 2)
+                                                             : AREDIM(alloc, _NPJSON_BuildFrame, stack, cap * 2);
+                    if (tmp == NPJSON_NULL)
+                        break;
+                    if (stack == local)
+                        memcpy(tmp, local, sizeof(local));
+                    stack = tmp;
+                    cap *= 2;
+                    f = &stack[top];
+                }
+                NPJSONNode *n = _NPJSON_BuildAppend(f, name, top, alloc);
+                if (n == NPJSON_NULL)
+                    break;
+                NPJSON_STAT_ADD(callbacks, 1);   // 与递归解析一致 容器计一次回调
+                n->isObject = *p == '{';
+                n->isArray  = *p == '[';
+                top++;
+                stack[top].node = n;
+                stack[top].tail = &n->Val.Object;
+                stack[top].idx  = 0;
+                stack[top].proj = proj;
+                NPJSON_STAT_DEPTH(top);
+                p++;
+                continue;
+            } else if (*p == '\"') {
+                // 字符串直接解码，不再二次扫描
+                bool        esc = false;
+                const char *s   = ++p;
+                p               = _NPJSON_StringEnd(p, strend, &esc);
+                if (p == NPJSON_NULL || !_NPJSON_ResolveString(&re, s, p - s, esc))
+                    break;
+                p++;
+                re.isArray = re.isBinValue = re.isInteger = re.isNull = re.isNumber = re.isObject = re.isRaw = 0;
+                re.isString = 1;
+                if (NPJSON_STAT_ADD(callbacks, 1), !NPJSON_Builder_func(name, &re, re.ArrIdx, &ctx))
+                    break;
+            } else {
+                const char *e = _NPJSON_ValueEnd(p, strend);
+                if (e == NPJSON_NULL || NPJSON_ResolveValue(&re, NPJSON_Builder_func, p, e, &ctx) != e)
+                    break;
+                p = e;
+            }
+        }
+        // 分隔符
+        f->idx++;
+        SKIPBLANK;
+        if (p == strend)
+            break;
+        if (*p == ',')
+            p++;
+        else if (*p != (f->node->isArray ? ']' : '}'))
+            break;
+    }
+    if (stack != local)
+        ADELETE(alloc, stack);
+    if (re.buf != NPJSON_NULL)
+        ADELETE(alloc, re.buf);
+    if (err != NPJSON_NULL)
+        *err = ok ? NPJSON_NULL : (p == NPJSON_NULL ? re.err : p);
+    return ok;
+}
+
+NPJSONNode *NPJSON_BuilderEx(const char *str, size_t len, const NPJSON_Option *opt, const char **err)
+{
+    if (str == NPJSON_NULL || len <= 0)
+        return NPJSON_NULL;
+    if (opt == NPJSON_NULL)
+        opt = &_DefaultOption;
+    NPJSON_STAT_BEGIN();
+    NPJSON_STAT_ADD(resolveCalls, 1);
+    NPJSON_STAT_ADD(inputBytes, len);
+    NPJSONNode *n = ANEW(opt->alloc, NPJSONNode, 1);
+    if (n == NPJSON_NULL)
+        return NPJSON_NULL;
+    memset(n, 0, sizeof(NPJSONNode));
+    NPJSON_STAT_ADD(nodes, 1);
+    n->isObject = 1;
+    n->level    = 0;
+    if (!_NPJSON_Build(n, str, len, opt, err))
+        NPJSON_ReleaseEx(&n, opt->alloc);
+    NPJSON_STAT_END(buildLatency);
+    return n;
+}
+
+NPJSONNode *NPJSON_Builder(const char *str, size_t len, const char **err)
+{
+    return NPJSON_BuilderEx(str, len, NPJSON_NULL, err);
+}
+
+void NPJSON_ReleaseEx(NPJSONNode **n, const NPJSON_Allocator *alloc)
+{
+    if (n == NPJSON_NULL || *n == NPJSON_NULL)
+        return;
+    // 子节点链表拼接到待释放链表前端，不使用递归
+    NPJSONNode *p = (*n);
+    while (p != NPJSON_NULL) {
+        NPJSONNode *t = p;
+        p             = p->next;
+        if (t->isString && t->Val.String != NPJSON_NULL)
+            ADELETE(alloc, t->Val.String);
+        if (t->isRawPtr)
+            ADELETE(alloc, t->Val.StrPtr);
+        if (t->name != NPJSON_NULL)
+            ADELETE(alloc, t->name);
+        if (t->isPacked)
+            ADELETE(alloc, t->Val.Packed.Data);
+        else if ((t->isObject || t->isArray) && t->Val.Object != NPJSON_NULL) {
+            NPJSONNode *c = t->Val.Object;
+            while (c->next != NPJSON_NULL)
+                c = c->next;
+            c->next = p;
+            p       = t->Val.Object;
+        }
+        ADELETE(alloc, t);
+    }
+    *n = NPJSON_NULL;
+    return;
+}
+
+void NPJSON_Release(NPJSONNode **n)
+{
+    NPJSON_ReleaseEx(n, NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_Find(NPJSONNode *n, const char *name)
+{
+    if (name == NPJSON_NULL || *name == '\0' || n == NPJSON_NULL || n->isObject == 0 || n->isPacked)
+        return NPJSON_NULL;
+    n = n->Val.Object;
+    while (n != NPJSON_NULL) {
+        NPJSONNode *t = n;
+        n             = n->next;
+        if (t->name != NPJSON_NULL && strcmp(t->name, name) == 0)
+            return t;
+    }
+    return NPJSON_NULL;
+}
+
+size_t NPJSON_GetChildCount(NPJSONNode *n)
+{
+    if (n == NPJSON_NULL)
+        return 0;
+    return n->isObject || n->isArray ? n->Val.ChildCount : 0;
+}
+
+NPJSONNode *NPJSON_GetChild(NPJSONNode *n)
+{
+    if (n == NPJSON_NULL || n->isPacked || !(n->isObject || n->isArray))
+        return NPJSON_NULL;
+    return n->Val.Object;
+}
+
+NPJSONNode *NPJSON_GetNext(NPJSONNode *n)
+{
+    return n == NPJSON_NULL ? NPJSON_NULL : n->next;
+}
+
+const char *NPJSON_GetRaw(const NPJSONNode *n, size_t *len)
+{
+    if (n == NPJSON_NULL || !n->isRaw)
+        return NPJSON_NULL;
+    if (len != NPJSON_NULL)
+        *len = n->isRawPtr ? n->Val.StrLength : strlen(n->Val.Raw);
+    return n->isRawPtr ? n->Val.StrPtr : n->Val.Raw;
+}
+
+long long NPJSON_GetInt(const NPJSONNode *n)
+{
+    if (n == NPJSON_NULL)
+        return 0;
+    if (n->isRaw) {
+        size_t      len;
+        long long   value;
+        double      number;
+        const char *raw = NPJSON_GetRaw(n, &len);
+        _NPJSON_ResolveNumber(raw, raw + len, &value, &number);
+        return value;
+    }
+    if (n->isBinValue)
+        return n->Val.BinValue;
+    return n->isNumber || n->isInteger ? n->Val.Value : 0;
+}
+
+double NPJSON_GetNumber(const NPJSONNode *n)
+{
+    if (n == NPJSON_NULL)
+        return 0;
+    if (n->isRaw) {
+        size_t      len;
+        long long   value;
+        double      number;
+        const char *raw = NPJSON_GetRaw(n, &len);
+        _NPJSON_ResolveNumber(raw, raw + len, &value, &number);
+        return number;
+    }
+    if (n->isBinValue)
+        return n->Val.BinValue;
+    return n->isNumber || n->isInteger ? n->Val.Number : 0;
+}
+
+const int64_t *NPJSON_GetPackedInt64(NPJSONNode *n, size_t *count)
+{
+    if (n == NPJSON_NULL || !n->isPacked || !n->isPackedInt)
+        return NPJSON_NULL;
+    if (count != NPJSON_NULL)
+        *count = n->Val.Packed.Count;
+    return (const int64_t *)n->Val.Packed.Data;
+}
+
+const double *NPJSON_GetPackedDouble(NPJSONNode *n, size_t *count)
+{
+    if (n == NPJSON_NULL || !n->isPacked || n->isPackedInt)
+        return NPJSON_NULL;
+    if (count != NPJSON_NULL)
+        *count = n->Val.Packed.Count;
+    return (const double *)n->Val.Packed.Data;
+}
+
+size_t NPJSON_CopyInt64Array(NPJSONNode *n, int64_t *out, size_t capacity)
+{
+    if (n == NPJSON_NULL || out == NPJSON_NULL || !n->isArray)
+        return 0;
+    size_t i = 0;
+    if (n->isPacked) {
+        i = n->Val.Packed.Count < capacity ? n->Val.Packed.Count : capacity;
+        if (n->isPackedInt)
+            memcpy(out, n->Val.Packed.Data, i * sizeof(int64_t));
+        else {
+            const double *dv = (const double *)n->Val.Packed.Data;
+            for (size_t k = 0; k < i; k++)
+                out[k] = (int64_t)dv[k];
+        }
+        return i;
+    }
+    for (NPJSONNode *t = n->Val.Object; t != NPJSON_NULL && i < capacity; t = t->next) {
+        if (!t->isNumber)
+            break;
+        out[i++] = NPJSON_GetInt(t);
+    }
+    return i;
+}
+
+size_t NPJSON_CopyDoubleArray(NPJSONNode *n, double *out, size_t capacity)
+{
+    if (n == NPJSON_NULL || out == NPJSON_NULL || !n->isArray)
+        return 0;
+    size_t i = 0;
+    if (n->isPacked) {
+        i = n->Val.Packed.Count < capacity ? n->Val.Packed.Count : capacity;
+        if (!n->isPackedInt)
+            memcpy(out, n->Val.Packed.Data, i * sizeof(double));
+        else {
+            const int64_t *iv = (const int64_t *)n->Val.Packed.Data;
+            for (size_t k = 0; k < i; k++)
+                out[k] = (double)iv[k];
+        }
+        return i;
+    }
+    for (NPJSONNode *t = n->Val.Object; t != NPJSON_NULL && i < capacity; t = t->next) {
+        if (!t->isNumber)
+            break;
+        out[i++] = NPJSON_GetNumber(t);
+    }
+    return i;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 拉取游标 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct _NPJSON_Cursor
+{
+    const char *            p;         // 扫描位置
+    const char *            strend;    // 输入结束
+    const char *            err;       // 错误位置
+    const NPJSON_Allocator *alloc;     // 分配器
+    NPJSON_TokenType        type;      // 当前值类型
+    const char *            val;       // 当前值起始
+    const char *            valEnd;    // 当前值结束（字符串为结束引号）
+    bool                    esc;       // 当前字符串包含转义
+    bool                    pending;   // 当前值为未进入的对象、数组
+    bool                    first;     // 当前层尚未读取值
+    bool                    hasKey;    // 当前值有名称
+    char *                  stack;     // 各层结束符 } 或 ]
+    int                     depth;     // 层数
+    int                     cap;       // stack 容量
+    char *                  key;       // 名称缓存
+    int                     keyCap;    // 名称缓存大小
+    char *                  buf;       // 字符串解码缓存
+    int                     bufCap;    // 解码缓存大小
+};
+
+// 缓存至少 size 字节
+static bool _NPJSON_CursorReserve(NPJSON_Cursor *c, char **buf, int *cap, int size)
+{
+    if (size <= *cap)
+        return true;
+    int   n   = *cap * 2 > size ? *cap * 2 : size;
+    char *tmp = *buf == NPJSON_NULL ? ANEW(c->alloc, char, n) : AREDIM(c->alloc, char, *buf, n);
+    if (tmp == NPJSON_NULL)
+        return false;
+    *buf = tmp;
+    *cap = n;
+    return true;
+}
+
+static bool _NPJSON_CursorFail(NPJSON_Cursor *c, const char *p)
+{
+    if (c->err == NPJSON_NULL)
+        c->err = p == NPJSON_NULL ? c->strend : p;
+    c->type    = NPJSON_TOKEN_NONE;
+    c->pending = false;
+    return false;
+}
+
+NPJSON_Cursor *NPJSON_CreateCursorEx(const char *str, size_t len, const NPJSON_Allocator *alloc)
+{
+    if (str == NPJSON_NULL || len == 0)
+        return NPJSON_NULL;
+    NPJSON_Cursor *c = ANEW(alloc, NPJSON_Cursor, 1);
+    if (c == NPJSON_NULL)
+        return NPJSON_NULL;
+    memset(c, 0, sizeof(NPJSON_Cursor));
+    c->alloc  = alloc;
+    c->strend = str + len;
+    c->cap    = NPJSON_LOCAL_FRAMES;
+    c->stack  = ANEW(alloc, char, c->cap);
+    if (c->stack == NPJSON_NULL || !_NPJSON_CursorReserve(c, &c->key, &c->keyCap, NPJSON_NAME_LEN + 1)) {
+        NPJSON_DeleteCursor(c);
+        return NPJSON_NULL;
+    }
+    *c->key            = '\0';
+    const char *p      = str;
+    const char *strend = c->strend;
+    SKIPBLANK;
+    if (p == strend || (*p != '{' && *p != '[')) {
+        _NPJSON_CursorFail(c, p);
+        return c;
+    }
+    // 当前值为根
+    c->p       = p;
+    c->val     = p;
+    c->type    = *p == '{' ? NPJSON_TOKEN_OBJECT : NPJSON_TOKEN_ARRAY;
+    c->pending = true;
+    return c;
+}
+
+NPJSON_Cursor *NPJSON_CreateCursor(const char *str, size_t len)
+{
+    return NPJSON_CreateCursorEx(str, len, NPJSON_NULL);
+}
+
+void NPJSON_DeleteCursor(NPJSON_Cursor *c)
+{
+    if (c == NPJSON_NULL)
+        return;
+    if (c->stack != NPJSON_NULL)
+        ADELETE(c->alloc, c->stack);
+    if (c->key != NPJSON_NULL)
+        ADELETE(c->alloc, c->key);
+    if (c->buf != NPJSON_NULL)
+        ADELETE(c->alloc, c->buf);
+    ADELETE(c->alloc, c);
+}
+
+bool NPJSON_CursorNext(NPJSON_Cursor *c)
+{
+    if (c == NPJSON_NULL || c->err != NPJSON_NULL || c->depth == 0)
+        return false;
+    const char *p      = c->p;
+    const char *strend = c->strend;
+    if (c->pending) {
+        // 未进入的对象、数组直接跳过
+        p = _NPJSON_MatchBracket(c->val, strend);
+        if (p == NPJSON_NULL)
+            return _NPJSON_CursorFail(c, c->val);
+        p++;
+    }
+    c->type    = NPJSON_TOKEN_NONE;
+    c->pending = false;
+    c->hasKey  = false;
+    char close = c->stack[c->depth - 1];
+    SKIPBLANK;
+    if (p != strend && !c->first && *p == ',') {
+        p++;
+        SKIPBLANK;
+    } else if (p != strend && !c->first && *p != close)
+        return _NPJSON_CursorFail(c, p);
+    if (p == strend)
+        return _NPJSON_CursorFail(c, p);
+    if (*p == close) {
+        // 当前层结束 返回上一层
+        c->p     = p + 1;
+        c->first = false;
+        c->depth--;
+        return false;
+    }
+    c->first = false;
+    if (close == '}') {
+        // 对象名称
+        if (*p != '\"')
+            return _NPJSON_CursorFail(c, p);
+        bool        esc = false;
+        const char *s   = ++p;
+        p               = _NPJSON_StringEnd(p, strend, &esc);
+        if (p == NPJSON_NULL || !_NPJSON_CursorReserve(c, &c->key, &c->keyCap, p - s + 1))
+            return _NPJSON_CursorFail(c, s);
+        int n = esc ? _NPJSON_Unescape(c->key, s, p - s) : (int)(p - s);
+        if (n < 0)
+            return _NPJSON_CursorFail(c, s);
+        if (!esc)
+            memcpy(c->key, s, n);
+        c->key[n] = '\0';
+        c->hasKey = true;
+        p++;
+        SKIPBLANK;
+        if (p == strend || *p != ':')
+            return _NPJSON_CursorFail(c, p);
+        p++;
+        SKIPBLANK;
+        if (p == strend)
+            return _NPJSON_CursorFail(c, p);
+    }
+    // 只确定值的类型和范围，转换在读取时进行
+    char ch = *p;
+    c->val  = p;
+    if (ch == '{' || ch == '[') {
+        c->type    = ch == '{' ? NPJSON_TOKEN_OBJECT : NPJSON_TOKEN_ARRAY;
+        c->pending = true;
+    } else if (ch == '\"') {
+        c->esc = false;
+        p      = _NPJSON_StringEnd(p + 1, strend, &c->esc);
+        if (p == NPJSON_NULL)
+            return _NPJSON_CursorFail(c, c->val);
+        c->valEnd = p++;
+        c->type   = NPJSON_TOKEN_STRING;
+    } else if (IS_NUMBER(ch)) {
+        while (p != strend && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+            p++;
+        c->valEnd = p;
+        c->type   = NPJSON_TOKEN_NUMBER;
+    } else if (strend - p >= 4 && memcmp(p, "true", 4) == 0) {
+        p += 4;
+        c->type = NPJSON_TOKEN_BOOL;
+    } else if (strend - p >= 5 && memcmp(p, "false", 5) == 0) {
+        p += 5;
+        c->type = NPJSON_TOKEN_BOOL;
+    } else if (strend - p >= 4 && memcmp(p, "null", 4) == 0) {
+        p += 4;
+        c->type = NPJSON_TOKEN_NULL;
+    } else
+        return _NPJSON_CursorFail(c, p);
+    c->p = p;
+    return true;
+}
+
+bool NPJSON_CursorEnter(NPJSON_Cursor *c)
+{
+    if (c == NPJSON_NULL || c->err != NPJSON_NULL || !c->pending)
+        return false;
+    if (c->depth + 1 > NPJSON_MAX_DEPTH)
+        return _NPJSON_CursorFail(c, c->val);
+    if (c->depth == c->cap) {
+        char *tmp = AREDIM(c->alloc, char, c->stack, c->cap * 2);
+        if (tmp == NPJSON_NULL)
+            return _NPJSON_CursorFail(c, c->val);
+        c->stack = tmp;
+        c->cap *= 2;
+    }
+    c->stack[c->depth++] = *c->val == '{' ? '}' : ']';
+    NPJSON_STAT_DEPTH(c->depth - 1);
+    c->p       = c->val + 1;
+    c->pending = false;
+    c->first   = true;
+    c->hasKey  = false;
+    c->type    = NPJSON_TOKEN_NONE;
+    return true;
+}
+
+bool NPJSON_CursorSkip(NPJSON_Cursor *c)
+{
+    if (c == NPJSON_NULL || c->err != NPJSON_NULL || c->depth == 0)
+        return false;
+    int depth = c->depth;
+    while (NPJSON_CursorNext(c))
+        ;
+    return c->err == NPJSON_NULL && c->depth == depth - 1;
+}
+
+NPJSON_TokenType NPJSON_CursorType(const NPJSON_Cursor *c)
+{
+    return c == NPJSON_NULL ? NPJSON_TOKEN_NONE : c->type;
+}
+
+const char *NPJSON_CursorKey(const NPJSON_Cursor *c)
+{
+    return c == NPJSON_NULL || !c->hasKey ? NPJSON_NULL : c->key;
+}
+
+int NPJSON_CursorDepth(const NPJSON_Cursor *c)
+{
+    return c == NPJSON_NULL ? 0 : c->depth;
+}
+
+const char *NPJSON_CursorError(const NPJSON_Cursor *c)
+{
+    return c == NPJSON_NULL ? NPJSON_NULL : c->err;
+}
+
+long long NPJSON_CursorGetInt(const NPJSON_Cursor *c)
+{
+    long long value  = 0;
+    double    number = 0;
+    if (c == NPJSON_NULL)
+        return 0;
+    if (c->type == NPJSON_TOKEN_NUMBER)
+        _NPJSON_ResolveNumber(c->val, c->valEnd, &value, &number);
+    else if (c->type == NPJSON_TOKEN_BOOL)
+        value = *c->val == 't';
+    return value;
+}
+
+double NPJSON_CursorGetNumber(const NPJSON_Cursor *c)
+{
+    long long value  = 0;
+    double    number = 0;
+    if (c == NPJSON_NULL)
+        return 0;
+    if (c->type == NPJSON_TOKEN_NUMBER)
+        _NPJSON_ResolveNumber(c->val, c->valEnd, &value, &number);
+    else if (c->type == NPJSON_TOKEN_BOOL)
+        number = *c->val == 't';
+    return number;
+}
+
+bool NPJSON_CursorGetBool(const NPJSON_Cursor *c)
+{
+    if (c == NPJSON_NULL)
+        return false;
+    if (c->type == NPJSON_TOKEN_BOOL)
+        return *c->val == 't';
+    return c->type == NPJSON_TOKEN_NUMBER && NPJSON_CursorGetNumber(c) != 0;
+}
+
+const char *NPJSON_CursorGetString(NPJSON_Cursor *c, int *len)
+{
+    if (c == NPJSON_NULL || c->type != NPJSON_TOKEN_STRING)
+        return NPJSON_NULL;
+    const char *s = c->val + 1;
+    int         n = (int)(c->valEnd - s);
+    if (c->esc) {
+        // 解码到缓存 缓存只在更长的字符串出现时扩容
+        if (!_NPJSON_CursorReserve(c, &c->buf, &c->bufCap, n + 1))
+            return NPJSON_NULL;
+        n = _NPJSON_Unescape(c->buf, s, n);
+        if (n < 0)
+            return NPJSON_NULL;
+        c->buf[n] = '\0';
+        s         = c->buf;
+    }
+#if defined(CFG_NPJSON_UTF8_CHECK)
+    if (!NPJSON_CheckUTF8(s, n))
+        return NPJSON_NULL;
+#endif
+    if (len != NPJSON_NULL)
+        *len = n;
+    return s;
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 文档修改、输出  |
+// ----------------------------------------------------------------------------------------------------
+
+static NPJSONNode *_NPJSON_NewNode(const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = ANEW(alloc, NPJSONNode, 1);
+    if (n != NPJSON_NULL)
+        memset(n, 0, sizeof(NPJSONNode));
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateNullEx(const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL)
+        n->isNull = 1;
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateBoolEx(bool value, const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL) {
+        n->isBinValue   = 1;
+        n->Val.BinValue = value;
+    }
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateIntEx(long long value, const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL) {
+        n->isNumber   = 1;
+        n->isInteger  = 1;
+        n->Val.Value  = value;
+        n->Val.Number = (double)value;
+    }
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateNumberEx(double value, const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL) {
+        n->isNumber   = 1;
+        n->Val.Number = value;
+        n->Val.Value  = (long long)value;
+    }
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateStringEx(const char *value, const NPJSON_Allocator *alloc)
+{
+    if (value == NPJSON_NULL)
+        return NPJSON_CreateNullEx(alloc);
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n == NPJSON_NULL)
+        return NPJSON_NULL;
+    size_t len = strlen(value);
+    n->isString   = 1;
+    n->Val.String = ANEW(alloc, char, len + 1);
+    if (n->Val.String == NPJSON_NULL) {
+        ADELETE(alloc, n);
+        return NPJSON_NULL;
+    }
+    memcpy(n->Val.String, value, len + 1);
+    n->Val.StrLength = len;
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateObjectEx(const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL)
+        n->isObject = 1;
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateArrayEx(const NPJSON_Allocator *alloc)
+{
+    NPJSONNode *n = _NPJSON_NewNode(alloc);
+    if (n != NPJSON_NULL)
+        n->isArray = 1;
+    return n;
+}
+
+NPJSONNode *NPJSON_CreateNull(void)
+{
+    return NPJSON_CreateNullEx(NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateBool(bool value)
+{
+    return NPJSON_CreateBoolEx(value, NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateInt(long long value)
+{
+    return NPJSON_CreateIntEx(value, NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateNumber(double value)
+{
+    return NPJSON_CreateNumberEx(value, NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateString(const char *value)
+{
+    return NPJSON_CreateStringEx(value, NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateObject(void)
+{
+    return NPJSON_CreateObjectEx(NPJSON_NULL);
+}
+
+NPJSONNode *NPJSON_CreateArray(void)
+{
+    return NPJSON_CreateArrayEx(NPJSON_NULL);
+}
+
+static void _NPJSON_SetLevel(NPJSONNode *n, int level)
+{
+    n->level = level;
+    if (n->isPacked || !(n->isObject || n->isArray))
+        return;
+    for (NPJSONNode *t = n->Val.Object; t != NPJSON_NULL; t = t->next)
+        _NPJSON_SetLevel(t, level + 1);
+}
+
+// 查找子节点的前驱指针
+static NPJSONNode **_NPJSON_ChildLink(NPJSONNode *parent, NPJSONNode *child)
+{
+    NPJSONNode **pp = &parent->Val.Object;
+    while (*pp != NPJSON_NULL && *pp != child)
+        pp = &(*pp)->next;
+    return *pp == NPJSON_NULL ? NPJSON_NULL : pp;
+}
+
+bool NPJSON_InsertEx(NPJSONNode *parent, int index, const char *name, NPJSONNode *item, const NPJSON_Allocator *alloc)
+{
+    if (parent == NPJSON_NULL || item == NPJSON_NULL || item->next != NPJSON_NULL ||
+        (parent->isObject == 0 && parent->isArray == 0))
+        return false;
+    if (parent->isObject && (name == NPJSON_NULL || *name == '\0'))
+        return false;
+    if (parent->isPacked && _NPJSON_Unpack(parent, parent->level + 1, alloc) == NPJSON_NULL)
+        return false;
+    char *str = NPJSON_NULL;
+    if (parent->isObject) {
+        size_t len = strlen(name);
+        str        = ANEW(alloc, char, len + 1);
+        if (str == NPJSON_NULL)
+            return false;
+        memcpy(str, name, len + 1);
+    }
+    if (item->name != NPJSON_NULL)
+        ADELETE(alloc, item->name);
+    item->name       = str;
+    NPJSONNode **pp  = &parent->Val.Object;
+    for (int i = 0; *pp != NPJSON_NULL && (index < 0 || i < index); i++)
+        pp = &(*pp)->next;
+    item->next = *pp;
+    *pp        = item;
+    parent->Val.ChildCount++;
+    _NPJSON_SetLevel(item, parent->level + 1);
+    return true;
+}
+
+bool NPJSON_Insert(NPJSONNode *parent, int index, const char *name, NPJSONNode *item)
+{
+    return NPJSON_InsertEx(parent, index, name, item, NPJSON_NULL);
+}
+
+bool NPJSON_ReplaceEx(NPJSONNode *parent, NPJSONNode *child, NPJSONNode *item, const NPJSON_Allocator *alloc)
+{
+    if (parent == NPJSON_NULL || child == NPJSON_NULL || item == NPJSON_NULL ||
+        item->next != NPJSON_NULL || parent->isPacked)
+        return false;
+    NPJSONNode **pp = _NPJSON_ChildLink(parent, child);
+    if (pp == NPJSON_NULL)
+        return false;
+    // 沿用原名称
+    if (item->name != NPJSON_NULL)
+        ADELETE(alloc, item->name);
+    item->name  = child->name;
+    child->name = NPJSON_NULL;
+    item->next  = child->next;
+    child->next = NPJSON_NULL;
+    *pp         = item;
+    _NPJSON_SetLevel(item, parent->level + 1);
+    NPJSON_ReleaseEx(&child, alloc);
+    return true;
+}
+
+bool NPJSON_Replace(NPJSONNode *parent, NPJSONNode *child, NPJSONNode *item)
+{
+    return NPJSON_ReplaceEx(parent, child, item, NPJSON_NULL);
+}
+
+bool NPJSON_RemoveEx(NPJSONNode *parent, NPJSONNode *child, const NPJSON_Allocator *alloc)
+{
+    if (parent == NPJSON_NULL || child == NPJSON_NULL || parent->isPacked)
+        return false;
+    NPJSONNode **pp = _NPJSON_ChildLink(parent, child);
+    if (pp == NPJSON_NULL)
+        return false;
+    *pp         = child->next;
+    child->next = NPJSON_NULL;
+    parent->Val.ChildCount--;
+    NPJSON_ReleaseEx(&child, alloc);
+    return true;
+}
+
+bool NPJSON_Remove(NPJSONNode *parent, NPJSONNode *child)
+{
+    return NPJSON_RemoveEx(parent, child, NPJSON_NULL);
+}
+
+// 最短可还原的浮点格式，NaN、Infinity 输出 null
+static int _NPJSON_FormatDouble(char *buf, double value)
+{
+    if ((value * 0) != 0) {
+        memcpy(buf, "null", 4);
+        return 4;
+    }
+    int len = CM_snprintf(buf, 32, "%.15g", value);
+    if (strtod(buf, NPJSON_NULL) != value)
+        len = CM_snprintf(buf, 32, "%.17g", value);
+    return len;
+}
+
+// 浮点数格式化缓存 第一遍按遍历顺序保存文本（1 字节长度 + 文本），第二遍直接复制
+typedef struct
+{
+    char * buf;
+    size_t len;    // 已使用长度
+    size_t cap;
+    size_t pos;    // 第二遍读取位置
+    bool   full;   // 扩容失败 之后不再缓存（已缓存的部分仍然有效）
+} _NPJSON_PrintCache;
+
+#define NPJSON_PRINT_CACHE (64 * 1024)   // 浮点数缓存初始大小 按 4 倍扩容
+
+// 第一遍：格式化并缓存 未缓存的由第二遍重新格式化
+static int _NPJSON_SizeDouble(_NPJSON_PrintCache *c, double value)
+{
+    char tmp[32];
+    if (c != NPJSON_NULL && c->len + 33 > c->cap && !c->full) {
+        size_t cap = c->cap == 0 ? NPJSON_PRINT_CACHE : c->cap * 4;
+        char * buf = c->buf == NPJSON_NULL ? NEW(char, cap) : REDIM(char, c->buf, cap);
+        if (buf != NPJSON_NULL) {
+            c->buf = buf;
+            c->cap = cap;
+        } else
+            c->full = true;
+    }
+    if (c == NPJSON_NULL || c->len + 33 > c->cap)
+        return _NPJSON_FormatDouble(tmp, value);
+    int len        = _NPJSON_FormatDouble(c->buf + c->len + 1, value);
+    c->buf[c->len] = (char)len;
+    c->len += len + 1;
+    return len;
+}
+
+// 第二遍：按相同顺序取出缓存的文本
+static int _NPJSON_WriteDouble(_NPJSON_PrintCache *c, char *idx, double value)
+{
+    if (c == NPJSON_NULL || c->pos >= c->len)
+        return _NPJSON_FormatDouble(idx, value);
+    int len = (unsigned char)c->buf[c->pos];
+    memcpy(idx, c->buf + c->pos + 1, len);
+    c->pos += len + 1;
+    return len;
+}
+
+static size_t _NPJSON_StringSize(const char *str)
+{
+    return str == NPJSON_NULL ? 4 : (size_t)_NPJSON_EscapeLength(str, (int)strlen(str)) + 2;
+}
+
+static char *_NPJSON_WriteString(char *idx, const char *str)
+{
+    if (str == NPJSON_NULL) {
+        memcpy(idx, "null", 4);
+        return idx + 4;
+    }
+    int len = (int)strlen(str);
+    *idx++  = '"';
+    idx     = _NPJSON_EscapeCopy(idx, str, len, _NPJSON_EscapeLength(str, len));
+    *idx++  = '"';
+    return idx;
+}
+
+// 对象成员名称 空名称（生成时为 NULL）输出 ""
+static size_t _NPJSON_NameSize(const char *name)
+{
+    return name == NPJSON_NULL ? 2 : _NPJSON_StringSize(name);
+}
+
+static char *_NPJSON_WriteName(char *idx, const char *name)
+{
+    if (name == NPJSON_NULL) {
+        *idx++ = '"';
+        *idx++ = '"';
+        return idx;
+    }
+    return _NPJSON_WriteString(idx, name);
+}
+
+// 第一遍：计算输出长度
+static size_t _NPJSON_NodeSize(const NPJSONNode *n, _NPJSON_PrintCache *c)
+{
+    char tmp[32];
+    if (n->isPacked) {
+        size_t size = 2 + (n->Val.Packed.Count > 0 ? n->Val.Packed.Count - 1 : 0);
+        for (size_t i = 0; i < n->Val.Packed.Count; i++) {
+            size += n->isPackedInt ? _NPJSON_FormatInt(tmp, ((const int64_t *)n->Val.Packed.Data)[i])
+                                   : _NPJSON_SizeDouble(c, ((const double *)n->Val.Packed.Data)[i]);
+        }
+        return size;
+    }
+    if (n->isObject || n->isArray) {
+        size_t size = 2;
+        for (const NPJSONNode *t = n->Val.Object; t != NPJSON_NULL; t = t->next) {
+            if (t != n->Val.Object)
+                size++;
+            if (n->isObject)
+                size += _NPJSON_NameSize(t->name) + 1;
+            size += _NPJSON_NodeSize(t, c);
+        }
+        return size;
+    }
+    if (n->isString)
+        return _NPJSON_StringSize(n->Val.String);
+    if (n->isBinValue)
+        return n->Val.BinValue ? 4 : 5;
+    if (n->isRaw)
+        return n->isRawPtr ? n->Val.StrLength : strlen(n->Val.Raw);
+    if (n->isInteger)
+        return _NPJSON_FormatInt(tmp, n->Val.Value);
+    if (n->isNumber)
+        return _NPJSON_SizeDouble(c, n->Val.Number);
+    return 4;   // null
+}
+
+// 第二遍：写入
+static char *_NPJSON_NodeWrite(char *idx, const NPJSONNode *n, _NPJSON_PrintCache *c)
+{
+    if (n->isPacked) {
+        *idx++ = '[';
+        for (size_t i = 0; i < n->Val.Packed.Count; i++) {
+            if (i != 0)
+                *idx++ = ',';
+            idx += n->isPackedInt ? _NPJSON_FormatInt(idx, ((const int64_t *)n->Val.Packed.Data)[i])
+                                  : _NPJSON_WriteDouble(c, idx, ((const double *)n->Val.Packed.Data)[i]);
+        }
+        *idx++ = ']';
+        return idx;
+    }
+    if (n->isObject || n->isArray) {
+        *idx++ = n->isObject ? '{' : '[';
+        for (const NPJSONNode *t = n->Val.Object; t != NPJSON_NULL; t = t->next) {
+            if (t != n->Val.Object)
+                *idx++ = ',';
+            if (n->isObject) {
+                idx    = _NPJSON_WriteName(idx, t->name);
+                *idx++ = ':';
+            }
+            idx = _NPJSON_NodeWrite(idx, t, c);
+        }
+        *idx++ = n->isObject ? '}' : ']';
+        return idx;
+    }
+    if (n->isString)
+        return _NPJSON_WriteString(idx, n->Val.String);
+    if (n->isBinValue) {
+        memcpy(idx, n->Val.BinValue ? "true" : "false", n->Val.BinValue ? 4 : 5);
+        return idx + (n->Val.BinValue ? 4 : 5);
+    }
+    if (n->isRaw) {
+        // 原文写出
+        size_t      len;
+        const char *raw = NPJSON_GetRaw(n, &len);
+        memcpy(idx, raw, len);
+        return idx + len;
+    }
+    if (n->isInteger)
+        return idx + _NPJSON_FormatInt(idx, n->Val.Value);
+    if (n->isNumber)
+        return idx + _NPJSON_WriteDouble(c, idx, n->Val.Number);
+    memcpy(idx, "null", 4);
+    return idx + 4;
+}
+
+size_t NPJSON_PrintSize(NPJSONNode *n)
+{
+    return n == NPJSON_NULL ? 0 : _NPJSON_NodeSize(n, NPJSON_NULL);
+}
+
+size_t NPJSON_PrintTo(NPJSONNode *n, char *buf, size_t size)
+{
+    if (n == NPJSON_NULL || buf == NPJSON_NULL)
+        return 0;
+    _NPJSON_PrintCache c   = {NPJSON_NULL, 0, 0, 0, false};
+    size_t             len = _NPJSON_NodeSize(n, &c);
+    if (len + 1 <= size) {
+        _NPJSON_NodeWrite(buf, n, &c);
+        buf[len] = '\0';
+    } else
+        len = 0;
+    if (c.buf != NPJSON_NULL)
+        DELETE(c.buf);
+    return len;
+}
+
+NPJSON_SObject NPJSON_Print(NPJSONNode *n)
+{
+    NPJSON_SObject re = {NPJSON_NULL, 0, NPJSON_NULL, NPJSON_NULL};
+    if (n == NPJSON_NULL)
+        return re;
+    NPJSON_STAT_BEGIN();
+    _NPJSON_PrintCache c   = {NPJSON_NULL, 0, 0, 0, false};
+    size_t             len = _NPJSON_NodeSize(n, &c);
+    // 一次分配，无扩容
+    if (len < INT32_MAX)
+        re.str = NEW(char, len + 1);
+    if (re.str != NPJSON_NULL) {
+        _NPJSON_NodeWrite(re.str, n, &c);
+        re.str[len]  = '\0';
+        re.Strlength = (int)len;
+    }
+    if (c.buf != NPJSON_NULL)
+        DELETE(c.buf);
+    NPJSON_STAT_END(printLatency);
+    return re;
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 二进制镜像  |
+// ----------------------------------------------------------------------------------------------------
+
+#define NPJSON_IMAGE_MAGIC   0x494A504EU   // "NPJI"
+#define NPJSON_IMAGE_VERSION 1
+#define NPJSON_IMAGE_ALIGN8(x) (((x) + 7) & ~(size_t)7)
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t nodeSize;
+    uint32_t size;   // 镜像总长度
+    uint32_t root;   // 根节点偏移
+} _NPJSON_ImageHeader;
+
+typedef struct
+{
+    size_t nodes;     // 节点数量
+    size_t packed;    // 紧凑数组字节数
+    size_t strings;   // 字符串字节数（含结束符）
+} _NPJSON_ImageCount;
+
+typedef struct
+{
+    char *node;     // 下一个空闲节点
+    char *packed;   // 下一个空闲紧凑数组位置
+    char *string;   // 下一个空闲字符串位置
+} _NPJSON_ImageWriter;
+
+static void _NPJSON_ImageCountNode(const NPJSONNode *n, _NPJSON_ImageCount *c)
+{
+    for (; n != NPJSON_NULL; n = n->next) {
+        c->nodes++;
+        if (n->name != NPJSON_NULL)
+            c->strings += strlen(n->name) + 1;
+        if (n->isPacked)
+            c->packed += n->Val.Packed.Count * sizeof(int64_t);
+        else if (n->isObject || n->isArray)
+            _NPJSON_ImageCountNode(n->Val.Object, c);
+        else if (n->isString && n->Val.String != NPJSON_NULL)
+            c->strings += strlen(n->Val.String) + 1;
+    }
+}
+
+static int32_t _NPJSON_ImageOffset(const void *from, const void *to)
+{
+    return (int32_t)((const char *)to - (const char *)from);
+}
+
+static const char *_NPJSON_ImageString(_NPJSON_ImageWriter *w, const char *str, size_t *len)
+{
+    size_t l = strlen(str);
+    char * s = w->string;
+    memcpy(s, str, l + 1);
+    w->string += l + 1;
+    if (len != NPJSON_NULL)
+        *len = l;
+    return s;
+}
+
+// 兄弟节点连续存放，子节点块在所有兄弟写完后分配
+static void _NPJSON_ImageWriteNodes(_NPJSON_ImageWriter *w, const NPJSONNode *n, NPJSONImageNode *dst)
+{
+    NPJSONImageNode *d = dst;
+    for (const NPJSONNode *t = n; t != NPJSON_NULL; t = t->next, d++) {
+        memset(d, 0, sizeof(NPJSONImageNode));
+        d->flags = (t->isObject ? NPJSON_IMAGE_OBJECT : 0) |
+                   (t->isArray ? NPJSON_IMAGE_ARRAY : 0) |
+                   (t->isBinValue ? NPJSON_IMAGE_BOOL : 0) |
+                   (t->isNumber ? NPJSON_IMAGE_NUMBER : 0) |
+                   (t->isInteger ? NPJSON_IMAGE_INTEGER : 0) |
+                   (t->isString ? NPJSON_IMAGE_STRING : 0) |
+                   (t->isNull ? NPJSON_IMAGE_NULL : 0);
+        if (t->name != NPJSON_NULL)
+            d->name = _NPJSON_ImageOffset(d, _NPJSON_ImageString(w, t->name, NPJSON_NULL));
+        if (t->next != NPJSON_NULL)
+            d->next = (int32_t)sizeof(NPJSONImageNode);
+        if (t->isPacked) {
+            d->flags |= NPJSON_IMAGE_PACKED | (t->isPackedInt ? NPJSON_IMAGE_INTEGER : 0);
+            d->count  = (uint32_t)t->Val.Packed.Count;
+            d->Val.Offset = _NPJSON_ImageOffset(d, w->packed);
+            memcpy(w->packed, t->Val.Packed.Data, t->Val.Packed.Count * sizeof(int64_t));
+            w->packed += t->Val.Packed.Count * sizeof(int64_t);
+        } else if (t->isObject || t->isArray) {
+            d->count = (uint32_t)t->Val.ChildCount;
+        } else if (t->isString && t->Val.String != NPJSON_NULL) {
+            size_t l      = 0;
+            d->Val.Offset = _NPJSON_ImageOffset(d, _NPJSON_ImageString(w, t->Val.String, &l));
+            d->count      = (uint32_t)l;
+        } else if (t->isBinValue) {
+            d->Val.Value = t->Val.BinValue ? 1 : 0;
+        } else if (t->isNumber || t->isInteger) {
+            d->Val.Value  = NPJSON_GetInt(t);
+            d->Val.Number = NPJSON_GetNumber(t);
+        }
+    }
+    d = dst;
+    for (const NPJSONNode *t = n; t != NPJSON_NULL; t = t->next, d++) {
+        if (t->isPacked || !(t->isObject || t->isArray) || t->Val.Object == NPJSON_NULL)
+            continue;
+        NPJSONImageNode *child = (NPJSONImageNode *)w->node;
+        size_t           cnt   = 0;
+        for (const NPJSONNode *c = t->Val.Object; c != NPJSON_NULL; c = c->next)
+            cnt++;
+        d->count      = (uint32_t)cnt;
+        d->Val.Offset = _NPJSON_ImageOffset(d, child);
+        w->node += cnt * sizeof(NPJSONImageNode);
+        _NPJSON_ImageWriteNodes(w, t->Val.Object, child);
+    }
+}
+
+static size_t _NPJSON_ImageLayout(const NPJSONNode *root, _NPJSON_ImageCount *c)
+{
+    memset(c, 0, sizeof(_NPJSON_ImageCount));
+    c->nodes = 1;
+    _NPJSON_ImageCountNode(root->Val.Object, c);
+    size_t size = sizeof(_NPJSON_ImageHeader) + c->nodes * sizeof(NPJSONImageNode) + c->packed + c->strings;
+    size        = NPJSON_IMAGE_ALIGN8(size);
+    return size > INT32_MAX ? 0 : size;
+}
+
+size_t NPJSON_ImageSize(NPJSONNode *root)
+{
+    if (root == NPJSON_NULL || !root->isObject)
+        return 0;
+    _NPJSON_ImageCount c;
+    return _NPJSON_ImageLayout(root, &c);
+}
+
+size_t NPJSON_ImageDump(NPJSONNode *root, void *buf, size_t size)
+{
+    if (root == NPJSON_NULL || !root->isObject || buf == NPJSON_NULL || ((uintptr_t)buf & 7) != 0)
+        return 0;
+    _NPJSON_ImageCount c;
+    size_t             total = _NPJSON_ImageLayout(root, &c);
+    if (total == 0 || total > size)
+        return 0;
+    memset(buf, 0, total);
+    _NPJSON_ImageHeader *h = (_NPJSON_ImageHeader *)buf;
+    h->magic               = NPJSON_IMAGE_MAGIC;
+    h->version             = NPJSON_IMAGE_VERSION;
+    h->nodeSize            = sizeof(NPJSONImageNode);
+    h->size                = (uint32_t)total;
+    h->root                = sizeof(_NPJSON_ImageHeader);
+    // 布局：头 | 节点 | 紧凑数组 | 字符串
+    _NPJSON_ImageWriter w;
+    char *              nodes = (char *)buf + h->root;
+    w.node                    = nodes + sizeof(NPJSONImageNode);
+    w.packed                  = nodes + c.nodes * sizeof(NPJSONImageNode);
+    w.string                  = w.packed + c.packed;
+    NPJSONImageNode *r        = (NPJSONImageNode *)nodes;
+    r->flags                  = NPJSON_IMAGE_OBJECT;
+    if (root->Val.Object != NPJSON_NULL) {
+        size_t cnt = 0;
+        for (const NPJSONNode *t = root->Val.Object; t != NPJSON_NULL; t = t->next)
+            cnt++;
+        NPJSONImageNode *child = (NPJSONImageNode *)w.node;
+        r->count               = (uint32_t)cnt;
+        r->Val.Offset          = _NPJSON_ImageOffset(r, child);
+        w.node += cnt * sizeof(NPJSONImageNode);
+        _NPJSON_ImageWriteNodes(&w, root->Val.Object, child);
+    }
+    return total;
+}
+
+const NPJSONImageNode *NPJSON_ImageLoad(const void *buf, size_t size)
+{
+    const _NPJSON_ImageHeader *h = (const _NPJSON_ImageHeader *)buf;
+    if (buf == NPJSON_NULL || ((uintptr_t)buf & 7) != 0 || size < sizeof(_NPJSON_ImageHeader))
+        return NPJSON_NULL;
+    if (h->magic != NPJSON_IMAGE_MAGIC || h->version != NPJSON_IMAGE_VERSION ||
+        h->nodeSize != sizeof(NPJSONImageNode) || h->size > size ||
+        (size_t)h->root + sizeof(NPJSONImageNode) > h->size)
+        return NPJSON_NULL;
+    return (const NPJSONImageNode *)((const char *)buf + h->root);
+}
+
+static const NPJSONImageNode *_NPJSON_ImageFirst(const NPJSONImageNode *n)
+{
+    if (n == NPJSON_NULL || !(n->flags & (NPJSON_IMAGE_OBJECT | NPJSON_IMAGE_ARRAY)) ||
+        (n->flags & NPJSON_IMAGE_PACKED) || n->count == 0)
+        return NPJSON_NULL;
+    return (const NPJSONImageNode *)((const char *)n + n->Val.Offset);
+}
+
+const NPJSONImageNode *NPJSON_ImageFind(const NPJSONImageNode *n, const char *name)
+{
+    if (name == NPJSON_NULL || *name == '\0' || n == NPJSON_NULL || !(n->flags & NPJSON_IMAGE_OBJECT))
+        return NPJSON_NULL;
+    const NPJSONImageNode *t = _NPJSON_ImageFirst(n);
+    for (uint32_t i = 0; t != NPJSON_NULL && i < n->count; i++, t++) {
+        if (t->name != 0 && strcmp((const char *)t + t->name, name) == 0)
+            return t;
+    }
+    return NPJSON_NULL;
+}
+
+size_t NPJSON_ImageGetChildCount(const NPJSONImageNode *n)
+{
+    if (n == NPJSON_NULL)
+        return 0;
+    return n->flags & (NPJSON_IMAGE_OBJECT | NPJSON_IMAGE_ARRAY) ? n->count : 0;
+}
+
+const NPJSONImageNode *NPJSON_ImageGetNext(const NPJSONImageNode *n)
+{
+    if (n == NPJSON_NULL || n->next == 0)
+        return NPJSON_NULL;
+    return (const NPJSONImageNode *)((const char *)n + n->next);
+}
+
+const NPJSONImageNode *NPJSON_ImageGetChild(const NPJSONImageNode *n, size_t idx)
+{
+    const NPJSONImageNode *t = _NPJSON_ImageFirst(n);
+    return t == NPJSON_NULL || idx >= n->count ? NPJSON_NULL : t + idx;
+}
+
+const char *NPJSON_ImageGetName(const NPJSONImageNode *n)
+{
+    return n == NPJSON_NULL || n->name == 0 ? NPJSON_NULL : (const char *)n + n->name;
+}
+
+const char *NPJSON_ImageGetString(const NPJSONImageNode *n, size_t *len)
+{
+    if (n == NPJSON_NULL || !(n->flags & NPJSON_IMAGE_STRING) || n->Val.Offset == 0)
+        return NPJSON_NULL;
+    if (len != NPJSON_NULL)
+        *len = n->count;
+    return (const char *)n + n->Val.Offset;
+}
+
+const int64_t *NPJSON_ImageGetPackedInt64(const NPJSONImageNode *n, size_t *count)
+{
+    if (n == NPJSON_NULL || (n->flags & (NPJSON_IMAGE_PACKED | NPJSON_IMAGE_INTEGER)) != (NPJSON_IMAGE_PACKED | NPJSON_IMAGE_INTEGER))
+        return NPJSON_NULL;
+    if (count != NPJSON_NULL)
+        *count = n->count;
+    return (const int64_t *)((const char *)n + n->Val.Offset);
+}
+
+const double *NPJSON_ImageGetPackedDouble(const NPJSONImageNode *n, size_t *count)
+{
+    if (n == NPJSON_NULL || (n->flags & (NPJSON_IMAGE_PACKED | NPJSON_IMAGE_INTEGER)) != NPJSON_IMAGE_PACKED)
+        return NPJSON_NULL;
+    if (count != NPJSON_NULL)
+        *count = n->count;
+    return (const double *)((const char *)n + n->Val.Offset);
+}
+
+#if !defined(CFG_NPJSON_NO_MMAP) && defined(_WIN32)
+bool NPJSON_ImageOpen(const char *path, NPJSON_ImageFile *f)
+{
+    if (path == NPJSON_NULL || f == NPJSON_NULL)
+        return false;
+    memset(f, 0, sizeof(NPJSON_ImageFile));
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    HANDLE        map = NULL;
+    void *        addr = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        map = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map != NULL)
+        addr = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (map != NULL)
+        CloseHandle(map);   // 视图保持映射有效
+    CloseHandle(file);
+    if (addr == NULL)
+        return false;
+    f->root = NPJSON_ImageLoad(addr, (size_t)size.QuadPart);
+    if (f->root == NPJSON_NULL) {
+        UnmapViewOfFile(addr);
+        return false;
+    }
+    f->addr = addr;
+    f->size = (size_t)size.QuadPart;
+    return true;
+}
+
+void NPJSON_ImageClose(NPJSON_ImageFile *f)
+{
+    if (f == NPJSON_NULL || f->addr == NPJSON_NULL)
+        return;
+    UnmapViewOfFile(f->addr);
+    memset(f, 0, sizeof(NPJSON_ImageFile));
+}
+#elif !defined(CFG_NPJSON_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+bool NPJSON_ImageOpen(const char *path, NPJSON_ImageFile *f)
+{
+    if (path == NPJSON_NULL || f == NPJSON_NULL)
+        return false;
+    memset(f, 0, sizeof(NPJSON_ImageFile));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    void *      addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // 映射保持文件有效
+    if (addr == MAP_FAILED)
+        return false;
+    f->root = NPJSON_ImageLoad(addr, (size_t)st.st_size);
+    if (f->root == NPJSON_NULL) {
+        munmap(addr, (size_t)st.st_size);
+        return false;
+    }
+    f->addr = addr;
+    f->size = (size_t)st.st_size;
+    return true;
+}
+
+void NPJSON_ImageClose(NPJSON_ImageFile *f)
+{
+    if (f == NPJSON_NULL || f->addr == NPJSON_NULL)
+        return;
+    munmap(f->addr, f->size);
+    memset(f, 0, sizeof(NPJSON_ImageFile));
+}
+#else
+bool NPJSON_ImageOpen(const char *path, NPJSON_ImageFile *f)
+{
+    (void)path;
+    if (f != NPJSON_NULL)
+        memset(f, 0, sizeof(NPJSON_ImageFile));
+    return false;
+}
+
+void NPJSON_ImageClose(NPJSON_ImageFile *f)
+{
+    (void)f;
+}
+#endif
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 解析缓存  |
+// ----------------------------------------------------------------------------------------------------
+
+typedef struct _NPJSON_CacheEntry
+{
+    NPJSONNode                 root;    // 文档根节点（对外句柄）
+    uint64_t                   hash;    // 内容哈希
+    char *                     text;    // 输入副本 用于命中比较
+    size_t                     len;     // 输入长度
+    size_t                     bytes;   // 占用内存
+    int                        refs;    // 引用计数
+    bool                       packed;  // 生成选项
+    long                       proj;    // 生成选项 投影创建序号 0 表示无投影
+    int                        depth;   // 生成选项 最大嵌套深度
+    NPJSON_ScanFunc            filter;  // 生成选项 过滤
+    void *                     fctx;    // 生成选项 过滤参数
+    bool                       lazy;    // 生成选项 数值原文
+    const NPJSON_Allocator *   alloc;   // 文档分配器
+    bool                       cached;  // 是否在缓存中
+    struct _NPJSON_CacheEntry *prev;    // LRU 前驱（新）
+    struct _NPJSON_CacheEntry *next;    // LRU 后驱（旧）
+    struct _NPJSON_CacheEntry *hnext;   // 哈希链
+} _NPJSON_CacheEntry;
+
+struct _NPJSON_Cache
+{
+    _NPJSON_CacheEntry **bucket;   // 哈希桶
+    size_t               nbucket;  // 哈希桶数量（2 的幂）
+    _NPJSON_CacheEntry * head;     // 最近使用
+    _NPJSON_CacheEntry * tail;     // 最久未使用
+    size_t               budget;   // 内存预算
+    NPJSON_CacheStats    stats;
+};
+
+#define NPJSON_CACHE_ENTRY(n) ((_NPJSON_CacheEntry *)((char *)(n)-offsetof(_NPJSON_CacheEntry, root)))
+
+static uint64_t _NPJSON_Hash(const char *str, size_t len, uint64_t seed)
+{
+    const uint64_t P1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t       h  = seed ^ (len * P1);
+    for (; len >= 8; len -= 8, str += 8) {
+        uint64_t k;
+        memcpy(&k, str, 8);
+        k *= P2;
+        k = (k << 31) | (k >> 33);
+        h ^= k * P1;
+        h = ((h << 27) | (h >> 37)) * P1 + P2;
+    }
+    for (; len > 0; len--, str++) {
+        h ^= (uint8_t)*str * P1;
+        h = ((h << 11) | (h >> 53)) * P2;
+    }
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    return h;
+}
+
+static void _NPJSON_CacheFree(_NPJSON_CacheEntry *e)
+{
+    NPJSON_ReleaseEx(&e->root.Val.Object, e->alloc);
+    DELETE(e->text);
+    DELETE(e);
+}
+
+static void _NPJSON_CacheUnlink(NPJSON_Cache *c, _NPJSON_CacheEntry *e)
+{
+    if (e->prev != NPJSON_NULL)
+        e->prev->next = e->next;
+    else
+        c->head = e->next;
+    if (e->next != NPJSON_NULL)
+        e->next->prev = e->prev;
+    else
+        c->tail = e->prev;
+    e->prev = e->next = NPJSON_NULL;
+}
 
-NPJSONNode *NPJSON_GetNext(NPJSONNode *n)
+static void _NPJSON_CachePushFront(NPJSON_Cache *c, _NPJSON_CacheEntry *e)
 {
-    return n == NPJSON_NULL ? NPJSON_NULL : n->next;
+    e->prev = NPJSON_NULL;
+    e->next = c->head;
+    if (c->head != NPJSON_NULL)
+        c->head->prev = e;
+    c->head = e;
+    if (c->tail == NPJSON_NULL)
+        c->tail = e;
+}
+
+static void _NPJSON_CacheEvict(NPJSON_Cache *c, _NPJSON_CacheEntry *e)
+{
+    _NPJSON_CacheEntry **pp = &c->bucket[e->hash & (c->nbucket - 1)];
+    while (*pp != e)
+        pp = &(*pp)->hnext;
+    *pp = e->hnext;
+    _NPJSON_CacheUnlink(c, e);
+    e->cached = false;
+    c->stats.entries--;
+    c->stats.bytes -= e->bytes;
+    if (e->refs == 0)
+        _NPJSON_CacheFree(e);
+}
+
+static void _NPJSON_CacheRehash(NPJSON_Cache *c)
+{
+    size_t               n = c->nbucket * 2;
+    _NPJSON_CacheEntry **b = NEW(_NPJSON_CacheEntry *, n);
+    if (b == NPJSON_NULL)
+        return;   // 保持原哈希桶
+    memset(b, 0, n * sizeof(_NPJSON_CacheEntry *));
+    for (size_t i = 0; i < c->nbucket; i++) {
+        _NPJSON_CacheEntry *e = c->bucket[i];
+        while (e != NPJSON_NULL) {
+            _NPJSON_CacheEntry *t = e;
+            e                     = e->hnext;
+            t->hnext              = b[t->hash & (n - 1)];
+            b[t->hash & (n - 1)]  = t;
+        }
+    }
+    DELETE(c->bucket);
+    c->bucket  = b;
+    c->nbucket = n;
+}
+
+NPJSON_Cache *NPJSON_CreateCache(size_t budget)
+{
+    NPJSON_Cache *c = NEW(NPJSON_Cache, 1);
+    if (c == NPJSON_NULL)
+        return NPJSON_NULL;
+    memset(c, 0, sizeof(NPJSON_Cache));
+    c->nbucket = 16;
+    c->bucket  = NEW(_NPJSON_CacheEntry *, c->nbucket);
+    if (c->bucket == NPJSON_NULL) {
+        DELETE(c);
+        return NPJSON_NULL;
+    }
+    memset(c->bucket, 0, c->nbucket * sizeof(_NPJSON_CacheEntry *));
+    c->budget = budget;
+    return c;
+}
+
+void NPJSON_DeleteCache(NPJSON_Cache *c)
+{
+    if (c == NPJSON_NULL)
+        return;
+    while (c->tail != NPJSON_NULL)
+        _NPJSON_CacheEvict(c, c->tail);
+    DELETE(c->bucket);
+    DELETE(c);
+}
+
+NPJSONNode *NPJSON_CacheBuilder(NPJSON_Cache *c, const char *str, size_t len, const NPJSON_Option *opt, const char **err)
+{
+    if (c == NPJSON_NULL || str == NPJSON_NULL || len <= 0)
+        return NPJSON_NULL;
+    if (opt == NPJSON_NULL)
+        opt = &_DefaultOption;
+    bool     packed = opt->packed;
+    long     proj   = opt->projection == NPJSON_NULL ? 0 : opt->projection->gen;
+    uint64_t hash   = _NPJSON_Hash(str, len, packed);
+    // 选项全部相同才能共享 分配器不同的文档不能交给调用方的分配器释放
+    for (_NPJSON_CacheEntry *e = c->bucket[hash & (c->nbucket - 1)]; e != NPJSON_NULL; e = e->hnext) {
+        if (e->hash == hash && e->len == len && e->packed == packed && e->proj == proj && e->depth == opt->maxDepth &&
+            e->alloc == opt->alloc && e->filter == opt->filter && e->fctx == opt->filterCtx && e->lazy == opt->lazyNumber &&
+            memcmp(e->text, str, len) == 0) {
+            c->stats.hits++;
+            e->refs++;
+            _NPJSON_CacheUnlink(c, e);
+            _NPJSON_CachePushFront(c, e);
+            return &e->root;
+        }
+    }
+    c->stats.misses++;
+    NPJSONNode *n = NPJSON_BuilderEx(str, len, opt, err);
+    if (n == NPJSON_NULL)
+        return NPJSON_NULL;
+    _NPJSON_CacheEntry *e = NEW(_NPJSON_CacheEntry, 1);
+    char *              t = NEW(char, len);
+    if (e == NPJSON_NULL || t == NPJSON_NULL) {
+        if (e != NPJSON_NULL)
+            DELETE(e);
+        if (t != NPJSON_NULL)
+            DELETE(t);
+        NPJSON_ReleaseEx(&n, opt->alloc);
+        return NPJSON_NULL;
+    }
+    memset(e, 0, sizeof(_NPJSON_CacheEntry));
+    memcpy(t, str, len);
+    e->root = *n;
+    ADELETE(opt->alloc, n);
+    e->hash   = hash;
+    e->text   = t;
+    e->len    = len;
+    e->packed = packed;
+    e->proj   = proj;
+    e->depth  = opt->maxDepth;
+    e->filter = opt->filter;
+    e->fctx   = opt->filterCtx;
+    e->lazy   = opt->lazyNumber;
+    e->alloc  = opt->alloc;
+    e->refs   = 1;
+    // 占用内存 = 输入副本 + 节点 + 紧凑数组 + 字符串
+    _NPJSON_ImageCount cnt;
+    memset(&cnt, 0, sizeof(cnt));
+    _NPJSON_ImageCountNode(e->root.Val.Object, &cnt);
+    e->bytes = sizeof(_NPJSON_CacheEntry) + len + cnt.nodes * sizeof(NPJSONNode) + cnt.packed + cnt.strings;
+    if (e->bytes > c->budget)
+        return &e->root;   // 超过预算 不缓存 释放时删除
+    while (c->tail != NPJSON_NULL && c->stats.bytes + e->bytes > c->budget) {
+        _NPJSON_CacheEvict(c, c->tail);
+        c->stats.evictions++;
+    }
+    if (c->stats.entries >= c->nbucket)
+        _NPJSON_CacheRehash(c);
+    e->cached                          = true;
+    e->hnext                           = c->bucket[hash & (c->nbucket - 1)];
+    c->bucket[hash & (c->nbucket - 1)] = e;
+    _NPJSON_CachePushFront(c, e);
+    c->stats.entries++;
+    c->stats.bytes += e->bytes;
+    return &e->root;
+}
+
+void NPJSON_CacheRelease(NPJSONNode *n)
+{
+    if (n == NPJSON_NULL)
+        return;
+    _NPJSON_CacheEntry *e = NPJSON_CACHE_ENTRY(n);
+    if (--e->refs == 0 && !e->cached)
+        _NPJSON_CacheFree(e);
+}
+
+void NPJSON_CacheGetStats(const NPJSON_Cache *c, NPJSON_CacheStats *st)
+{
+    if (c == NPJSON_NULL || st == NPJSON_NULL)
+        return;
+    *st = c->stats;
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 缓冲池  |
+// ----------------------------------------------------------------------------------------------------
+
+#define NPJSON_POOL_MIN_SHIFT 6                                                // 最小块 64 字节
+#define NPJSON_POOL_CLASSES   15                                               // 64 字节 ~ 1M
+#define NPJSON_POOL_LARGE     NPJSON_POOL_CLASSES                              // 超过最大块 直接使用外部接口
+#define NPJSON_POOL_LOCAL     (1 << 20)                                        // 线程缓存每级上限（字节）
+#define NPJSON_POOL_DEPOT     8                                                // 全局缓存为线程缓存上限的倍数
+
+// 块头 16 字节 保持数据对齐
+typedef struct
+{
+    size_t cls;    // 尺寸级别 NPJSON_POOL_LARGE 表示大块
+    size_t size;   // 大块的数据长度
+} _NPJSON_PoolHead;
+
+typedef struct _NPJSON_PoolBlock
+{
+    struct _NPJSON_PoolBlock *next;
+} _NPJSON_PoolBlock;
+
+// 线程缓存
+typedef struct
+{
+    _NPJSON_PoolBlock *head[NPJSON_POOL_CLASSES];
+    size_t             count[NPJSON_POOL_CLASSES];
+} _NPJSON_PoolCache;
+
+// 全局缓存 线程缓存满时成批移入，空时成批取出
+typedef struct
+{
+    volatile long      lock;
+    _NPJSON_PoolBlock *head[NPJSON_POOL_CLASSES];
+    size_t             count[NPJSON_POOL_CLASSES];
+} _NPJSON_PoolDepot;
+
+static NPJSON_TLS _NPJSON_PoolCache _NPJSON_PoolLocal;
+static _NPJSON_PoolDepot            _NPJSON_Depot;
+
+#if defined(_MSC_VER)
+#define NPJSON_SPIN_TRY(v)    (_InterlockedExchange(v, 1) == 0)
+#define NPJSON_SPIN_UNLOCK(v) _InterlockedExchange(v, 0)
+#define NPJSON_PEEK(v)        (*(v))
+#define NPJSON_POKE(v, x)     (*(v) = (x))
+#elif defined(__GNUC__) || defined(__clang__)
+#define NPJSON_SPIN_TRY(v)    (__atomic_exchange_n(v, 1, __ATOMIC_ACQUIRE) == 0)
+#define NPJSON_SPIN_UNLOCK(v) __atomic_store_n(v, 0, __ATOMIC_RELEASE)
+#define NPJSON_PEEK(v)        __atomic_load_n(v, __ATOMIC_RELAXED)
+#define NPJSON_POKE(v, x)     __atomic_store_n(v, x, __ATOMIC_RELAXED)
+#else
+#define NPJSON_SPIN_TRY(v)    (*(v) == 0 ? (*(v) = 1, true) : false)   // 无原子操作时仅限单线程
+#define NPJSON_SPIN_UNLOCK(v) (*(v) = 0)
+#define NPJSON_PEEK(v)        (*(v))
+#define NPJSON_POKE(v, x)     (*(v) = (x))
+#endif
+
+static void _NPJSON_DepotLock(void)
+{
+    while (!NPJSON_SPIN_TRY(&_NPJSON_Depot.lock)) {
+        while (NPJSON_PEEK(&_NPJSON_Depot.lock) != 0)
+            ;
+    }
+}
+
+static size_t _NPJSON_PoolClass(size_t size)
+{
+    size_t cls = 0;
+    while (cls < NPJSON_POOL_CLASSES && ((size_t)1 << (cls + NPJSON_POOL_MIN_SHIFT)) < size)
+        cls++;
+    return cls;
+}
+
+// 每级线程缓存块数上限
+static size_t _NPJSON_PoolLimit(size_t cls)
+{
+    size_t n = NPJSON_POOL_LOCAL >> (cls + NPJSON_POOL_MIN_SHIFT);
+    return n > 256 ? 256 : n;
+}
+
+static void *_NPJSON_PoolMalloc(void *ctx, size_t size)
+{
+    (void)ctx;
+    size_t            cls = _NPJSON_PoolClass(size);
+    _NPJSON_PoolHead *h;
+    if (cls == NPJSON_POOL_LARGE) {
+        h = (_NPJSON_PoolHead *)NPJSON_Malloc(sizeof(_NPJSON_PoolHead) + size);
+        if (h == NPJSON_NULL)
+            return NPJSON_NULL;
+        h->size = size;
+    } else {
+        _NPJSON_PoolCache *c = &_NPJSON_PoolLocal;
+        if (c->head[cls] == NPJSON_NULL && NPJSON_PEEK(&_NPJSON_Depot.head[cls]) != NPJSON_NULL) {
+            // 从全局缓存取回一批 锁外只读作提示
+            size_t half = _NPJSON_PoolLimit(cls) / 2 + 1;
+            _NPJSON_DepotLock();
+            while (_NPJSON_Depot.head[cls] != NPJSON_NULL && c->count[cls] < half) {
+                _NPJSON_PoolBlock *b     = _NPJSON_Depot.head[cls];
+                NPJSON_POKE(&_NPJSON_Depot.head[cls], b->next);
+                _NPJSON_Depot.count[cls]--;
+                b->next        = c->head[cls];
+                c->head[cls]   = b;
+                c->count[cls]++;
+            }
+            NPJSON_SPIN_UNLOCK(&_NPJSON_Depot.lock);
+        }
+        if (c->head[cls] != NPJSON_NULL) {
+            _NPJSON_PoolBlock *b = c->head[cls];
+            c->head[cls]         = b->next;
+            c->count[cls]--;
+            h = (_NPJSON_PoolHead *)b - 1;
+        } else {
+            h = (_NPJSON_PoolHead *)NPJSON_Malloc(sizeof(_NPJSON_PoolHead) + ((size_t)1 << (cls + NPJSON_POOL_MIN_SHIFT)));
+            if (h == NPJSON_NULL)
+                return NPJSON_NULL;
+        }
+        h->size = 0;
+    }
+    h->cls = cls;
+    return h + 1;
+}
+
+static void _NPJSON_PoolFree(void *ctx, void *ptr)
+{
+    (void)ctx;
+    if (ptr == NPJSON_NULL)
+        return;
+    _NPJSON_PoolHead *h   = (_NPJSON_PoolHead *)ptr - 1;
+    size_t            cls = h->cls;
+    if (cls == NPJSON_POOL_LARGE) {
+        NPJSON_Free(h);
+        return;
+    }
+    _NPJSON_PoolCache *c     = &_NPJSON_PoolLocal;
+    _NPJSON_PoolBlock *b     = (_NPJSON_PoolBlock *)ptr;
+    size_t             limit = _NPJSON_PoolLimit(cls);
+    b->next                  = c->head[cls];
+    c->head[cls]             = b;
+    if (++c->count[cls] <= limit)
+        return;
+    // 线程缓存已满 一半移入全局缓存，全局缓存也满时归还外部接口
+    _NPJSON_PoolBlock *spill = NPJSON_NULL;
+    _NPJSON_DepotLock();
+    while (c->count[cls] > limit / 2) {
+        b            = c->head[cls];
+        c->head[cls] = b->next;
+        c->count[cls]--;
+        if (_NPJSON_Depot.count[cls] < limit * NPJSON_POOL_DEPOT) {
+            b->next                 = _NPJSON_Depot.head[cls];
+            NPJSON_POKE(&_NPJSON_Depot.head[cls], b);
+            _NPJSON_Depot.count[cls]++;
+        } else {
+            b->next = spill;
+            spill   = b;
+        }
+    }
+    NPJSON_SPIN_UNLOCK(&_NPJSON_Depot.lock);
+    while (spill != NPJSON_NULL) {
+        b     = spill;
+        spill = spill->next;
+        NPJSON_Free((_NPJSON_PoolHead *)b - 1);
+    }
+}
+
+static void *_NPJSON_PoolRealloc(void *ctx, void *ptr, size_t size)
+{
+    if (ptr == NPJSON_NULL)
+        return _NPJSON_PoolMalloc(ctx, size);
+    _NPJSON_PoolHead *h = (_NPJSON_PoolHead *)ptr - 1;
+    size_t            cap;
+    if (h->cls == NPJSON_POOL_LARGE) {
+        if (_NPJSON_PoolClass(size) == NPJSON_POOL_LARGE) {
+            h = (_NPJSON_PoolHead *)NPJSON_Realloc(h, sizeof(_NPJSON_PoolHead) + size);
+            if (h == NPJSON_NULL)
+                return NPJSON_NULL;
+            h->size = size;
+            return h + 1;
+        }
+        cap = h->size;
+    } else {
+        cap = (size_t)1 << (h->cls + NPJSON_POOL_MIN_SHIFT);
+        if (size <= cap)
+            return ptr;   // 块内仍有空间 不移动
+    }
+    void *tmp = _NPJSON_PoolMalloc(ctx, size);
+    if (tmp == NPJSON_NULL)
+        return NPJSON_NULL;
+    memcpy(tmp, ptr, cap < size ? cap : size);
+    _NPJSON_PoolFree(ctx, ptr);
+    return tmp;
+}
+
+static const NPJSON_Allocator _NPJSON_PoolAllocator = {
+    _NPJSON_PoolMalloc,
+    _NPJSON_PoolFree,
+    _NPJSON_PoolRealloc,
+    NPJSON_NULL,
+};
+
+const NPJSON_Allocator *NPJSON_PoolAllocator(void)
+{
+    return &_NPJSON_PoolAllocator;
+}
+
+size_t NPJSON_PoolTrim(void)
+{
+    size_t             bytes = 0;
+    _NPJSON_PoolBlock *list  = NPJSON_NULL;
+    _NPJSON_PoolCache *c     = &_NPJSON_PoolLocal;
+    _NPJSON_DepotLock();
+    for (size_t cls = 0; cls < NPJSON_POOL_CLASSES; cls++) {
+        // 线程缓存与全局缓存合并后在锁外释放
+        _NPJSON_PoolBlock *heads[2] = {c->head[cls], _NPJSON_Depot.head[cls]};
+        bytes += (c->count[cls] + _NPJSON_Depot.count[cls]) << (cls + NPJSON_POOL_MIN_SHIFT);
+        c->head[cls] = NPJSON_NULL;
+        NPJSON_POKE(&_NPJSON_Depot.head[cls], NPJSON_NULL);
+        c->count[cls] = _NPJSON_Depot.count[cls] = 0;
+        for (int i = 0; i < 2; i++) {
+            while (heads[i] != NPJSON_NULL) {
+                _NPJSON_PoolBlock *b = heads[i];
+                heads[i]             = b->next;
+                b->next              = list;
+                list                 = b;
+            }
+        }
+    }
+    NPJSON_SPIN_UNLOCK(&_NPJSON_Depot.lock);
+    while (list != NPJSON_NULL) {
+        _NPJSON_PoolBlock *b = list;
+        list                 = list->next;
+        NPJSON_Free((_NPJSON_PoolHead *)b - 1);
+    }
+    return bytes;
+}
+
+void NPJSON_PoolFlush(void)
+{
+    _NPJSON_PoolBlock *spill = NPJSON_NULL;
+    _NPJSON_PoolCache *c     = &_NPJSON_PoolLocal;
+    size_t             cls;
+    for (cls = 0; cls < NPJSON_POOL_CLASSES && c->count[cls] == 0; cls++)
+        ;
+    if (cls == NPJSON_POOL_CLASSES)
+        return;
+    _NPJSON_DepotLock();
+    for (cls = 0; cls < NPJSON_POOL_CLASSES; cls++) {
+        size_t limit = _NPJSON_PoolLimit(cls) * NPJSON_POOL_DEPOT;
+        while (c->head[cls] != NPJSON_NULL) {
+            _NPJSON_PoolBlock *b = c->head[cls];
+            c->head[cls]         = b->next;
+            if (_NPJSON_Depot.count[cls] < limit) {
+                b->next = _NPJSON_Depot.head[cls];
+                NPJSON_POKE(&_NPJSON_Depot.head[cls], b);
+                _NPJSON_Depot.count[cls]++;
+            } else {
+                b->next = spill;
+                spill   = b;
+            }
+        }
+        c->count[cls] = 0;
+    }
+    NPJSON_SPIN_UNLOCK(&_NPJSON_Depot.lock);
+    while (spill != NPJSON_NULL) {
+        _NPJSON_PoolBlock *b = spill;
+        spill                = spill->next;
+        NPJSON_Free((_NPJSON_PoolHead *)b - 1);
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | JSON 模板  |
+// ----------------------------------------------------------------------------------------------------
+
+#define NPJSON_TEMPLATE_CACHE 16   // 渲染时缓存字符串长度的值槽数
+#define NPJSON_TEMPLATE_PAD   16   // 短静态文本按定长复制，文本与输出各预留的长度
+
+typedef struct
+{
+    int  pos;    // 在模板文本中的位置（%x 已替换为 " 0"）
+    char type;   // d l f b s r
+} _NPJSON_TemplateSlot;
+
+struct _NPJSON_Template
+{
+    const NPJSON_Allocator *alloc;
+    char *                  text;      // 模板文本
+    int                     length;
+    _NPJSON_TemplateSlot *  slot;
+    int                     count;
+    int                     strings;   // 字符串值槽数量（%s %r）
+    size_t                  bound;     // 静态文本与定长值槽的最大输出长度（含 NPJSON_TEMPLATE_PAD）
+};
+
+typedef struct
+{
+    int len;   // 原长度
+    int esc;   // 转义后长度
+} _NPJSON_TemplateLen;
+
+// 定长值槽最大输出长度 字符串值槽按实际长度计算
+static int _NPJSON_TemplateBound(char type)
+{
+    switch (type) {
+        case 'd':
+            return 11;
+        case 'l':
+            return 20;
+        case 'f':
+            return 24;
+        case 'b':
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+// 查找字符串外的值槽 slot 不为 NULL 时记录位置并把 %x 替换为 " 0"
+static int _NPJSON_TemplateSlots(char *text, _NPJSON_TemplateSlot *slot, const char **at)
+{
+    int  count = 0;
+    bool str   = false;
+    for (char *p = text; *p != '\0'; p++) {
+        if (str) {
+            if (*p == '\\' && p[1] != '\0')
+                p++;
+            else if (*p == '\"')
+                str = false;
+        } else if (*p == '\"')
+            str = true;
+        else if (*p == '%') {
+            if (p[1] == '\0' || strchr("dlfbsr", p[1]) == NPJSON_NULL) {
+                *at = p;
+                return -1;
+            }
+            if (slot != NPJSON_NULL) {
+                slot[count].pos  = p - text;
+                slot[count].type = p[1];
+                p[0]             = ' ';
+                p[1]             = '0';
+            }
+            count++;
+            p++;
+        }
+    }
+    return count;
+}
+
+NPJSON_Template *NPJSON_CompileTemplateEx(const char *tpl, const NPJSON_Allocator *alloc, const char **err)
+{
+    const char *at = tpl;
+    if (tpl == NPJSON_NULL) {
+        if (err != NPJSON_NULL)
+            *err = NPJSON_NULL;
+        return NPJSON_NULL;
+    }
+    size_t len   = strlen(tpl);
+    int    count = _NPJSON_TemplateSlots((char *)tpl, NPJSON_NULL, &at);
+    if (count < 0 || len >= INT32_MAX) {
+        if (err != NPJSON_NULL)
+            *err = at;
+        return NPJSON_NULL;
+    }
+    // 一次分配：模板、值槽、文本
+    size_t           head = sizeof(NPJSON_Template) + sizeof(_NPJSON_TemplateSlot) * count;
+    NPJSON_Template *t    = (NPJSON_Template *)ANEW(alloc, char, head + len + 1 + NPJSON_TEMPLATE_PAD);
+    if (t == NPJSON_NULL) {
+        if (err != NPJSON_NULL)
+            *err = NPJSON_NULL;
+        return NPJSON_NULL;
+    }
+    t->alloc   = alloc;
+    t->slot    = (_NPJSON_TemplateSlot *)(t + 1);
+    t->text    = (char *)t + head;
+    t->length  = (int)len;
+    t->count   = count;
+    t->strings = 0;
+    memcpy(t->text, tpl, len + 1);
+    memset(t->text + len + 1, 0, NPJSON_TEMPLATE_PAD);
+    _NPJSON_TemplateSlots(t->text, t->slot, &at);
+    // 值槽替换为 0 后必须是合法 JSON，长度不变，错误位置与模板一一对应
+    if (!NPJSON_Validate(t->text, len, &at)) {
+        if (err != NPJSON_NULL)
+            *err = at != NPJSON_NULL ? tpl + (at - t->text) : NPJSON_NULL;
+        ADELETE(alloc, t);
+        return NPJSON_NULL;
+    }
+    t->bound = len - 2 * (size_t)count + NPJSON_TEMPLATE_PAD;
+    for (int i = 0; i < count; i++) {
+        t->bound += _NPJSON_TemplateBound(t->slot[i].type);
+        t->strings += _NPJSON_TemplateBound(t->slot[i].type) == 0;
+    }
+    return t;
+}
+
+NPJSON_Template *NPJSON_CompileTemplate(const char *tpl, const char **err)
+{
+    return NPJSON_CompileTemplateEx(tpl, NPJSON_NULL, err);
+}
+
+void NPJSON_DeleteTemplate(NPJSON_Template *t)
+{
+    if (t != NPJSON_NULL)
+        ADELETE(t->alloc, t);
+}
+
+// 计算输出长度上限 前 NPJSON_TEMPLATE_CACHE 个字符串值槽的长度记入 cache
+static size_t _NPJSON_TemplateSize(const NPJSON_Template *t, va_list ap, _NPJSON_TemplateLen *cache)
+{
+    size_t size = t->bound;
+    int    k    = 0;
+    if (t->strings == 0)
+        return size;
+    for (int i = 0; i < t->count; i++) {
+        char type = t->slot[i].type;
+        if (type == 'd' || type == 'b')
+            (void)va_arg(ap, int);
+        else if (type == 'l')
+            (void)va_arg(ap, long long);
+        else if (type == 'f')
+            (void)va_arg(ap, double);
+        else {
+            const char *v = va_arg(ap, const char *);
+            size_t      len;
+            int         esc;
+            if (v == NPJSON_NULL) {
+                size += 4;
+                k++;
+                continue;
+            }
+            len = strlen(v);
+            if (len >= INT32_MAX)
+                return (size_t)-1;
+            esc = type == 's' ? _NPJSON_EscapeLength(v, (int)len) : (int)len;
+            size += type == 's' ? (size_t)esc + 2 : len;
+            if (k < NPJSON_TEMPLATE_CACHE) {
+                cache[k].len = (int)len;
+                cache[k].esc = esc;
+            }
+            k++;
+        }
+    }
+    return size;
+}
+
+// 写入实例 静态文本成块复制，只格式化值 空间已由调用者保证
+static char *_NPJSON_TemplateWrite(const NPJSON_Template *t, char *idx, va_list ap, const _NPJSON_TemplateLen *cache)
+{
+    int prev = 0;
+    int k    = 0;
+    for (int i = 0; i < t->count; i++) {
+        const _NPJSON_TemplateSlot *s = &t->slot[i];
+        // 值槽之间的静态文本通常很短，定长复制避免调用 memcpy，多写的部分由后续内容覆盖
+        if (s->pos - prev <= NPJSON_TEMPLATE_PAD)
+            memcpy(idx, t->text + prev, NPJSON_TEMPLATE_PAD);
+        else
+            memcpy(idx, t->text + prev, s->pos - prev);
+        idx += s->pos - prev;
+        prev = s->pos + 2;
+        switch (s->type) {
+            case 'd':
+                idx += _NPJSON_FormatInt(idx, va_arg(ap, int));
+                break;
+            case 'l':
+                idx += _NPJSON_FormatInt(idx, va_arg(ap, long long));
+                break;
+            case 'f':
+                idx += _NPJSON_FormatNumber(idx, 24, va_arg(ap, double));
+                break;
+            case 'b':
+                if (va_arg(ap, int)) {
+                    memcpy(idx, "true", 4);
+                    idx += 4;
+                } else {
+                    memcpy(idx, "false", 5);
+                    idx += 5;
+                }
+                break;
+            default: {
+                const char *v = va_arg(ap, const char *);
+                int         len, esc;
+                if (v == NPJSON_NULL) {
+                    memcpy(idx, "null", 4);
+                    idx += 4;
+                    k++;
+                    break;
+                }
+                if (k < NPJSON_TEMPLATE_CACHE) {
+                    len = cache[k].len;
+                    esc = cache[k].esc;
+                } else {
+                    len = strlen(v);
+                    esc = s->type == 's' ? _NPJSON_EscapeLength(v, len) : len;
+                }
+                k++;
+                if (s->type == 's') {
+                    *idx++ = '\"';
+                    idx    = _NPJSON_EscapeCopy(idx, v, len, esc);
+                    *idx++ = '\"';
+                } else {
+                    memcpy(idx, v, len);
+                    idx += len;
+                }
+                break;
+            }
+        }
+    }
+    memcpy(idx, t->text + prev, t->length - prev);
+    return idx + (t->length - prev);
+}
+
+size_t NPJSON_TemplateSize(const NPJSON_Template *t, ...)
+{
+    _NPJSON_TemplateLen cache[NPJSON_TEMPLATE_CACHE];
+    va_list             ap;
+    size_t              size;
+    if (t == NPJSON_NULL)
+        return 0;
+    va_start(ap, t);
+    size = _NPJSON_TemplateSize(t, ap, cache);
+    va_end(ap);
+    return size;
+}
+
+size_t NPJSON_TemplateRenderTo(const NPJSON_Template *t, char *buf, size_t size, ...)
+{
+    _NPJSON_TemplateLen cache[NPJSON_TEMPLATE_CACHE];
+    va_list             ap, cp;
+    if (t == NPJSON_NULL || buf == NPJSON_NULL)
+        return 0;
+    va_start(ap, size);
+    va_copy(cp, ap);
+    size_t bound = _NPJSON_TemplateSize(t, cp, cache);
+    va_end(cp);
+    size_t len = 0;
+    // 只检查一次空间
+    if (bound < size) {
+        len      = _NPJSON_TemplateWrite(t, buf, ap, cache) - buf;
+        buf[len] = '\0';
+    }
+    va_end(ap);
+    return len;
+}
+
+NPJSON_SObject NPJSON_TemplateRender(const NPJSON_Template *t, ...)
+{
+    _NPJSON_TemplateLen cache[NPJSON_TEMPLATE_CACHE];
+    NPJSON_SObject      re = {NPJSON_NULL, 0, NPJSON_NULL, NPJSON_NULL};
+    va_list             ap, cp;
+    if (t == NPJSON_NULL)
+        return re;
+    re.alloc = t->alloc;
+    va_start(ap, t);
+    va_copy(cp, ap);
+    size_t bound = _NPJSON_TemplateSize(t, cp, cache);
+    va_end(cp);
+    // 按上限一次分配，无扩容
+    if (bound < INT32_MAX)
+        re.str = ANEW(t->alloc, char, bound + 1);
+    if (re.str != NPJSON_NULL) {
+        re.Strlength         = _NPJSON_TemplateWrite(t, re.str, ap, cache) - re.str;
+        re.str[re.Strlength] = '\0';
+    }
+    va_end(ap);
+    return re;
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 并行序列化  |
+// ----------------------------------------------------------------------------------------------------
+
+#define NPJSON_PARALLEL_CHUNK   1024        // 每块最多记录数
+#define NPJSON_PARALLEL_SLOTS   4           // 每轮每线程块数
+#define NPJSON_PARALLEL_BUFFER  (64 * 1024) // 工作合成器初始大小
+#define NPJSON_PARALLEL_THREADS 64          // 最大线程数
+
+#if defined(NPJSON_THREAD)
+typedef struct
+{
+    NPJSON_Synthesizer sn;   // 工作合成器 不带根对象 各轮复用
+    size_t             begin;
+    size_t             end;
+} _NPJSON_ParallelChunk;
+
+typedef struct
+{
+    const char *            records;
+    size_t                  stride;
+    NPJSON_RecordFunc       fun;
+    void *                  ctx;
+    const NPJSON_Allocator *alloc;
+    _NPJSON_ParallelChunk * chunk;
+    long                    chunks;   // 本轮块数
+    volatile long           next;     // 下一个待处理块
+    volatile long           failed;
+} _NPJSON_ParallelJob;
+
+// 工作线程：按块领取记录，块内顺序写入独立合成器
+static void _NPJSON_ParallelRun(_NPJSON_ParallelJob *job)
+{
+    long i;
+    while ((i = NPJSON_ATOMIC_INC(&job->next) - 1) < job->chunks && NPJSON_PEEK(&job->failed) == 0) {
+        _NPJSON_ParallelChunk *c  = &job->chunk[i];
+        NPJSON_Synthesizer *   sn = &c->sn;
+        if (sn->str == NPJSON_NULL) {
+            *sn = NPJSON_CreateSynthesizerEx(NPJSON_PARALLEL_BUFFER, job->alloc);
+            if (sn->str == NPJSON_NULL) {
+                NPJSON_ATOMIC_INC(&job->failed);
+                return;
+            }
+        }
+        sn->idx   = sn->str;
+        sn->comma = false;
+        for (size_t r = c->begin; r < c->end; r++) {
+            if (!job->fun(sn, job->records + r * job->stride, r, job->ctx)) {
+                NPJSON_ATOMIC_INC(&job->failed);
+                return;
+            }
+        }
+    }
+}
+
+#if defined(NPJSON_THREAD_WIN32)
+typedef SRWLOCK            _NPJSON_Mutex;
+typedef CONDITION_VARIABLE _NPJSON_Cond;
+#define NPJSON_MUTEX_INIT         SRWLOCK_INIT
+#define NPJSON_COND_INIT          CONDITION_VARIABLE_INIT
+#define NPJSON_MUTEX_LOCK(m)      AcquireSRWLockExclusive(m)
+#define NPJSON_MUTEX_UNLOCK(m)    ReleaseSRWLockExclusive(m)
+#define NPJSON_COND_WAIT(c, m)    SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define NPJSON_COND_BROADCAST(c)  WakeAllConditionVariable(c)
+#else
+typedef pthread_mutex_t _NPJSON_Mutex;
+typedef pthread_cond_t  _NPJSON_Cond;
+#define NPJSON_MUTEX_INIT         PTHREAD_MUTEX_INITIALIZER
+#define NPJSON_COND_INIT          PTHREAD_COND_INITIALIZER
+#define NPJSON_MUTEX_LOCK(m)      pthread_mutex_lock(m)
+#define NPJSON_MUTEX_UNLOCK(m)    pthread_mutex_unlock(m)
+#define NPJSON_COND_WAIT(c, m)    pthread_cond_wait(c, m)
+#define NPJSON_COND_BROADCAST(c)  pthread_cond_broadcast(c)
+#endif
+
+// 常驻工作线程 首次使用时创建，之后各次调用复用
+typedef struct
+{
+    _NPJSON_Mutex        lock;
+    _NPJSON_Cond         wake;     // 开始新一轮
+    _NPJSON_Cond         done;     // 本轮参与的线程全部完成
+    volatile long        busy;     // 已被某次调用占用 同时调用时后来者在调用线程中执行
+    int                  count;    // 已创建的线程数
+    int                  want;     // 本轮参与的线程数（编号小于 want 的线程）
+    int                  active;   // 本轮尚未完成的线程数
+    unsigned long        gen;      // 轮次
+    _NPJSON_ParallelJob *job;
+} _NPJSON_Workers;
+
+static _NPJSON_Workers _NPJSON_Worker = {NPJSON_MUTEX_INIT, NPJSON_COND_INIT, NPJSON_COND_INIT, 0, 0, 0, 0, 0, NPJSON_NULL};
+
+static void _NPJSON_WorkerLoop(int id)
+{
+    _NPJSON_Workers *w    = &_NPJSON_Worker;
+    unsigned long    seen = 0;
+    NPJSON_MUTEX_LOCK(&w->lock);
+    for (;;) {
+        while (w->gen == seen)
+            NPJSON_COND_WAIT(&w->wake, &w->lock);
+        seen = w->gen;
+        if (id >= w->want)
+            continue;
+        _NPJSON_ParallelJob *job = w->job;
+        NPJSON_MUTEX_UNLOCK(&w->lock);
+        _NPJSON_ParallelRun(job);
+        // 线程常驻 释放到线程缓存的块归还全局缓存，NPJSON_PoolTrim 可以回收
+        NPJSON_PoolFlush();
+        NPJSON_MUTEX_LOCK(&w->lock);
+        if (--w->active == 0)
+            NPJSON_COND_BROADCAST(&w->done);
+    }
+}
+
+#if defined(NPJSON_THREAD_WIN32)
+static DWORD WINAPI _NPJSON_WorkerThread(LPVOID arg)
+{
+    _NPJSON_WorkerLoop((int)(intptr_t)arg);
+    return 0;
+}
+
+static bool _NPJSON_ThreadStart(int id)
+{
+    HANDLE t = CreateThread(NPJSON_NULL, 0, _NPJSON_WorkerThread, (LPVOID)(intptr_t)id, 0, NPJSON_NULL);
+    if (t == NPJSON_NULL)
+        return false;
+    CloseHandle(t);
+    return true;
+}
+#else
+static void *_NPJSON_WorkerThread(void *arg)
+{
+    _NPJSON_WorkerLoop((int)(intptr_t)arg);
+    return NPJSON_NULL;
+}
+
+static bool _NPJSON_ThreadStart(int id)
+{
+    pthread_t t;
+    if (pthread_create(&t, NPJSON_NULL, _NPJSON_WorkerThread, (void *)(intptr_t)id) != 0)
+        return false;
+    pthread_detach(t);
+    return true;
+}
+#endif
+
+// 开始一轮 线程不足时补充创建 返回参与的线程数（创建失败时由已有线程完成）
+static int _NPJSON_WorkerStart(_NPJSON_ParallelJob *job, int want)
+{
+    _NPJSON_Workers *w = &_NPJSON_Worker;
+    NPJSON_MUTEX_LOCK(&w->lock);
+    while (w->count < want && _NPJSON_ThreadStart(w->count))
+        w->count++;
+    if (want > w->count)
+        want = w->count;
+    w->job    = job;
+    w->want   = want;
+    w->active = want;
+    w->gen++;
+    NPJSON_COND_BROADCAST(&w->wake);
+    NPJSON_MUTEX_UNLOCK(&w->lock);
+    return want;
+}
+
+// 等待本轮参与的线程全部完成
+static void _NPJSON_WorkerWait(void)
+{
+    _NPJSON_Workers *w = &_NPJSON_Worker;
+    NPJSON_MUTEX_LOCK(&w->lock);
+    while (w->active > 0)
+        NPJSON_COND_WAIT(&w->done, &w->lock);
+    NPJSON_MUTEX_UNLOCK(&w->lock);
+}
+
+// 按块顺序把本轮结果写入目标合成器 先检查一次总长度
+static bool _NPJSON_ParallelJoin(NPJSON_Synthesizer *sn, const _NPJSON_ParallelJob *job)
+{
+    long long total = 0;
+    for (long i = 0; i < job->chunks; i++)
+        total += (job->chunk[i].sn.idx - job->chunk[i].sn.str) + 1;
+    if (total > 0x7FFFFFFF || (sn->sink == NPJSON_NULL && !_NPJSON_CheckCacheSize(sn, (int)total)))
+        return false;
+    for (long i = 0; i < job->chunks; i++) {
+        const NPJSON_Synthesizer *c = &job->chunk[i].sn;
+        int                       n = c->idx - c->str;
+        if (n == 0)
+            continue;
+        if (sn->comma && !_NPJSON_Write(sn, ",", 1))
+            return false;
+        if (!_NPJSON_Write(sn, c->str, n))
+            return false;
+        sn->comma = true;
+    }
+    return true;
+}
+#endif
+
+bool NPJSON_AddArrayParallel(NPJSON_Synthesizer *sn, const char *name, const void *records, size_t count, size_t stride, NPJSON_RecordFunc fun,
+                             void *ctx, int threads)
+{
+    _NPJSON_Key k = _NPJSON_NameKey(name);
+    if (sn == NPJSON_NULL || fun == NPJSON_NULL || (records == NPJSON_NULL && count > 0))
+        return false;
+    if (!_NPJSON_KeyStart(sn, &k, '['))
+        return false;
+#if defined(NPJSON_THREAD)
+    if (threads > NPJSON_PARALLEL_THREADS)
+        threads = NPJSON_PARALLEL_THREADS;
+    if (threads > 1 && count > 1) {
+        _NPJSON_ParallelJob job;
+        size_t              slots = (size_t)threads * NPJSON_PARALLEL_SLOTS;
+        size_t              per   = (count + slots - 1) / slots;
+        bool                flag  = true;
+        if (per > NPJSON_PARALLEL_CHUNK)
+            per = NPJSON_PARALLEL_CHUNK;
+        job.records = (const char *)records;
+        job.stride  = stride;
+        job.fun     = fun;
+        job.ctx     = ctx;
+        job.alloc   = sn->alloc;
+        job.failed  = 0;
+        job.chunk   = ANEW(sn->alloc, _NPJSON_ParallelChunk, slots);
+        if (job.chunk == NPJSON_NULL)
+            return false;
+        memset(job.chunk, 0, sizeof(_NPJSON_ParallelChunk) * slots);
+        // 工作线程已被占用（其他线程同时调用或回调中嵌套调用）时只用调用线程
+        bool own = NPJSON_SPIN_TRY(&_NPJSON_Worker.busy);
+        // 按轮处理，内存占用为一轮的输出
+        for (size_t base = 0; flag && base < count; base += per * slots) {
+            job.chunks = 0;
+            job.next   = 0;
+            for (size_t r = base; r < count && (size_t)job.chunks < slots; r += per) {
+                job.chunk[job.chunks].begin = r;
+                job.chunk[job.chunks].end   = r + per < count ? r + per : count;
+                job.chunks++;
+            }
+            // 调用线程也参与
+            int want = threads - 1;
+            if (want > job.chunks - 1)
+                want = (int)job.chunks - 1;
+            int started = own && want > 0 ? _NPJSON_WorkerStart(&job, want) : 0;
+            _NPJSON_ParallelRun(&job);
+            if (started > 0)
+                _NPJSON_WorkerWait();
+            flag = job.failed == 0 && _NPJSON_ParallelJoin(sn, &job);
+        }
+        if (own)
+            NPJSON_SPIN_UNLOCK(&_NPJSON_Worker.busy);
+        for (size_t i = 0; i < slots; i++)
+            NPJSON_DeleteSynthesizer(&job.chunk[i].sn);
+        ADELETE(sn->alloc, job.chunk);
+        return flag && _NPJSON_EndArray(sn);
+    }
+#else
+    (void)threads;
+#endif
+    // 单线程直接写入目标合成器
+    for (size_t i = 0; i < count; i++) {
+        if (!fun(sn, (const char *)records + i * stride, i, ctx))
+            return false;
+    }
+    return _NPJSON_EndArray(sn);
 }
@@ -42,6 +42,31 @@
  * <tr><td>2023-03-14 <td>1.10    <td>CXS    <td>修正解析遇到结束}就返回错误
  * <tr><td>2023-03-24 <td>1.11    <td>CXS    <td>添加接口NPJSON_SetInter
  * <tr><td>2024-07-23 <td>1.12    <td>CXS    <td>完善宏处理
+ * <tr><td>2026-10-18 <td>1.13    <td>CXS    <td>添加流式输出合成器;逗号改为前置处理
+ * <tr><td>2026-10-18 <td>1.14    <td>CXS    <td>合成器名称、字符串值转义，向量化扫描
+ * <tr><td>2026-10-18 <td>1.15    <td>CXS    <td>支持\uXXXX解码、UTF-8校验;修正字符串中括号、逗号、转义引号解析错误
+ * <tr><td>2026-10-18 <td>1.16    <td>CXS    <td>添加JSON压缩、美化
+ * <tr><td>2026-10-18 <td>1.17    <td>CXS    <td>序列化宏使用编译期生成的名称前缀;修正NPJSON_Object_Start(NULL)生成"NULL"名称
+ * <tr><td>2026-10-18 <td>1.18    <td>CXS    <td>添加整型、浮点、二值量、字符串数组批量生成
+ * <tr><td>2026-10-18 <td>1.19    <td>CXS    <td>添加NPJSON_BuilderEx，数值数组紧凑存储;修正NPJSON_Release数组内存泄漏
+ * <tr><td>2026-10-18 <td>1.20    <td>CXS    <td>添加二进制镜像 NPJSON_ImageDump/NPJSON_ImageOpen，免解析加载
+ * <tr><td>2026-10-18 <td>1.21    <td>CXS    <td>添加解析缓存 NPJSON_CacheBuilder，按内容哈希共享文档
+ * <tr><td>2026-10-18 <td>1.22    <td>CXS    <td>添加文档插入、替换、删除;添加NPJSON_Print一次分配输出
+ * <tr><td>2026-10-18 <td>1.23    <td>CXS    <td>添加引用计数共享缓存，共享对象克隆、子对象转安全对象不复制
+ * <tr><td>2026-10-18 <td>1.24    <td>CXS    <td>添加NPJSON_Allocator，解析、生成、合成器可指定分配器
+ * <tr><td>2026-10-18 <td>1.25    <td>CXS    <td>添加CMake构建及吞吐量测试 bench/npjson_bench.c
+ * <tr><td>2026-10-18 <td>1.26    <td>CXS    <td>添加运行统计 NPJSON_GetStats（CFG_NPJSON_STATS）
+ * <tr><td>2026-10-18 <td>1.27    <td>CXS    <td>NPJSON_BuilderEx 改为单遍显式栈构建，NPJSON_Release 改为非递归;添加最大嵌套深度 NPJSON_MAX_DEPTH
+ * <tr><td>2026-10-18 <td>1.28    <td>CXS    <td>添加 NPJSON_Scan 三态回调（NPJSON_SKIP 按括号索引跳过）及 NPJSON_Option.filter
+ * <tr><td>2026-10-18 <td>1.29    <td>CXS    <td>添加成员投影 NPJSON_CreateProjection，NPJSON_BuilderEx 只生成投影成员
+ * <tr><td>2026-10-18 <td>1.30    <td>CXS    <td>添加拉取游标 NPJSON_Cursor
+ * <tr><td>2026-10-18 <td>1.31    <td>CXS    <td>添加 C++ 封装 NPJSON.hpp（所有权类型只能移动，共享类型引用计数，string_view 访问）;NPJSONNode 记录字符串长度
+ * <tr><td>2026-10-18 <td>1.32    <td>CXS    <td>添加严格校验 NPJSON_Validate（RFC 8259，不回调、不分配内存）
+ * <tr><td>2026-10-18 <td>1.33    <td>CXS    <td>添加文本修改 NPJSON_SObjectPatch/NPJSON_RObjectPatch（按路径原地替换值，共享时写时复制）
+ * <tr><td>2026-10-18 <td>1.34    <td>CXS    <td>数值延迟转换：NPJSON_ResolveLazy、NPJSON_Option.lazyNumber 保留原文（Val.Raw），输出时原样写出
+ * <tr><td>2026-10-18 <td>1.35    <td>CXS    <td>添加缓冲池 NPJSON_PoolAllocator（分级、线程缓存）及 NPJSON_PoolTrim
+ * <tr><td>2026-10-18 <td>1.36    <td>CXS    <td>添加 JSON 模板 NPJSON_CompileTemplate/NPJSON_TemplateRender（%d %l %f %b %s %r 值槽）
+ * <tr><td>2026-10-18 <td>1.37    <td>CXS    <td>添加并行序列化 NPJSON_AddArrayParallel（CFG_NPJSON_NO_THREAD）
  * </table>
 
 功能说明：
@@ -50,7 +75,8 @@
 3.不支持错误收集
 4.支持JSON对象、数组生成
 5.内存使用极低 需要的内存 = NPJSON_NAME_LEN + JSON对象深度(涉及递归)
-6.不支持'\uXXXX'扩展字符
+6.支持'\uXXXX'扩展字符（包含代理对），解码为UTF-8
+7.支持流式输出 NPJSON_CreateStreamSynthesizer 内存占用固定为输出块大小
 
 注意：
 1.NPJSON_Synthesizer 转换成 NPJSON_SObject 后会删除 NPJSON_Synthesizer
@@ -76,11 +102,32 @@ extern "C" {
 #define NPJSON_NAME_LEN CFG_NPJSON_NAME_LEN
 #endif
 
+#ifndef CFG_NPJSON_MAX_DEPTH
+#define NPJSON_MAX_DEPTH 1024   // 最大嵌套深度（根对象为 1）
+#else
+#define NPJSON_MAX_DEPTH CFG_NPJSON_MAX_DEPTH
+#endif
+
+// 定义 CFG_NPJSON_NO_SIMD 关闭向量化（SSE2/AVX2/NEON）字符扫描
+// 定义 CFG_NPJSON_UTF8_CHECK 解析字符串时校验UTF-8编码
+// 定义 CFG_NPJSON_NO_MMAP 不使用文件映射（NPJSON_ImageOpen 始终返回 false）
+// 定义 CFG_NPJSON_STATS 开启运行统计（NPJSON_GetStats）
+// 定义 CFG_NPJSON_NO_THREAD 不使用线程（NPJSON_AddArrayParallel 顺序执行）
+
 // 外部接口
 extern void *NPJSON_Malloc(size_t size);
 extern void  NPJSON_Free(void *ptr);
 extern void *NPJSON_Realloc(void *ptr, size_t size);
 
+// 分配器 各接口传入 NULL 时使用上面的外部接口
+typedef struct
+{
+    void *(*Malloc)(void *ctx, size_t size);
+    void (*Free)(void *ctx, void *ptr);
+    void *(*Realloc)(void *ctx, void *ptr, size_t size);
+    void *ctx;   // 用户参数
+} NPJSON_Allocator;
+
 // JSON 解析结果
 typedef struct _NPJSON_Result NPJSON_Result;
 
@@ -93,6 +140,18 @@ typedef struct _NPJSON_RObject NPJSON_RObject;
 // JSON 合成对象
 typedef struct _NPJSON_SObject NPJSON_SObject;
 
+// 引用计数共享缓存（只读）
+typedef struct _NPJSON_Buffer NPJSON_Buffer;
+
+// 成员投影（前缀树）
+typedef struct _NPJSON_Projection NPJSON_Projection;
+
+// PARS：ctx 用户参数
+// PARS：data 输出数据
+// PARS：size 输出数据长度
+// RETV：false 输出失败
+typedef bool (*NPJSON_SinkFunc)(void *ctx, const char *data, size_t size);
+
 // PARS：name 对象名称
 // PARS：re 解析结果
 // PARS：index 数组索引
@@ -100,6 +159,21 @@ typedef struct _NPJSON_SObject NPJSON_SObject;
 // RETV：false 停止解析
 typedef bool (*NPJSON_ResolveFunc)(const char *name, NPJSON_Result *re, int index, void *obj);
 
+// 扫描回调结果
+typedef enum
+{
+    NPJSON_STOP     = 0,   // 终止解析
+    NPJSON_CONTINUE = 1,   // 继续 对象、数组进入其内容
+    NPJSON_SKIP     = 2,   // 跳过当前值（对象、数组不再解析其内容）
+} NPJSON_ScanResult;
+
+// PARS：name 对象名称
+// PARS：re 解析结果 对象、数组时 str、Strlength 为其完整范围
+// PARS：index 数组索引
+// PARS：obj 存储对象
+// RETV：NPJSON_ScanResult
+typedef NPJSON_ScanResult (*NPJSON_ScanFunc)(const char *name, NPJSON_Result *re, int index, void *obj);
+
 // JSON 解析对象
 struct _NPJSON_RObject
 {
@@ -109,6 +183,9 @@ struct _NPJSON_RObject
 
     // 对象深度解析
     bool (*Resolve)(NPJSON_RObject *re, void *obj, NPJSON_ResolveFunc fun);
+
+    NPJSON_Buffer *         share;   // 共享缓存 NULL 表示独占 str 可能是共享缓存的片段
+    const NPJSON_Allocator *alloc;   // 分配器 NULL 使用默认
 };
 
 // JSON 解析结果
@@ -117,6 +194,11 @@ struct _NPJSON_Result
     const char *str;         // 要解析的字符串
     int         Strlength;   // 要解析的字符串长度
     const char *err;         // 发生错误字符串
+    char *         buf;       // 字符串解码缓存
+    int            bufsize;   // 字符串解码缓存大小
+    NPJSON_Buffer *         share;   // str 所在的共享缓存
+    const NPJSON_Allocator *alloc;   // 分配器 NULL 使用默认
+    bool lazyNumber;                 // 数值延迟转换 只记录原文（Val.Raw）和是否整数
 
     int ArrIdx;   // 数组索引
     int level;    // 层级
@@ -132,6 +214,11 @@ struct _NPJSON_Result
         } String;           // 字符串
         long long Value;    // 整型值
         double    Number;   // 数值量
+        struct
+        {
+            const char *ptr;
+            int         length;
+        } Raw;   // 数值原文（不含空白）
     } Val;
 
     char *name;   // 对象名称，数组为null
@@ -143,6 +230,7 @@ struct _NPJSON_Result
     uint8_t isInteger : 1;    // 整型
     uint8_t isString : 1;     // 是否为字符串
     uint8_t isNull : 1;       // 是否空值
+    uint8_t isRaw : 1;        // 数值尚未转换 使用 NPJSON_ResultGetInt/NPJSON_ResultGetNumber 读取
 
     // 对象深度解析
     bool (*Resolve)(NPJSON_Result *re, void *obj, NPJSON_ResolveFunc fun);
@@ -168,12 +256,47 @@ typedef struct
     bool (*RObject)(NPJSON_Synthesizer *re, const NPJSON_RObject *value);
 } _NPJSON_Synthesizer_AddArrayEvent;
 
+// key 为已包含引号和冒号的名称 "name": ，key_len 为其长度，null：数组元素
+typedef struct
+{
+    bool (*Int)(NPJSON_Synthesizer *re, const char *key, int key_len, long long value);
+    bool (*Number)(NPJSON_Synthesizer *re, const char *key, int key_len, double value);
+    bool (*String)(NPJSON_Synthesizer *re, const char *key, int key_len, const char *value);
+    bool (*Bool)(NPJSON_Synthesizer *re, const char *key, int key_len, bool value);
+    bool (*SObject)(NPJSON_Synthesizer *re, const char *key, int key_len, const NPJSON_SObject *value);
+    bool (*RObject)(NPJSON_Synthesizer *re, const char *key, int key_len, const NPJSON_RObject *value);
+    bool (*StartObject)(NPJSON_Synthesizer *re, const char *key, int key_len);
+    bool (*StartArray)(NPJSON_Synthesizer *re, const char *key, int key_len);
+    bool (*Int32List)(NPJSON_Synthesizer *re, const char *key, int key_len, const int32_t *value, int count);
+    bool (*Int64List)(NPJSON_Synthesizer *re, const char *key, int key_len, const int64_t *value, int count);
+    bool (*FloatList)(NPJSON_Synthesizer *re, const char *key, int key_len, const float *value, int count);
+    bool (*DoubleList)(NPJSON_Synthesizer *re, const char *key, int key_len, const double *value, int count);
+    bool (*BoolList)(NPJSON_Synthesizer *re, const char *key, int key_len, const bool *value, int count);
+    bool (*StringList)(NPJSON_Synthesizer *re, const char *key, int key_len, const char *const *value, int count);
+} _NPJSON_Synthesizer_AddKeyEvent;
+
+// 整个数组作为一个元素写入 name：null 嵌套数组
+typedef struct
+{
+    bool (*Int32)(NPJSON_Synthesizer *re, const char *name, const int32_t *value, int count);
+    bool (*Int64)(NPJSON_Synthesizer *re, const char *name, const int64_t *value, int count);
+    bool (*Float)(NPJSON_Synthesizer *re, const char *name, const float *value, int count);
+    bool (*Double)(NPJSON_Synthesizer *re, const char *name, const double *value, int count);
+    bool (*Bool)(NPJSON_Synthesizer *re, const char *name, const bool *value, int count);
+    bool (*String)(NPJSON_Synthesizer *re, const char *name, const char *const *value, int count);
+} _NPJSON_Synthesizer_AddListEvent;
+
 struct _NPJSON_Synthesizer
 {
     char *str;
     char *idx;
     char *endidx;
 
+    bool                    comma;      // 下一个元素前需要 ,
+    NPJSON_SinkFunc         sink;       // 流式输出 null：全部缓存
+    void *                  sink_ctx;   // 流式输出用户参数
+    const NPJSON_Allocator *alloc;      // 分配器 NULL 使用默认
+
     // FUNC：StartObject
     // PARS：name 对象名称 null：嵌套对象用于数组中
     // NOTE：创建对象
@@ -201,12 +324,16 @@ struct _NPJSON_Synthesizer
 
     const _NPJSON_Synthesizer_AddEvent *     Add;            // 添加元素
     const _NPJSON_Synthesizer_AddArrayEvent *AddArrayItem;   // 添加数组元素
+    const _NPJSON_Synthesizer_AddKeyEvent *  AddKey;         // 添加元素（预生成名称）
+    const _NPJSON_Synthesizer_AddListEvent * AddList;        // 批量添加数组
 };
 
 struct _NPJSON_SObject
 {
-    char *str;
-    int   Strlength;
+    char *         str;
+    int            Strlength;
+    NPJSON_Buffer *         share;   // 共享缓存 NULL 表示独占 共享时 str 只读
+    const NPJSON_Allocator *alloc;   // 分配器 NULL 使用默认
 };
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -219,11 +346,67 @@ struct _NPJSON_SObject
 // PARS：fun 解析回调
 // PARS：obj 存储对象
 // PARS：err 发生错误的字符串（指向str内容的指针）
-// NOTE：JSON解析
+// NOTE：JSON解析 嵌套超过 NPJSON_MAX_DEPTH 时失败
 // DATE：2020年5月21日
 // RETV：true 解析成功 false 解析失败
 extern bool NPJSON_Resolve(const char *str, int length, void *obj, NPJSON_ResolveFunc fun, const char **err);
 
+// FUNC：NPJSON_ResolveEx
+// PARS：str 解析的字符串
+// PARS：length 解析的字符串 长度
+// PARS：alloc 分配器 NULL 使用默认
+// PARS：fun 解析回调
+// PARS：obj 存储对象
+// PARS：err 发生错误的字符串（指向str内容的指针）
+// NOTE：JSON解析 名称、解码缓存及回调中创建的安全对象使用 alloc 分配
+// DATE：2026年10月18日
+// RETV：true 解析成功 false 解析失败
+extern bool NPJSON_ResolveEx(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ResolveFunc fun, const char **err);
+
+// FUNC：NPJSON_ResolveLazy
+// PARS：str 解析的字符串
+// PARS：length 解析的字符串 长度
+// PARS：alloc 分配器 NULL 使用默认
+// PARS：fun 解析回调
+// PARS：obj 存储对象
+// PARS：err 发生错误的字符串（指向str内容的指针）
+// NOTE：同 NPJSON_ResolveEx 数值不转换（isRaw） 回调中使用 NPJSON_ResultGetInt/NPJSON_ResultGetNumber 读取
+// NOTE：只转发的数值可直接使用 Val.Raw 原文，超过 64 位的整数不丢失精度
+// NOTE：原文不符合数字语法（如 1abc、-、1 2）时解析失败
+// DATE：2026年10月18日
+// RETV：true 解析成功 false 解析失败
+extern bool NPJSON_ResolveLazy(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ResolveFunc fun, const char **err);
+
+// FUNC：NPJSON_ResultGetInt
+// PARS：re 解析结果（数值）
+// NOTE：读取整型值 延迟转换的数值在第一次读取时转换
+// DATE：2026年10月18日
+extern long long NPJSON_ResultGetInt(NPJSON_Result *re);
+
+// FUNC：NPJSON_ResultGetNumber
+// PARS：re 解析结果（数值）
+// NOTE：读取数值量 延迟转换的数值在第一次读取时转换
+// DATE：2026年10月18日
+extern double NPJSON_ResultGetNumber(NPJSON_Result *re);
+
+// FUNC：NPJSON_Scan
+// PARS：str 解析的字符串
+// PARS：length 解析的字符串 长度
+// PARS：obj 存储对象
+// PARS：fun 扫描回调
+// PARS：err 发生错误的字符串（指向str内容的指针）
+// NOTE：非递归解析 每个值回调一次 对象、数组返回 NPJSON_CONTINUE 时自动进入内容（re->level 加 1）
+// NOTE：先建立括号索引 NPJSON_SKIP 直接跳到匹配位置 不再扫描被跳过的内容
+// DATE：2026年10月18日
+// RETV：true 解析成功 false 解析失败或回调返回 NPJSON_STOP
+extern bool NPJSON_Scan(const char *str, int length, void *obj, NPJSON_ScanFunc fun, const char **err);
+
+// FUNC：NPJSON_ScanEx
+// PARS：alloc 分配器 NULL 使用默认
+// NOTE：同 NPJSON_Scan 括号索引、名称及解码缓存使用 alloc 分配
+// DATE：2026年10月18日
+extern bool NPJSON_ScanEx(const char *str, int length, const NPJSON_Allocator *alloc, void *obj, NPJSON_ScanFunc fun, const char **err);
+
 // FUNC：NPJSON_CreateObject
 // PARS：re JSON解析结果
 // NOTE：创建非安全解析对象 在整个解析过程中确保 NPJSON_Resolve
@@ -255,6 +438,37 @@ extern NPJSON_RObject NPJSON_ResolveToSafeObject(const char *str, int length);
 // DATE：2020年5月21日
 extern void NPJSON_DeleteSafeObject(NPJSON_RObject *re);
 
+// FUNC：NPJSON_ResolveToSharedObject
+// PARS：str 解析的字符串
+// PARS：length 解析的字符串 长度
+// NOTE：解析字符串转共享解析对象（安全） 克隆、子对象转安全对象只增加引用计数
+// 使用后必须调用 NPJSON_DeleteSafeObject DATE：2026年10月18日
+extern NPJSON_RObject NPJSON_ResolveToSharedObject(const char *str, int length);
+
+// FUNC：NPJSON_RObjectShare
+// PARS：re 安全解析对象
+// NOTE：安全解析对象转为共享模式（不复制） 之后 str 只读
+// DATE：2026年10月18日
+extern bool NPJSON_RObjectShare(NPJSON_RObject *re);
+
+// FUNC：NPJSON_CheckUTF8
+// PARS：str 字符串
+// PARS：len 字符串长度
+// NOTE：校验UTF-8编码（拒绝超长编码、代理区、超过U+10FFFF）
+// DATE：2026年10月18日
+// RETV：true 编码正确
+extern bool NPJSON_CheckUTF8(const char *str, size_t len);
+
+// FUNC：NPJSON_Validate
+// PARS：str JSON 字符串
+// PARS：len JSON 字符串长度
+// PARS：err 失败时返回出错位置（可为空）
+// NOTE：按 RFC 8259 严格校验（含字符串转义、UTF-8、数字格式、尾随内容），不回调、不分配内存
+// NOTE：嵌套深度不超过 NPJSON_MAX_DEPTH
+// DATE：2026年10月18日
+// RETV：true 格式正确
+extern bool NPJSON_Validate(const char *str, size_t len, const char **err);
+
 #define NAME_IS(NAME) strcmp(name, #NAME) == 0
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -267,6 +481,13 @@ extern void NPJSON_DeleteSafeObject(NPJSON_RObject *re);
 // DATE：2020年5月23日
 extern NPJSON_Synthesizer NPJSON_CreateSynthesizer(int size);
 
+// FUNC：NPJSON_CreateSynthesizerEx
+// PARS：size 设置初始缓存大小
+// PARS：alloc 分配器 NULL 使用默认 生成的 NPJSON_SObject 沿用该分配器
+// NOTE：创建JSON合成器
+// DATE：2026年10月18日
+extern NPJSON_Synthesizer NPJSON_CreateSynthesizerEx(int size, const NPJSON_Allocator *alloc);
+
 // FUNC：NPJSON_SynthesizerClone
 // PARS：sn JSON合成器
 // NOTE：JSON合成器克隆
@@ -291,6 +512,21 @@ extern NPJSON_SObject NPJSON_CreateSObject(NPJSON_Synthesizer *re);
 // DATE：2020年5月23日
 extern void NPJSON_DeleteSObject(NPJSON_SObject *re);
 
+// FUNC：NPJSON_CreateStreamSynthesizer
+// PARS：size 输出块大小
+// PARS：sink 输出回调
+// PARS：ctx 输出回调用户参数
+// NOTE：创建流式JSON合成器，缓存满后按块交给 sink 输出，内存占用固定为 size
+// 使用后必须调用 NPJSON_StreamSynthesizerEnd DATE：2026年10月18日
+extern NPJSON_Synthesizer NPJSON_CreateStreamSynthesizer(int size, NPJSON_SinkFunc sink, void *ctx);
+
+// FUNC：NPJSON_StreamSynthesizerEnd
+// PARS：re 流式JSON合成器
+// NOTE：结束根对象，输出剩余内容并删除合成器
+// DATE：2026年10月18日
+// RETV：false 输出失败
+extern bool NPJSON_StreamSynthesizerEnd(NPJSON_Synthesizer *re);
+
 // FUNC：NPJSON_SObject_String
 // PARS：obj JSON合成对象
 // NOTE：获取JSON生成的字符串
@@ -325,6 +561,78 @@ extern NPJSON_RObject NPJSON_SafeRObjectClone(const NPJSON_RObject *re);
 // DATE：2020年5月23日
 extern NPJSON_SObject NPJSON_SObjectClone(const NPJSON_SObject *re);
 
+// FUNC：NPJSON_SObjectShare
+// PARS：re JSON合成对象
+// NOTE：JSON合成对象转为共享模式（不复制） 之后克隆只增加引用计数 str 只读
+// DATE：2026年10月18日
+extern bool NPJSON_SObjectShare(NPJSON_SObject *re);
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 文本修改 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// FUNC：NPJSON_SObjectPatch
+// PARS：re JSON合成对象
+// PARS：path 成员路径 以 . 分隔，数组使用十进制下标（如 "data.items.0.id"），空字符串为根值
+// PARS：value 新值的 JSON 文本（如 "123"、"\"abc\""） 不能指向 re 的内容
+// PARS：value_len 新值长度
+// NOTE：跳过扫描定位后直接替换文本，不解析、不重新合成；独占时只移动尾部（变长时重新分配一次）
+// NOTE：共享模式写时复制 按新长度分配一次，其他引用不受影响
+// DATE：2026年10月18日
+// RETV：false 路径不存在或内存不足（对象不变）
+extern bool NPJSON_SObjectPatch(NPJSON_SObject *re, const char *path, const char *value, int value_len);
+
+// FUNC：NPJSON_RObjectPatch
+// PARS：re 安全解析对象（不安全对象不能修改）
+// PARS：path 成员路径 同 NPJSON_SObjectPatch
+// PARS：value 新值的 JSON 文本 不能指向 re 的内容
+// PARS：value_len 新值长度
+// NOTE：同 NPJSON_SObjectPatch
+// DATE：2026年10月18日
+// RETV：false 路径不存在、不安全对象或内存不足（对象不变）
+extern bool NPJSON_RObjectPatch(NPJSON_RObject *re, const char *path, const char *value, int value_len);
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 格式化 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// FUNC：NPJSON_Minify
+// PARS：str JSON 字符串
+// PARS：len JSON 字符串长度
+// PARS：out 输出JSON合成对象 使用后必须 NPJSON_DeleteSObject 否则内存泄漏
+// PARS：err 发生错误的字符串
+// NOTE：去除空白，单次扫描，不解析对象
+// DATE：2026年10月18日
+// RETV：false 失败
+extern bool NPJSON_Minify(const char *str, size_t len, NPJSON_SObject *out, const char **err);
+
+// FUNC：NPJSON_Beautify
+// PARS：str JSON 字符串
+// PARS：len JSON 字符串长度
+// PARS：indent 缩进空格数
+// PARS：out 输出JSON合成对象 使用后必须 NPJSON_DeleteSObject 否则内存泄漏
+// PARS：err 发生错误的字符串
+// NOTE：重新缩进，单次扫描，不解析对象
+// DATE：2026年10月18日
+// RETV：false 失败
+extern bool NPJSON_Beautify(const char *str, size_t len, int indent, NPJSON_SObject *out, const char **err);
+
+// FUNC：NPJSON_MinifyToSink
+// PARS：sink 输出回调
+// PARS：ctx 输出回调用户参数
+// NOTE：同 NPJSON_Minify，结果按块交给 sink 输出
+// DATE：2026年10月18日
+// RETV：false 失败
+extern bool NPJSON_MinifyToSink(const char *str, size_t len, NPJSON_SinkFunc sink, void *ctx, const char **err);
+
+// FUNC：NPJSON_BeautifyToSink
+// PARS：sink 输出回调
+// PARS：ctx 输出回调用户参数
+// NOTE：同 NPJSON_Beautify，结果按块交给 sink 输出
+// DATE：2026年10月18日
+// RETV：false 失败
+extern bool NPJSON_BeautifyToSink(const char *str, size_t len, int indent, NPJSON_SinkFunc sink, void *ctx, const char **err);
+
 typedef struct
 {
     // 解析
@@ -450,21 +758,38 @@ typedef struct _NPJSONNode
     uint8_t isInteger : 1;    // 整型
     uint8_t isString : 1;     // 是否为字符串
     uint8_t isNull : 1;       // 是否空值
+    uint8_t isPacked : 1;     // 数值数组紧凑存储（Val.Packed）
+    uint8_t isPackedInt : 1;  // 紧凑存储元素为 int64_t 否则为 double
+    uint8_t isRaw : 1;        // 数值以原文存储（NPJSON_Option.lazyNumber）不超过 15 字节在 Val.Raw 否则在 Val.StrPtr
+    uint8_t isRawPtr : 1;     // 原文在 Val.StrPtr/StrLength（需释放）
 
     union
     {
         bool  BinValue;   // 二值量
+        char  Raw[16];    // 数值原文 以 \0 结束
         char *String;     // 字符串
         struct
         {
             long long Value;    // 整型值
             double    Number;   // 数值量
         };
+        // 注意：紧凑数组（isPacked）的 Packed 与 Object/ChildCount 重叠 Object 此时不是子节点链表
+        // 遍历子节点请使用 NPJSON_GetChild（紧凑数组返回 NULL），或先判断 isPacked
         struct
         {
-            struct _NPJSONNode *Object;       // 对象值
+            struct _NPJSONNode *Object;       // 对象值（isPacked 时无效）
             size_t              ChildCount;   // 子对象的数量
         };
+        struct
+        {
+            char * StrPtr;      // 同 String
+            size_t StrLength;   // 字符串长度（不含 \0）
+        };
+        struct
+        {
+            void * Data;    // int64_t[] 或 double[]（与 Object 重叠 不可按节点访问）
+            size_t Count;   // 元素数量（与 ChildCount 重叠）
+        } Packed;
     } Val;
 
     struct _NPJSONNode *next;     // 后驱指针
@@ -481,12 +806,64 @@ typedef struct _NPJSONNode
 // DATE：2021年9月23日
 extern NPJSONNode *NPJSON_Builder(const char *str, size_t len, const char **err);
 
+typedef struct
+{
+    bool                    packed;   // 纯数值数组使用连续内存存储（isPacked），不再逐元素分配节点
+                                      // 注意：此时数组的 Val.Object 不是子节点 须使用 NPJSON_GetChild 或检查 isPacked
+    const NPJSON_Allocator *alloc;    // 分配器 NULL 使用默认 生成的文档使用 NPJSON_ReleaseEx 释放
+    int                     maxDepth; // 最大嵌套深度 0 使用 NPJSON_MAX_DEPTH
+    NPJSON_ScanFunc         filter;   // 过滤 NULL 生成全部 NPJSON_SKIP 不生成该值 NPJSON_STOP 生成失败
+                                      // 对象、数组在进入前回调（re->str 指向括号，Strlength 为 0）
+    void *                  filterCtx;   // filter 的 obj 参数
+    const NPJSON_Projection *projection;   // 投影 NULL 生成全部 只生成投影成员及其祖先（先于 filter）
+    bool lazyNumber;   // 数值保留原文不转换（isRaw） 使用 NPJSON_GetInt/NPJSON_GetNumber 读取 输出时原样写出 原文须符合 RFC 8259 数字语法 否则生成失败
+} NPJSON_Option;
+
+// FUNC：NPJSON_BuilderEx
+// PARS：str JSON 字符串
+// PARS：len JSON 字符串长度
+// PARS：opt 生成选项 NULL 使用默认选项
+// PARS：err 发生错误的字符串
+// NOTE：生成 数组中出现非数值元素时自动还原为节点链表
+// NOTE：单遍非递归解析 嵌套超过 maxDepth 时失败
+// DATE：2026年10月18日
+extern NPJSONNode *NPJSON_BuilderEx(const char *str, size_t len, const NPJSON_Option *opt, const char **err);
+
+// FUNC：NPJSON_CreateProjection
+// PARS：paths 成员路径 以 . 分隔 如 "user.id" 数组对其元素透明（"items.id" 匹配每个元素的 id）
+// PARS：count 路径数量
+// NOTE：创建投影 路径终点保留整个值 祖先只保留通向终点的成员 空路径保留全部
+// NOTE：投影只读 可在多个线程的 NPJSON_BuilderEx 中同时使用
+// DATE：2026年10月18日
+extern NPJSON_Projection *NPJSON_CreateProjection(const char *const *paths, int count);
+
+// FUNC：NPJSON_CreateProjectionEx
+// PARS：paths 成员路径 同 NPJSON_CreateProjection
+// PARS：count 路径数量
+// PARS：alloc 分配器 NULL 使用默认 NPJSON_DeleteProjection 沿用该分配器释放
+// NOTE：创建投影（指定分配器）
+// DATE：2026年10月18日
+extern NPJSON_Projection *NPJSON_CreateProjectionEx(const char *const *paths, int count, const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_DeleteProjection
+// PARS：p 投影
+// NOTE：删除投影
+// DATE：2026年10月18日
+extern void NPJSON_DeleteProjection(NPJSON_Projection *p);
+
 // FUNC：NPJSON_Release
 // PARS：n JSON 生成对象
 // NOTE：释放
 // DATE：2021年9月23日
 extern void NPJSON_Release(NPJSONNode **n);
 
+// FUNC：NPJSON_ReleaseEx
+// PARS：n JSON 生成对象
+// PARS：alloc 生成时使用的分配器
+// NOTE：释放 NPJSON_BuilderEx 指定分配器生成的文档
+// DATE：2026年10月18日
+extern void NPJSON_ReleaseEx(NPJSONNode **n, const NPJSON_Allocator *alloc);
+
 // FUNC：NPJSON_Find
 // PARS：n JSON 生成对象
 // PARS：name 名称
@@ -500,12 +877,649 @@ extern NPJSONNode *NPJSON_Find(NPJSONNode *n, const char *name);
 // DATE：2021年9月23日
 extern size_t NPJSON_GetChildCount(NPJSONNode *n);
 
+// FUNC：NPJSON_GetChild
+// PARS：n JSON 生成对象
+// NOTE：获取第一个子节点 之后使用 NPJSON_GetNext 遍历
+// NOTE：紧凑数组（isPacked）没有子节点 返回 NULL 使用 NPJSON_GetPackedInt64/NPJSON_GetPackedDouble 读取
+// DATE：2026年10月18日
+extern NPJSONNode *NPJSON_GetChild(NPJSONNode *n);
+
 // FUNC：NPJSON_GetNext
 // PARS：n JSON 生成对象
 // NOTE：获取下一个对象
 // DATE：2021年9月23日
 extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
 
+// FUNC：NPJSON_GetInt
+// PARS：n 数值或二值量节点
+// NOTE：读取整型值 原文存储的数值每次读取时转换
+// DATE：2026年10月18日
+extern long long NPJSON_GetInt(const NPJSONNode *n);
+
+// FUNC：NPJSON_GetNumber
+// PARS：n 数值或二值量节点
+// NOTE：读取数值量 原文存储的数值每次读取时转换
+// DATE：2026年10月18日
+extern double NPJSON_GetNumber(const NPJSONNode *n);
+
+// FUNC：NPJSON_GetRaw
+// PARS：n 数值节点
+// PARS：len 返回原文长度（可为空）
+// NOTE：数值原文（NPJSON_Option.lazyNumber） 超过 64 位的整数可由此自行转换
+// DATE：2026年10月18日
+// RETV：非原文存储返回 NULL
+extern const char *NPJSON_GetRaw(const NPJSONNode *n, size_t *len);
+
+// FUNC：NPJSON_GetPackedInt64
+// PARS：n 数组节点
+// PARS：count 元素数量
+// NOTE：获取紧凑整型数组（零拷贝） 非紧凑整型数组返回 NULL
+// DATE：2026年10月18日
+extern const int64_t *NPJSON_GetPackedInt64(NPJSONNode *n, size_t *count);
+
+// FUNC：NPJSON_GetPackedDouble
+// PARS：n 数组节点
+// PARS：count 元素数量
+// NOTE：获取紧凑浮点数组（零拷贝） 非紧凑浮点数组返回 NULL
+// DATE：2026年10月18日
+extern const double *NPJSON_GetPackedDouble(NPJSONNode *n, size_t *count);
+
+// FUNC：NPJSON_CopyInt64Array
+// PARS：n 数组节点
+// PARS：out 输出缓存
+// PARS：capacity 输出缓存元素数量
+// NOTE：复制数值数组 支持紧凑和节点两种存储 遇到非数值元素停止
+// RETV：复制的数量
+// DATE：2026年10月18日
+extern size_t NPJSON_CopyInt64Array(NPJSONNode *n, int64_t *out, size_t capacity);
+
+// FUNC：NPJSON_CopyDoubleArray
+// PARS：n 数组节点
+// PARS：out 输出缓存
+// PARS：capacity 输出缓存元素数量
+// NOTE：复制数值数组 支持紧凑和节点两种存储 遇到非数值元素停止
+// RETV：复制的数量
+// DATE：2026年10月18日
+extern size_t NPJSON_CopyDoubleArray(NPJSONNode *n, double *out, size_t capacity);
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 拉取游标 |
+// ---------------------------------------------------------------------------------------------------------------------
+/*
+按需逐个读取值，不回调、不生成文档：每个值不分配内存，只保存各层的结束符。
+    NPJSON_Cursor *c = NPJSON_CreateCursor(str, len);
+    NPJSON_CursorEnter(c);                       // 进入根对象
+    while (NPJSON_CursorNext(c)) {               // 当前层结束时返回 false 并回到上一层
+        if (strcmp(NPJSON_CursorKey(c), "id") == 0)
+            id = NPJSON_CursorGetInt(c);
+        else if (strcmp(NPJSON_CursorKey(c), "user") == 0 && NPJSON_CursorEnter(c)) {
+            while (NPJSON_CursorNext(c))
+                ...
+        }                                        // 未进入的对象、数组由下一次 Next 跳过
+    }
+    if (NPJSON_CursorError(c) != NULL) ...
+    NPJSON_DeleteCursor(c);
+*/
+
+typedef enum
+{
+    NPJSON_TOKEN_NONE = 0,   // 无（未读取或已结束）
+    NPJSON_TOKEN_OBJECT,     // 对象
+    NPJSON_TOKEN_ARRAY,      // 数组
+    NPJSON_TOKEN_STRING,     // 字符串
+    NPJSON_TOKEN_NUMBER,     // 数值
+    NPJSON_TOKEN_BOOL,       // 二值量
+    NPJSON_TOKEN_NULL,       // 空值
+} NPJSON_TokenType;
+
+// JSON 拉取游标
+typedef struct _NPJSON_Cursor NPJSON_Cursor;
+
+// FUNC：NPJSON_CreateCursor
+// PARS：str JSON 字符串（游标使用期间不能改变）
+// PARS：len JSON 字符串长度
+// NOTE：创建游标 当前值为根对象或数组
+// DATE：2026年10月18日
+extern NPJSON_Cursor *NPJSON_CreateCursor(const char *str, size_t len);
+
+// FUNC：NPJSON_CreateCursorEx
+// PARS：alloc 分配器 NULL 使用默认
+// NOTE：同 NPJSON_CreateCursor
+// DATE：2026年10月18日
+extern NPJSON_Cursor *NPJSON_CreateCursorEx(const char *str, size_t len, const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_DeleteCursor
+// PARS：c 游标
+// NOTE：删除游标
+// DATE：2026年10月18日
+extern void NPJSON_DeleteCursor(NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorNext
+// PARS：c 游标
+// NOTE：移动到当前层的下一个值 当前值为未进入的对象、数组时整体跳过
+// RETV：false 当前层结束（已回到上一层）或出错（NPJSON_CursorError 非 NULL）
+// DATE：2026年10月18日
+extern bool NPJSON_CursorNext(NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorEnter
+// PARS：c 游标
+// NOTE：进入当前对象、数组 之后 NPJSON_CursorNext 读取其内容
+// RETV：false 当前值不是对象、数组或超过 NPJSON_MAX_DEPTH
+// DATE：2026年10月18日
+extern bool NPJSON_CursorEnter(NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorSkip
+// PARS：c 游标
+// NOTE：跳过当前层剩余的值并回到上一层
+// DATE：2026年10月18日
+extern bool NPJSON_CursorSkip(NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorType
+// PARS：c 游标
+// NOTE：当前值类型
+// DATE：2026年10月18日
+extern NPJSON_TokenType NPJSON_CursorType(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorKey
+// PARS：c 游标
+// NOTE：当前值名称（完整解码） 数组元素返回 NULL 下一次 NPJSON_CursorNext 前有效
+// DATE：2026年10月18日
+extern const char *NPJSON_CursorKey(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorDepth
+// PARS：c 游标
+// NOTE：当前层数 进入根对象后为 1
+// DATE：2026年10月18日
+extern int NPJSON_CursorDepth(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorError
+// PARS：c 游标
+// NOTE：错误位置（指向 str 内容） 无错误返回 NULL
+// DATE：2026年10月18日
+extern const char *NPJSON_CursorError(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorGetInt
+// PARS：c 游标
+// NOTE：读取整数 二值量返回 0/1 其他类型返回 0
+// DATE：2026年10月18日
+extern long long NPJSON_CursorGetInt(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorGetNumber
+// PARS：c 游标
+// NOTE：读取数值 二值量返回 0/1 其他类型返回 0
+// DATE：2026年10月18日
+extern double NPJSON_CursorGetNumber(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorGetBool
+// PARS：c 游标
+// NOTE：读取二值量 数值非 0 为 true
+// DATE：2026年10月18日
+extern bool NPJSON_CursorGetBool(const NPJSON_Cursor *c);
+
+// FUNC：NPJSON_CursorGetString
+// PARS：c 游标
+// PARS：len 字符串长度
+// NOTE：读取字符串 无转义时直接指向 str（不以 \0 结尾） 有转义时解码到游标缓存
+// NOTE：下一次 NPJSON_CursorGetString 或 NPJSON_CursorNext 前有效
+// RETV：NULL 不是字符串或解码失败
+// DATE：2026年10月18日
+extern const char *NPJSON_CursorGetString(NPJSON_Cursor *c, int *len);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 文档修改、输出  |
+// ----------------------------------------------------------------------------------------------------
+
+// FUNC：NPJSON_CreateNull/NPJSON_CreateBool/NPJSON_CreateInt/NPJSON_CreateNumber/NPJSON_CreateString/NPJSON_CreateObject/NPJSON_CreateArray
+// NOTE：创建节点 插入文档后由文档管理 未插入时调用 NPJSON_Release 删除
+// DATE：2026年10月18日
+extern NPJSONNode *NPJSON_CreateNull(void);
+extern NPJSONNode *NPJSON_CreateBool(bool value);
+extern NPJSONNode *NPJSON_CreateInt(long long value);
+extern NPJSONNode *NPJSON_CreateNumber(double value);
+extern NPJSONNode *NPJSON_CreateString(const char *value);
+extern NPJSONNode *NPJSON_CreateObject(void);
+extern NPJSONNode *NPJSON_CreateArray(void);
+
+// FUNC：NPJSON_CreateNullEx/NPJSON_CreateBoolEx/NPJSON_CreateIntEx/NPJSON_CreateNumberEx/NPJSON_CreateStringEx/NPJSON_CreateObjectEx/NPJSON_CreateArrayEx
+// PARS：alloc 分配器 NULL 使用默认 须与插入的文档相同
+// NOTE：创建节点（指定分配器） 未插入时调用 NPJSON_ReleaseEx 删除
+// DATE：2026年10月18日
+extern NPJSONNode *NPJSON_CreateNullEx(const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateBoolEx(bool value, const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateIntEx(long long value, const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateNumberEx(double value, const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateStringEx(const char *value, const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateObjectEx(const NPJSON_Allocator *alloc);
+extern NPJSONNode *NPJSON_CreateArrayEx(const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_Insert
+// PARS：parent 对象或数组
+// PARS：index 插入位置 小于 0 或超出数量时追加到末尾
+// PARS：name 名称 对象必须提供 数组忽略
+// PARS：item 新节点（未插入其他文档）
+// NOTE：插入节点 成功后 item 由文档管理 紧凑数组会先还原为节点
+// NOTE：使用默认分配器 NPJSON_Option.alloc 指定分配器生成的文档使用 NPJSON_InsertEx
+// DATE：2026年10月18日
+extern bool NPJSON_Insert(NPJSONNode *parent, int index, const char *name, NPJSONNode *item);
+
+// FUNC：NPJSON_InsertEx
+// PARS：alloc 文档的分配器（NPJSON_Option.alloc） item 须由同一分配器创建（NPJSON_CreateXxxEx）
+// NOTE：同 NPJSON_Insert 名称、还原紧凑数组使用 alloc
+// DATE：2026年10月18日
+extern bool NPJSON_InsertEx(NPJSONNode *parent, int index, const char *name, NPJSONNode *item, const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_Replace
+// PARS：parent 对象或数组
+// PARS：child 被替换的子节点（NPJSON_Find/NPJSON_GetNext 获得）
+// PARS：item 新节点（未插入其他文档）
+// NOTE：替换节点 沿用原名称并删除原节点
+// DATE：2026年10月18日
+extern bool NPJSON_Replace(NPJSONNode *parent, NPJSONNode *child, NPJSONNode *item);
+
+// FUNC：NPJSON_ReplaceEx
+// PARS：alloc 文档的分配器 item 须由同一分配器创建
+// NOTE：同 NPJSON_Replace 原节点使用 alloc 释放
+// DATE：2026年10月18日
+extern bool NPJSON_ReplaceEx(NPJSONNode *parent, NPJSONNode *child, NPJSONNode *item, const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_Remove
+// PARS：parent 对象或数组
+// PARS：child 子节点
+// NOTE：删除节点
+// DATE：2026年10月18日
+extern bool NPJSON_Remove(NPJSONNode *parent, NPJSONNode *child);
+
+// FUNC：NPJSON_RemoveEx
+// PARS：alloc 文档的分配器
+// NOTE：同 NPJSON_Remove 子节点使用 alloc 释放
+// DATE：2026年10月18日
+extern bool NPJSON_RemoveEx(NPJSONNode *parent, NPJSONNode *child, const NPJSON_Allocator *alloc);
+
+// FUNC：NPJSON_PrintSize
+// PARS：n 节点
+// NOTE：计算输出长度（不含'\0'）
+// DATE：2026年10月18日
+extern size_t NPJSON_PrintSize(NPJSONNode *n);
+
+// FUNC：NPJSON_PrintTo
+// PARS：n 节点
+// PARS：buf 输出缓存
+// PARS：size 输出缓存长度 不小于 NPJSON_PrintSize + 1
+// NOTE：输出JSON文本到指定缓存
+// RETV：输出长度 0 表示失败
+// DATE：2026年10月18日
+extern size_t NPJSON_PrintTo(NPJSONNode *n, char *buf, size_t size);
+
+// FUNC：NPJSON_Print
+// PARS：n 节点
+// NOTE：输出JSON文本 先计算长度再一次分配 使用后调用 NPJSON_DeleteSObject
+// DATE：2026年10月18日
+extern NPJSON_SObject NPJSON_Print(NPJSONNode *n);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 二进制镜像  |
+// ----------------------------------------------------------------------------------------------------
+/*
+镜像布局：头 | 节点 | 紧凑数组 | 字符串，全部使用自相对偏移（不含指针），可直接 mmap 后查询。
+同一对象的子节点连续存放，NPJSON_ImageGetChild 可按下标直接访问。
+镜像按本机字节序生成，字节序不同时 NPJSON_ImageLoad 返回 NULL；节点内容不做校验，仅加载可信镜像。
+*/
+
+#define NPJSON_IMAGE_OBJECT  0x0001   // 对象
+#define NPJSON_IMAGE_ARRAY   0x0002   // 数组
+#define NPJSON_IMAGE_BOOL    0x0004   // 二值量
+#define NPJSON_IMAGE_NUMBER  0x0008   // 数值量
+#define NPJSON_IMAGE_INTEGER 0x0010   // 整型（紧凑数组时表示元素为 int64_t）
+#define NPJSON_IMAGE_STRING  0x0020   // 字符串
+#define NPJSON_IMAGE_NULL    0x0040   // 空值
+#define NPJSON_IMAGE_PACKED  0x0080   // 紧凑数值数组
+
+typedef struct
+{
+    uint16_t flags;      // NPJSON_IMAGE_*
+    uint16_t reserved;   // 保留
+    int32_t  name;       // 名称自相对偏移 0 表示无名称
+    int32_t  next;       // 下一个兄弟节点自相对偏移 0 表示结束
+    uint32_t count;      // 子节点数量/紧凑数组元素数量/字符串长度
+    union
+    {
+        struct
+        {
+            int64_t Value;    // 整型值（二值量为 0/1）
+            double  Number;   // 数值量
+        };
+        int32_t Offset;   // 子节点/紧凑数组/字符串自相对偏移
+    } Val;
+} NPJSONImageNode;
+
+typedef struct
+{
+    const NPJSONImageNode *root;   // 根节点
+    void *                 addr;   // 映射地址
+    size_t                 size;   // 映射长度
+} NPJSON_ImageFile;
+
+// FUNC：NPJSON_ImageSize
+// PARS：root NPJSON_Builder 生成的根节点
+// NOTE：计算二进制镜像长度
+// RETV：镜像长度 0 表示失败（超过 2GB）
+// DATE：2026年10月18日
+extern size_t NPJSON_ImageSize(NPJSONNode *root);
+
+// FUNC：NPJSON_ImageDump
+// PARS：root NPJSON_Builder 生成的根节点
+// PARS：buf 输出缓存 8 字节对齐
+// PARS：size 输出缓存长度 不小于 NPJSON_ImageSize
+// NOTE：生成二进制镜像
+// RETV：写入长度 0 表示失败
+// DATE：2026年10月18日
+extern size_t NPJSON_ImageDump(NPJSONNode *root, void *buf, size_t size);
+
+// FUNC：NPJSON_ImageLoad
+// PARS：buf 镜像 8 字节对齐
+// PARS：size 镜像长度
+// NOTE：加载镜像 仅校验镜像头 不做解析
+// RETV：根节点 失败返回 NULL
+// DATE：2026年10月18日
+extern const NPJSONImageNode *NPJSON_ImageLoad(const void *buf, size_t size);
+
+// FUNC：NPJSON_ImageOpen
+// PARS：path 镜像文件路径
+// PARS：f 映射文件
+// NOTE：只读映射镜像文件 使用后调用 NPJSON_ImageClose
+// DATE：2026年10月18日
+extern bool NPJSON_ImageOpen(const char *path, NPJSON_ImageFile *f);
+
+// FUNC：NPJSON_ImageClose
+// PARS：f 映射文件
+// NOTE：解除映射
+// DATE：2026年10月18日
+extern void NPJSON_ImageClose(NPJSON_ImageFile *f);
+
+// FUNC：NPJSON_ImageFind
+// PARS：n 镜像节点
+// PARS：name 名称
+// NOTE：查找
+// DATE：2026年10月18日
+extern const NPJSONImageNode *NPJSON_ImageFind(const NPJSONImageNode *n, const char *name);
+
+// FUNC：NPJSON_ImageGetChildCount
+// PARS：n 镜像节点
+// NOTE：获取子节点数量（紧凑数组为元素数量）
+// DATE：2026年10月18日
+extern size_t NPJSON_ImageGetChildCount(const NPJSONImageNode *n);
+
+// FUNC：NPJSON_ImageGetNext
+// PARS：n 镜像节点
+// NOTE：获取下一个对象
+// DATE：2026年10月18日
+extern const NPJSONImageNode *NPJSON_ImageGetNext(const NPJSONImageNode *n);
+
+// FUNC：NPJSON_ImageGetChild
+// PARS：n 镜像节点
+// PARS：idx 下标
+// NOTE：获取子节点 紧凑数组返回 NULL
+// DATE：2026年10月18日
+extern const NPJSONImageNode *NPJSON_ImageGetChild(const NPJSONImageNode *n, size_t idx);
+
+// FUNC：NPJSON_ImageGetName
+// PARS：n 镜像节点
+// NOTE：获取名称 数组元素返回 NULL
+// DATE：2026年10月18日
+extern const char *NPJSON_ImageGetName(const NPJSONImageNode *n);
+
+// FUNC：NPJSON_ImageGetString
+// PARS：n 镜像节点
+// PARS：len 字符串长度
+// NOTE：获取字符串值（以'\0'结尾）
+// DATE：2026年10月18日
+extern const char *NPJSON_ImageGetString(const NPJSONImageNode *n, size_t *len);
+
+// FUNC：NPJSON_ImageGetPackedInt64
+// PARS：n 镜像节点
+// PARS：count 元素数量
+// NOTE：获取紧凑整型数组
+// DATE：2026年10月18日
+extern const int64_t *NPJSON_ImageGetPackedInt64(const NPJSONImageNode *n, size_t *count);
+
+// FUNC：NPJSON_ImageGetPackedDouble
+// PARS：n 镜像节点
+// PARS：count 元素数量
+// NOTE：获取紧凑浮点数组
+// DATE：2026年10月18日
+extern const double *NPJSON_ImageGetPackedDouble(const NPJSONImageNode *n, size_t *count);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 解析缓存  |
+// ----------------------------------------------------------------------------------------------------
+/*
+按输入内容哈希缓存 NPJSON_BuilderEx 的结果（LRU，按内存预算淘汰），相同输入直接返回共享文档。
+共享文档只读，使用后调用 NPJSON_CacheRelease；被淘汰的文档在最后一次释放时删除。
+缓存非线程安全，多线程使用需外部加锁。
+*/
+
+// JSON 解析缓存
+typedef struct _NPJSON_Cache NPJSON_Cache;
+
+typedef struct
+{
+    size_t hits;        // 命中次数
+    size_t misses;      // 未命中次数
+    size_t evictions;   // 淘汰次数
+    size_t entries;     // 当前缓存数量
+    size_t bytes;       // 当前占用内存
+} NPJSON_CacheStats;
+
+// FUNC：NPJSON_CreateCache
+// PARS：budget 内存预算（字节）
+// NOTE：创建解析缓存
+// DATE：2026年10月18日
+extern NPJSON_Cache *NPJSON_CreateCache(size_t budget);
+
+// FUNC：NPJSON_DeleteCache
+// PARS：c 解析缓存
+// NOTE：删除解析缓存 未释放的文档在 NPJSON_CacheRelease 时删除
+// DATE：2026年10月18日
+extern void NPJSON_DeleteCache(NPJSON_Cache *c);
+
+// FUNC：NPJSON_CacheBuilder
+// PARS：c 解析缓存
+// PARS：str JSON 字符串
+// PARS：len JSON 字符串长度
+// PARS：opt 生成选项 NULL 使用默认选项
+// PARS：err 发生错误的字符串
+// NOTE：生成（命中缓存时不解析） 返回的文档只读 不能调用 NPJSON_Release
+// NOTE：packed、alloc、maxDepth、projection、filter、filterCtx、lazyNumber 相同的选项共享缓存 投影按创建区分（不按地址）
+// DATE：2026年10月18日
+extern NPJSONNode *NPJSON_CacheBuilder(NPJSON_Cache *c, const char *str, size_t len, const NPJSON_Option *opt, const char **err);
+
+// FUNC：NPJSON_CacheRelease
+// PARS：n NPJSON_CacheBuilder 返回的文档
+// NOTE：释放文档引用
+// DATE：2026年10月18日
+extern void NPJSON_CacheRelease(NPJSONNode *n);
+
+// FUNC：NPJSON_CacheGetStats
+// PARS：c 解析缓存
+// PARS：st 统计信息
+// NOTE：获取命中、未命中、淘汰统计
+// DATE：2026年10月18日
+extern void NPJSON_CacheGetStats(const NPJSON_Cache *c, NPJSON_CacheStats *st);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 运行统计  |
+// ----------------------------------------------------------------------------------------------------
+/*
+定义 CFG_NPJSON_STATS 后在解析、生成、序列化路径上计数，未定义时统计代码不参与编译（零开销）。
+计数器为线程局部变量，NPJSON_GetStats 只返回当前线程的累计值。
+scannedBytes 为括号匹配与逐层解析访问的字节数之和，与 inputBytes 的比值反映重复扫描的程度。
+延迟直方图第 i 格统计耗时在 [2^i, 2^(i+1)) 纳秒内的调用次数。
+*/
+
+#define NPJSON_STATS_BUCKETS 32
+
+typedef struct
+{
+    uint64_t inputBytes;                             // NPJSON_Resolve/NPJSON_Scan/NPJSON_BuilderEx 输入字节数
+    uint64_t scannedBytes;                           // 实际扫描字节数
+    uint64_t resolveCalls;                           // NPJSON_Resolve/NPJSON_Scan/NPJSON_BuilderEx 调用次数
+    uint64_t callbacks;                              // 解析回调次数
+    uint64_t nodes;                                  // 生成的 NPJSONNode 数量
+    uint64_t allocs;                                 // 分配（含扩容）次数
+    uint64_t allocBytes;                             // 分配（含扩容）字节数
+    uint64_t synthReallocs;                          // 序列化器扩容次数
+    uint32_t maxDepth;                               // 最大嵌套层级
+    uint32_t reserved;                               // 保留
+    uint64_t resolveLatency[NPJSON_STATS_BUCKETS];   // NPJSON_Resolve 延迟直方图
+    uint64_t buildLatency[NPJSON_STATS_BUCKETS];     // NPJSON_BuilderEx 延迟直方图
+    uint64_t printLatency[NPJSON_STATS_BUCKETS];     // NPJSON_Print 延迟直方图
+} NPJSON_Stats;
+
+// FUNC：NPJSON_GetStats
+// PARS：st 统计信息
+// NOTE：获取当前线程的统计信息
+// RETV：未定义 CFG_NPJSON_STATS 时返回 false（st 清零）
+// DATE：2026年10月18日
+extern bool NPJSON_GetStats(NPJSON_Stats *st);
+
+// FUNC：NPJSON_ResetStats
+// NOTE：清零当前线程的统计信息
+// DATE：2026年10月18日
+extern void NPJSON_ResetStats(void);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 缓冲池  |
+// ----------------------------------------------------------------------------------------------------
+/*
+按 2 的幂分级（64 字节 ~ 1M）的缓冲池，作为 NPJSON_Allocator 使用：
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizerEx(256, NPJSON_PoolAllocator());
+每个线程有独立缓存，分配、释放不加锁；线程缓存满或空时与全局缓存成批交换（自旋锁）。
+合成器扩容在块内有空间时不移动，NPJSON_DeleteSObject 把缓冲归还当前线程的缓存，
+稳定状态下序列化不再调用 NPJSON_Malloc/NPJSON_Free。超过 1M 的缓冲直接使用外部接口。
+*/
+
+// FUNC：NPJSON_PoolAllocator
+// NOTE：缓冲池分配器 可用于所有带 alloc 参数的接口 线程安全
+// DATE：2026年10月18日
+extern const NPJSON_Allocator *NPJSON_PoolAllocator(void);
+
+// FUNC：NPJSON_PoolTrim
+// NOTE：释放当前线程缓存及全局缓存中的空闲块 线程退出前调用以免线程缓存泄漏
+// DATE：2026年10月18日
+// RETV：释放的字节数
+extern size_t NPJSON_PoolTrim(void);
+
+// FUNC：NPJSON_PoolFlush
+// NOTE：当前线程缓存中的空闲块归还全局缓存（不释放） 线程退出前调用 其他线程可继续使用这些块
+// NOTE：全局缓存已满的部分归还外部接口
+// DATE：2026年10月18日
+extern void NPJSON_PoolFlush(void);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | JSON 模板  |
+// ----------------------------------------------------------------------------------------------------
+/*
+固定结构的报文预先编译为模板，渲染时静态文本成块复制，只格式化值：
+    NPJSON_Template *t = NPJSON_CompileTemplate("{\"id\":%d,\"name\":%s,\"t\":%f,\"ok\":%b}", NULL);
+    NPJSON_SObject   s = NPJSON_TemplateRender(t, 7, "dev", 23.5, true);
+值槽只能出现在值的位置（字符串外），参数类型必须与值槽一致：
+    %d int  %l long long  %f double  %b bool
+    %s const char * 转义并加引号  %r const char * 原样写入的 JSON 文本（如其他模板的输出）
+%s %r 为 NULL 时输出 null。定长值槽按最大长度预留，输出空间只检查一次。
+*/
+
+// JSON 模板
+typedef struct _NPJSON_Template NPJSON_Template;
+
+// FUNC：NPJSON_CompileTemplate
+// PARS：tpl 模板文本
+// PARS：err 失败时的错误位置（指向 tpl）
+// NOTE：编译模板 值槽替换为值后必须是合法 JSON 使用后调用 NPJSON_DeleteTemplate
+// DATE：2026年10月18日
+extern NPJSON_Template *NPJSON_CompileTemplate(const char *tpl, const char **err);
+
+// FUNC：NPJSON_CompileTemplateEx
+// PARS：tpl 模板文本
+// PARS：alloc 分配器 NULL 使用默认 渲染生成的 NPJSON_SObject 沿用该分配器
+// PARS：err 失败时的错误位置（指向 tpl）
+// NOTE：编译模板
+// DATE：2026年10月18日
+extern NPJSON_Template *NPJSON_CompileTemplateEx(const char *tpl, const NPJSON_Allocator *alloc, const char **err);
+
+// FUNC：NPJSON_DeleteTemplate
+// PARS：t 模板
+// NOTE：删除模板
+// DATE：2026年10月18日
+extern void NPJSON_DeleteTemplate(NPJSON_Template *t);
+
+// FUNC：NPJSON_TemplateSize
+// PARS：t 模板
+// PARS：... 值 与值槽顺序、类型一致
+// NOTE：计算输出长度上限（不含'\0'）
+// DATE：2026年10月18日
+extern size_t NPJSON_TemplateSize(const NPJSON_Template *t, ...);
+
+// FUNC：NPJSON_TemplateRenderTo
+// PARS：t 模板
+// PARS：buf 输出缓存
+// PARS：size 输出缓存长度 不小于 NPJSON_TemplateSize + 1
+// PARS：... 值 与值槽顺序、类型一致
+// NOTE：渲染模板到指定缓存
+// RETV：输出长度 0 表示失败
+// DATE：2026年10月18日
+extern size_t NPJSON_TemplateRenderTo(const NPJSON_Template *t, char *buf, size_t size, ...);
+
+// FUNC：NPJSON_TemplateRender
+// PARS：t 模板
+// PARS：... 值 与值槽顺序、类型一致
+// NOTE：渲染模板 按长度上限一次分配 使用后调用 NPJSON_DeleteSObject
+// DATE：2026年10月18日
+extern NPJSON_SObject NPJSON_TemplateRender(const NPJSON_Template *t, ...);
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 并行序列化  |
+// ----------------------------------------------------------------------------------------------------
+/*
+N 条记录并行序列化为一个 JSON 数组。记录按顺序分块，工作线程各自写入独立的合成器，
+每轮结束后按块顺序一次性复制进目标合成器，元素顺序与记录顺序一致：
+    static bool Row(NPJSON_Synthesizer *sn, const void *record, size_t index, void *ctx)
+    {
+        const Rec *r = (const Rec *)record;
+        sn->StartObject(sn, NULL);
+        sn->Add->Int(sn, "id", r->id);
+        return sn->EndObject(sn);
+    }
+    NPJSON_AddArrayParallel(&sn, "rows", recs, n, sizeof(Rec), Row, NULL, 8);
+回调每次写入一个数组元素，会在多个线程中同时调用。工作合成器沿用目标合成器的分配器，
+该分配器必须线程安全（默认分配器、NPJSON_PoolAllocator 均可）。
+工作线程首次使用时创建并常驻，各次调用复用；每轮结束后工作线程把缓冲池线程缓存归还全局缓存，
+调用线程中的 NPJSON_PoolTrim 可以回收。多个线程同时调用时，后来者在调用线程中执行。
+POSIX 平台需链接 pthread；定义 CFG_NPJSON_NO_THREAD 或不支持线程时在调用线程中顺序执行。
+*/
+
+// 记录序列化回调 写入一个数组元素（AddArrayItem->* 或 StartObject/StartArray(sn, NULL) ... End*）
+// PARS：sn 工作合成器
+// PARS：record 记录
+// PARS：index 记录序号
+// PARS：ctx 用户参数
+// RETV：false 停止序列化
+typedef bool (*NPJSON_RecordFunc)(NPJSON_Synthesizer *sn, const void *record, size_t index, void *ctx);
+
+// FUNC：NPJSON_AddArrayParallel
+// PARS：sn 目标合成器（可为流式合成器）
+// PARS：name 数组名称 NULL 时作为数组元素写入
+// PARS：records 记录数组
+// PARS：count 记录数量
+// PARS：stride 相邻记录间隔（字节）
+// PARS：fun 记录序列化回调
+// PARS：ctx 回调用户参数
+// PARS：threads 线程数（含调用线程） 小于等于 1 时在调用线程中直接写入目标合成器
+// NOTE：并行写入 "name":[...] 内存占用为一轮（threads * 4 块，每块最多 1024 条记录）的输出
+// DATE：2026年10月18日
+// RETV：false 回调返回 false 或内存不足 目标合成器内容不完整
+extern bool NPJSON_AddArrayParallel(NPJSON_Synthesizer *sn, const char *name, const void *records, size_t count, size_t stride, NPJSON_RecordFunc fun,
+                                    void *ctx, int threads);
+
 // ----------------------------------------------------------------------------------------------------
 //                                          | 序列化宏  |
 // ----------------------------------------------------------------------------------------------------
@@ -520,7 +1534,7 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
     do {                                                             \
         NPJSON_Synthesizer __sn =                                    \
             NPJSON_Import()->Serialization.CreateSynthesizer(space); \
-        NPJSON_SObject __s_obj = {0, 0};
+        NPJSON_SObject __s_obj = {0, 0, 0, 0};
 
 /**
  * @brief    序列化结束
@@ -533,20 +1547,32 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
     }                                                        \
     while (false)
 
-#define NPJSON_Object_SetInt(key, value)    __sn.Add->Int(&__sn, #key, value)
-#define NPJSON_Object_SetNumber(key, value) __sn.Add->Number(&__sn, #key, value)
-#define NPJSON_Object_SetString(key, value) __sn.Add->String(&__sn, #key, value)
-#define NPJSON_Object_SetBool(key, value)   __sn.Add->Bool(&__sn, #key, value)
-#define NPJSON_Object_SetNull(key, value)   __sn.Add->String(&__sn, #key, NULL)
-#define NPJSON_Object_Start(key)            __sn.StartObject(&__sn, #key)
+// 编译期生成 "key": 及其长度，skey 为 #key，"NULL" 表示没有名称
+#define __npjson_key(skey)                                   \
+    (strcmp(skey, "NULL") == 0 ? NULL : "\"" skey "\":"), \
+        (int)sizeof("\"" skey "\":") - 1
+
+#define NPJSON_Object_SetInt(key, value)    __sn.AddKey->Int(&__sn, __npjson_key(#key), value)
+#define NPJSON_Object_SetNumber(key, value) __sn.AddKey->Number(&__sn, __npjson_key(#key), value)
+#define NPJSON_Object_SetString(key, value) __sn.AddKey->String(&__sn, __npjson_key(#key), value)
+#define NPJSON_Object_SetBool(key, value)   __sn.AddKey->Bool(&__sn, __npjson_key(#key), value)
+#define NPJSON_Object_SetNull(key, value)   __sn.AddKey->String(&__sn, __npjson_key(#key), NULL)
+#define NPJSON_Object_Start(key)            __sn.AddKey->StartObject(&__sn, __npjson_key(#key))
 #define NPJSON_Object_End()                 __sn.EndObject(&__sn)
-#define NPJSON_Array_Start(key)             __sn.StartArray(&__sn, #key)
+#define NPJSON_Array_Start(key)             __sn.AddKey->StartArray(&__sn, __npjson_key(#key))
 #define NPJSON_Array_End()                  __sn.EndArray(&__sn)
 #define NPJSON_Array_AddInt(value)          __sn.AddArrayItem->Int(&__sn, value)
 #define NPJSON_Array_AddNumber(value)       __sn.AddArrayItem->Number(&__sn, value)
 #define NPJSON_Array_AddString(value)       __sn.AddArrayItem->String(&__sn, value)
 #define NPJSON_Array_AddBool(value)         __sn.AddArrayItem->Bool(&__sn, value)
 
+#define NPJSON_Object_SetInt32Array(key, value, count)  __sn.AddKey->Int32List(&__sn, __npjson_key(#key), value, count)
+#define NPJSON_Object_SetInt64Array(key, value, count)  __sn.AddKey->Int64List(&__sn, __npjson_key(#key), value, count)
+#define NPJSON_Object_SetFloatArray(key, value, count)  __sn.AddKey->FloatList(&__sn, __npjson_key(#key), value, count)
+#define NPJSON_Object_SetDoubleArray(key, value, count) __sn.AddKey->DoubleList(&__sn, __npjson_key(#key), value, count)
+#define NPJSON_Object_SetBoolArray(key, value, count)   __sn.AddKey->BoolList(&__sn, __npjson_key(#key), value, count)
+#define NPJSON_Object_SetStringArray(key, value, count) __sn.AddKey->StringList(&__sn, __npjson_key(#key), value, count)
+
 /**
  * @brief    序列化完成
  * @author   CXS (chenxiangshu@outlook.com)
@@ -633,34 +1659,58 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
         break;                                 \
     }
 
-#define __npjson_object_get(name, check, type, field, ret) \
+#define __npjson_object_get(name, check, type, value, ret) \
     __npjson_find(name);                                   \
     __npjson_check_object_type(name, check, type);         \
-    (ret) = __ptr->Val.field
+    (ret) = (value)
 
-#define __npjson_array_get(check, type, field, ret) \
+#define __npjson_array_get(check, type, value, ret) \
     if (__ptr == NULL || __is_err)                  \
         break;                                      \
     __npjson_check_array_type(check, type);         \
-    (ret) = __ptr->Val.field;                       \
+    (ret) = (value);                                \
     __ptr = __ptr->next
 
+// 原文存储的数值（lazyNumber）调用转换
+#define __npjson_int(n)    ((n)->isRaw ? NPJSON_GetInt(n) : (n)->Val.Value)
+#define __npjson_number(n) ((n)->isRaw ? NPJSON_GetNumber(n) : (n)->Val.Number)
+
+#define __npjson_packed_get(ret)                                      \
+    if (__is_err || __pidx >= __obj->Val.Packed.Count)                \
+        break;                                                        \
+    if (__obj->isPackedInt)                                           \
+        (ret) = ((const int64_t *)__obj->Val.Packed.Data)[__pidx++]; \
+    else                                                              \
+        (ret) = ((const double *)__obj->Val.Packed.Data)[__pidx++]
+
 /**
  * @brief    开始解析JSON
  * @author   CXS (chenxiangshu@outlook.com)
  * @date     2024-07-23
  */
-#define NPJSON_Builder_Begin(str, len, msg)                   \
-    do {                                                      \
-        msg                 = NULL;                           \
-        const char **__err  = &msg;                           \
-        NPJSONNode * __root = NPJSON_Builder(str, len, &msg); \
-        if (__root == NULL || msg != NULL)                    \
-            break;                                            \
-        NPJSONNode *__obj    = __root;                        \
-        NPJSONNode *__ptr    = __obj->Val.Object;             \
-        NPJSONNode *__tmp    = NULL;                          \
-        bool        __is_err = false;                         \
+#define NPJSON_Builder_Begin(str, len, msg) NPJSON_Builder_BeginEx(str, len, NULL, msg)
+
+/**
+ * @brief    开始解析JSON（指定生成选项）
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ */
+#define NPJSON_Builder_BeginEx(str, len, opt, msg)                      \
+    do {                                                                \
+        msg                 = NULL;                                     \
+        const char **__err  = &msg;                                     \
+        const NPJSON_Option *__opt = (opt);                             \
+        const NPJSON_Allocator *__alloc = __opt ? __opt->alloc : NULL;  \
+        NPJSONNode * __root = NPJSON_BuilderEx(str, len, __opt, &msg);  \
+        if (__root == NULL || msg != NULL)                              \
+            break;                                                      \
+        NPJSONNode *__obj    = __root;                                  \
+        NPJSONNode *__ptr    = NPJSON_GetChild(__obj);                  \
+        NPJSONNode *__tmp    = NULL;                                    \
+        size_t      __pidx   = 0;                                       \
+        bool        __is_err = false;                                   \
+        (void)__pidx;                                                   \
+        (void)__tmp;                                                    \
         do {
 
 /**
@@ -668,12 +1718,12 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
  * @author   CXS (chenxiangshu@outlook.com)
  * @date     2024-07-23
  */
-#define NPJSON_Builder_End() \
-    }                        \
-    while (false)            \
-        ;                    \
-    NPJSON_Release(&__root); \
-    }                        \
+#define NPJSON_Builder_End()            \
+    }                                   \
+    while (false)                       \
+        ;                               \
+    NPJSON_ReleaseEx(&__root, __alloc); \
+    }                                   \
     while (false)
 
 #define NPJSON_Object_Enter(name)                                      \
@@ -686,8 +1736,10 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
     __tmp = __ptr;                                                     \
     __ptr = __ptr->next;                                               \
     {                                                                  \
-        NPJSONNode *__obj = __tmp;                                     \
-        NPJSONNode *__ptr = __obj->Val.Object;
+        NPJSONNode *__obj  = __tmp;                                    \
+        NPJSONNode *__ptr  = NPJSON_GetChild(__obj);                   \
+        size_t      __pidx = 0;                                        \
+        (void)__pidx;
 
 #define NPJSON_Object_Exit() }
 
@@ -701,59 +1753,68 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
     __tmp = __ptr;                                                   \
     __ptr = __ptr->next;                                             \
     {                                                                \
-        NPJSONNode *__obj = __tmp;                                   \
-        NPJSONNode *__ptr = __obj->Val.Object;
+        NPJSONNode *__obj  = __tmp;                                  \
+        NPJSONNode *__ptr  = NPJSON_GetChild(__obj);                 \
+        size_t      __pidx = 0;                                      \
+        (void)__pidx;
 
 #define NPJSON_Array_Exit() }
 
 #define NPJSON_Object_GetInt(name, ret) \
     __npjson_object_get(                \
-        name, (__ptr->isInteger || __ptr->isNumber), "Int", Value, ret)
+        name, (__ptr->isInteger || __ptr->isNumber), "Int", __npjson_int(__ptr), ret)
 
 #define NPJSON_Object_GetNumber(name, ret) \
-    __npjson_object_get(name, (__ptr->isNumber || __ptr->isInteger), "Number", Number, ret)
+    __npjson_object_get(name, (__ptr->isNumber || __ptr->isInteger), "Number", __npjson_number(__ptr), ret)
 
 #define NPJSON_Object_GetBool(name, ret) \
-    __npjson_object_get(name, (__ptr->isBinValue), "Bool", BinValue, ret)
-
-#define NPJSON_Object_GetString(name, ret, capacity)                                            \
-    {                                                                                           \
-        const char *__str = NULL;                                                               \
-        __npjson_object_get(name, (__ptr->isString || __ptr->isNull), "String", String, __str); \
-        if (__str == NULL || (capacity) == 0)                                                   \
-            ;                                                                                   \
-        else {                                                                                  \
-            size_t __s = strlen(__str);                                                         \
-            if (__s >= (capacity)-1)                                                            \
-                __s = (capacity)-1;                                                             \
-            memcpy(ret, __str, __s);                                                            \
-            (ret)[__s] = '\0';                                                                  \
-        }                                                                                       \
+    __npjson_object_get(name, (__ptr->isBinValue), "Bool", __ptr->Val.BinValue, ret)
+
+#define NPJSON_Object_GetString(name, ret, capacity)                                                       \
+    {                                                                                                      \
+        const char *__str = NULL;                                                                          \
+        __npjson_object_get(name, (__ptr->isString || __ptr->isNull), "String", __ptr->Val.String, __str); \
+        if (__str == NULL || (capacity) == 0)                                                              \
+            ;                                                                                              \
+        else {                                                                                             \
+            size_t __s = strlen(__str);                                                                    \
+            if (__s >= (capacity)-1)                                                                       \
+                __s = (capacity)-1;                                                                        \
+            memcpy(ret, __str, __s);                                                                       \
+            (ret)[__s] = '\0';                                                                             \
+        }                                                                                                  \
     }
 
-#define NPJSON_Array_GetInt(ret) \
-    __npjson_array_get(          \
-        (__ptr->isInteger || __ptr->isNumber), "Int", Value, ret)
+#define NPJSON_Array_GetInt(ret)                                                   \
+    if (__obj->isPacked) {                                                     \
+        __npjson_packed_get(ret);                                              \
+    } else {                                                                   \
+        __npjson_array_get((__ptr->isInteger || __ptr->isNumber), "Int", __npjson_int(__ptr), ret); \
+    }
 
-#define NPJSON_Array_GetNumber(ret) \
-    __npjson_array_get((__ptr->isNumber || __ptr->isInteger), "Number", Number, ret)
+#define NPJSON_Array_GetNumber(ret)                                                       \
+    if (__obj->isPacked) {                                                                \
+        __npjson_packed_get(ret);                                                         \
+    } else {                                                                              \
+        __npjson_array_get((__ptr->isNumber || __ptr->isInteger), "Number", __npjson_number(__ptr), ret); \
+    }
 
 #define NPJSON_Array_GetBool(name, ret) \
-    __npjson_array_get((__ptr->isBinValue), "Bool", BinValue, ret)
-
-#define NPJSON_Array_GetString(ret, capacity)                                            \
-    {                                                                                    \
-        const char *__str = NULL;                                                        \
-        __npjson_array_get((__ptr->isString || __ptr->isNull), "String", String, __str); \
-        if (__str == NULL || (capacity) <= 0)                                            \
-            ;                                                                            \
-        else {                                                                           \
-            size_t __s = strlen(__str);                                                  \
-            if (__s >= (capacity)-1)                                                     \
-                __s = (capacity)-1;                                                      \
-            memcpy(ret, __str, __s);                                                     \
-            (ret)[__s] = '\0';                                                           \
-        }                                                                                \
+    __npjson_array_get((__ptr->isBinValue), "Bool", __ptr->Val.BinValue, ret)
+
+#define NPJSON_Array_GetString(ret, capacity)                                                       \
+    {                                                                                               \
+        const char *__str = NULL;                                                                   \
+        __npjson_array_get((__ptr->isString || __ptr->isNull), "String", __ptr->Val.String, __str); \
+        if (__str == NULL || (capacity) <= 0)                                                       \
+            ;                                                                                       \
+        else {                                                                                      \
+            size_t __s = strlen(__str);                                                             \
+            if (__s >= (capacity)-1)                                                                \
+                __s = (capacity)-1;                                                                 \
+            memcpy(ret, __str, __s);                                                                \
+            (ret)[__s] = '\0';                                                                      \
+        }                                                                                           \
     }
 
 /**
@@ -770,7 +1831,7 @@ extern NPJSONNode *NPJSON_GetNext(NPJSONNode *n);
  * @author   CXS (chenxiangshu@outlook.com)
  * @date     2024-07-23
  */
-#define NPJSON_Array_IsNull(ret) (ret) = __ptr ? __ptr->isNull : true
+#define NPJSON_Array_IsNull(ret) (ret) = __obj->isPacked ? __pidx >= __obj->Val.Packed.Count : (__ptr ? __ptr->isNull : true)
 
 /**
  * @brief    获取数组数量
@@ -0,0 +1,523 @@
+/**
+ * @file     NPJSON.hpp
+ * @brief    NPJSON 的 C++ 封装（仅头文件，需要 C++17）
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * 所有权类型只能移动，转移所有权不再调用 NPJSON_SynthesizerClone/NPJSON_SObjectClone 复制内容；
+ * 共享类型（SharedSObject/SharedRObject）复制只增加引用计数。
+ * 字符串通过 std::string_view 直接指向文档内容，不再 strlen + memcpy。
+ *
+ *  npjson::Synthesizer sn(256);
+ *  sn->Add->Int(sn.get(), "id", 1);
+ *  npjson::SObject out = sn.finish();           // 合成器内容转移给 out
+ *  npjson::Document doc(out.view());
+ *  for (npjson::Node n : doc.root())
+ *      use(n.name(), n.getString());
+ */
+#ifndef __NPJSON_HPP__
+#define __NPJSON_HPP__
+
+#if __cplusplus < 201703L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "NPJSON.hpp requires C++17"
+#endif
+
+#include "NPJSON.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace npjson {
+
+// 连续内存只读视图（紧凑数组）
+template <class T>
+class Span
+{
+public:
+    Span() = default;
+    Span(const T *data, size_t size) : data_(data), size_(size) {}
+
+    const T *data() const { return data_; }
+    size_t   size() const { return size_; }
+    bool     empty() const { return size_ == 0; }
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size_; }
+    const T &operator[](size_t i) const { return data_[i]; }
+
+private:
+    const T *data_ = nullptr;
+    size_t   size_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 合成对象 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+class SharedSObject;
+
+// 独占合成对象（只能移动）
+class SObject
+{
+public:
+    SObject() { clear(); }
+    explicit SObject(NPJSON_SObject obj) : obj_(obj) {}
+    SObject(const SObject &) = delete;
+    SObject &operator=(const SObject &) = delete;
+    SObject(SObject &&o) noexcept : obj_(o.obj_) { o.clear(); }
+    SObject &operator=(SObject &&o) noexcept
+    {
+        if (this != &o) {
+            reset();
+            obj_ = o.obj_;
+            o.clear();
+        }
+        return *this;
+    }
+    ~SObject() { reset(); }
+
+    explicit operator bool() const { return obj_.str != nullptr; }
+    std::string_view view() const { return obj_.str ? std::string_view(obj_.str, obj_.Strlength) : std::string_view(); }
+    const char *     c_str() const { return obj_.str; }
+    NPJSON_SObject * get() { return &obj_; }
+
+    // 交出 C 对象 之后由调用者 NPJSON_DeleteSObject
+    NPJSON_SObject release()
+    {
+        NPJSON_SObject o = obj_;
+        clear();
+        return o;
+    }
+
+    void reset()
+    {
+        NPJSON_DeleteSObject(&obj_);
+        clear();
+    }
+
+    // 转为共享对象（不复制）
+    SharedSObject share() &&;
+
+private:
+    void clear() { obj_ = NPJSON_SObject{nullptr, 0, nullptr, nullptr}; }
+
+    NPJSON_SObject obj_;
+};
+
+// 共享合成对象（复制只增加引用计数 内容只读）
+class SharedSObject
+{
+public:
+    SharedSObject() : obj_{nullptr, 0, nullptr, nullptr} {}
+    SharedSObject(const SharedSObject &o) : obj_(NPJSON_SObjectClone(&o.obj_)) {}
+    SharedSObject &operator=(const SharedSObject &o)
+    {
+        if (this != &o) {
+            SharedSObject t(o);
+            std::swap(obj_, t.obj_);
+        }
+        return *this;
+    }
+    SharedSObject(SharedSObject &&o) noexcept : obj_(o.obj_) { o.obj_ = NPJSON_SObject{nullptr, 0, nullptr, nullptr}; }
+    SharedSObject &operator=(SharedSObject &&o) noexcept
+    {
+        std::swap(obj_, o.obj_);
+        return *this;
+    }
+    ~SharedSObject() { NPJSON_DeleteSObject(&obj_); }
+
+    explicit operator bool() const { return obj_.str != nullptr; }
+    std::string_view      view() const { return obj_.str ? std::string_view(obj_.str, obj_.Strlength) : std::string_view(); }
+    const char *          c_str() const { return obj_.str; }
+    const NPJSON_SObject *get() const { return &obj_; }
+
+private:
+    friend class SObject;
+    explicit SharedSObject(NPJSON_SObject obj) : obj_(obj) {}
+
+    NPJSON_SObject obj_;
+};
+
+inline SharedSObject SObject::share() &&
+{
+    NPJSON_SObject o = release();
+    if (o.str != nullptr && !NPJSON_SObjectShare(&o)) {
+        NPJSON_DeleteSObject(&o);
+        o = NPJSON_SObject{nullptr, 0, nullptr, nullptr};
+    }
+    return SharedSObject(o);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 合成器 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// JSON 合成器（只能移动）
+class Synthesizer
+{
+public:
+    explicit Synthesizer(int size = 256, const NPJSON_Allocator *alloc = nullptr) : sn_(NPJSON_CreateSynthesizerEx(size, alloc)) {}
+    Synthesizer(const Synthesizer &) = delete;
+    Synthesizer &operator=(const Synthesizer &) = delete;
+    Synthesizer(Synthesizer &&o) noexcept : sn_(o.sn_) { o.sn_.str = o.sn_.idx = o.sn_.endidx = nullptr; }
+    Synthesizer &operator=(Synthesizer &&o) noexcept
+    {
+        if (this != &o) {
+            NPJSON_DeleteSynthesizer(&sn_);
+            sn_     = o.sn_;
+            o.sn_.str = o.sn_.idx = o.sn_.endidx = nullptr;
+        }
+        return *this;
+    }
+    ~Synthesizer() { NPJSON_DeleteSynthesizer(&sn_); }
+
+    explicit operator bool() const { return sn_.str != nullptr; }
+    NPJSON_Synthesizer *get() { return &sn_; }
+    NPJSON_Synthesizer *operator->() { return &sn_; }
+
+    // 结束根对象并转移内容（合成器随后为空）
+    SObject finish() { return SObject(NPJSON_CreateSObject(&sn_)); }
+
+private:
+    NPJSON_Synthesizer sn_;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 解析对象 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// 安全解析对象（只能移动）
+class RObject
+{
+public:
+    RObject() { clear(); }
+    explicit RObject(std::string_view json) : obj_(NPJSON_ResolveToSafeObject(json.data(), (int)json.size())) {}
+    explicit RObject(NPJSON_RObject obj) : obj_(obj) {}
+    RObject(const RObject &) = delete;
+    RObject &operator=(const RObject &) = delete;
+    RObject(RObject &&o) noexcept : obj_(o.obj_) { o.clear(); }
+    RObject &operator=(RObject &&o) noexcept
+    {
+        if (this != &o) {
+            NPJSON_DeleteSafeObject(&obj_);
+            obj_ = o.obj_;
+            o.clear();
+        }
+        return *this;
+    }
+    ~RObject() { NPJSON_DeleteSafeObject(&obj_); }
+
+    explicit operator bool() const { return obj_.str != nullptr; }
+    std::string_view view() const { return obj_.str ? std::string_view(obj_.str, obj_.Strlength) : std::string_view(); }
+    NPJSON_RObject * get() { return &obj_; }
+
+    bool resolve(void *obj, NPJSON_ResolveFunc fun) { return obj_.str != nullptr && obj_.Resolve(&obj_, obj, fun); }
+
+private:
+    void clear()
+    {
+        obj_           = NPJSON_RObject();
+        obj_.isSafe    = true;
+        obj_.str       = nullptr;
+        obj_.Strlength = 0;
+    }
+
+    NPJSON_RObject obj_;
+};
+
+// 共享解析对象（复制只增加引用计数 内容只读）
+class SharedRObject
+{
+public:
+    SharedRObject() : obj_() {}
+    explicit SharedRObject(std::string_view json) : obj_(NPJSON_ResolveToSharedObject(json.data(), (int)json.size())) {}
+    // 回调中的子对象 只增加引用计数（父对象为共享对象时）
+    explicit SharedRObject(const NPJSON_Result *re) : obj_(NPJSON_CreateSafeObject(re)) { NPJSON_RObjectShare(&obj_); }
+    explicit SharedRObject(RObject &&o)
+    {
+        obj_ = *o.get();
+        *o.get() = NPJSON_RObject();
+        NPJSON_RObjectShare(&obj_);
+    }
+    SharedRObject(const SharedRObject &o) : obj_(NPJSON_SafeRObjectClone(&o.obj_)) {}
+    SharedRObject &operator=(const SharedRObject &o)
+    {
+        if (this != &o) {
+            SharedRObject t(o);
+            std::swap(obj_, t.obj_);
+        }
+        return *this;
+    }
+    SharedRObject(SharedRObject &&o) noexcept : obj_(o.obj_) { o.obj_ = NPJSON_RObject(); }
+    SharedRObject &operator=(SharedRObject &&o) noexcept
+    {
+        std::swap(obj_, o.obj_);
+        return *this;
+    }
+    ~SharedRObject() { NPJSON_DeleteSafeObject(&obj_); }
+
+    explicit operator bool() const { return obj_.str != nullptr; }
+    std::string_view      view() const { return obj_.str ? std::string_view(obj_.str, obj_.Strlength) : std::string_view(); }
+    const NPJSON_RObject *get() const { return &obj_; }
+
+    bool resolve(void *obj, NPJSON_ResolveFunc fun)
+    {
+        return obj_.str != nullptr && obj_.Resolve(&obj_, obj, fun);
+    }
+
+private:
+    NPJSON_RObject obj_;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 生成对象 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// 文档节点（不拥有 由 Document 管理）
+class Node
+{
+public:
+    class iterator
+    {
+    public:
+        explicit iterator(NPJSONNode *n) : n_(n) {}
+        Node      operator*() const { return Node(n_); }
+        iterator &operator++()
+        {
+            n_ = n_->next;
+            return *this;
+        }
+        bool operator!=(const iterator &o) const { return n_ != o.n_; }
+        bool operator==(const iterator &o) const { return n_ == o.n_; }
+
+    private:
+        NPJSONNode *n_;
+    };
+
+    Node() = default;
+    explicit Node(NPJSONNode *n) : n_(n) {}
+
+    explicit operator bool() const { return n_ != nullptr; }
+    NPJSONNode *get() const { return n_; }
+
+    bool isObject() const { return n_ && n_->isObject; }
+    bool isArray() const { return n_ && n_->isArray; }
+    bool isString() const { return n_ && n_->isString; }
+    bool isNumber() const { return n_ && n_->isNumber; }
+    bool isInteger() const { return n_ && n_->isInteger; }
+    bool isBool() const { return n_ && n_->isBinValue; }
+    bool isNull() const { return n_ && n_->isNull; }
+    bool isPacked() const { return n_ && n_->isPacked; }
+
+    // 成员名称 数组元素为空
+    std::string_view name() const { return n_ && n_->name ? std::string_view(n_->name) : std::string_view(); }
+
+    // 子节点数量（紧凑数组为元素数量）
+    size_t size() const { return n_ && (n_->isObject || n_->isArray) ? n_->Val.ChildCount : 0; }
+
+    // 按名称查找子节点 未找到返回空节点
+    Node find(std::string_view key) const
+    {
+        if (!n_ || !n_->isObject || n_->isPacked)
+            return Node();
+        for (NPJSONNode *c = NPJSON_GetChild(n_); c != nullptr; c = c->next)
+            if (c->name != nullptr && key == c->name)
+                return Node(c);
+        return Node();
+    }
+    Node operator[](std::string_view key) const { return find(key); }
+
+    // 子节点遍历（紧凑数组没有子节点 使用 packedInt64/packedDouble）
+    iterator begin() const { return iterator(NPJSON_GetChild(n_)); }
+    iterator end() const { return iterator(nullptr); }
+
+    long long getInt(long long def = 0) const
+    {
+        return n_ && (n_->isNumber || n_->isInteger || n_->isBinValue) ? NPJSON_GetInt(n_) : def;
+    }
+    double getNumber(double def = 0) const
+    {
+        return n_ && (n_->isNumber || n_->isInteger || n_->isBinValue) ? NPJSON_GetNumber(n_) : def;
+    }
+    bool getBool(bool def = false) const
+    {
+        if (n_ && n_->isBinValue)
+            return n_->Val.BinValue;
+        return n_ && n_->isNumber ? NPJSON_GetNumber(n_) != 0 : def;
+    }
+    // 数值原文（NPJSON_Option.lazyNumber）
+    std::string_view raw() const
+    {
+        size_t      len = 0;
+        const char *r   = NPJSON_GetRaw(n_, &len);
+        return r ? std::string_view(r, len) : std::string_view();
+    }
+    // 字符串 直接指向文档内容
+    std::string_view getString(std::string_view def = std::string_view()) const
+    {
+        return n_ && n_->isString && n_->Val.String ? std::string_view(n_->Val.String, n_->Val.StrLength) : def;
+    }
+
+    Span<int64_t> packedInt64() const
+    {
+        size_t         n = 0;
+        const int64_t *p = NPJSON_GetPackedInt64(n_, &n);
+        return Span<int64_t>(p, p ? n : 0);
+    }
+    Span<double> packedDouble() const
+    {
+        size_t        n = 0;
+        const double *p = NPJSON_GetPackedDouble(n_, &n);
+        return Span<double>(p, p ? n : 0);
+    }
+
+private:
+    NPJSONNode *n_ = nullptr;
+};
+
+// 生成文档（只能移动）
+class Document
+{
+public:
+    Document() = default;
+    explicit Document(std::string_view json, const NPJSON_Option *opt = nullptr)
+        : n_(NPJSON_BuilderEx(json.data(), json.size(), opt, &err_)), alloc_(opt ? opt->alloc : nullptr)
+    {
+    }
+    explicit Document(NPJSONNode *n, const NPJSON_Allocator *alloc = nullptr) : n_(n), alloc_(alloc) {}
+    Document(const Document &) = delete;
+    Document &operator=(const Document &) = delete;
+    Document(Document &&o) noexcept : err_(o.err_), n_(o.n_), alloc_(o.alloc_) { o.n_ = nullptr; }
+    Document &operator=(Document &&o) noexcept
+    {
+        if (this != &o) {
+            NPJSON_ReleaseEx(&n_, alloc_);
+            n_     = o.n_;
+            alloc_ = o.alloc_;
+            err_   = o.err_;
+            o.n_   = nullptr;
+        }
+        return *this;
+    }
+    ~Document() { NPJSON_ReleaseEx(&n_, alloc_); }
+
+    explicit operator bool() const { return n_ != nullptr; }
+    Node        root() const { return Node(n_); }
+    Node        operator[](std::string_view key) const { return root().find(key); }
+    const char *error() const { return err_; }   // 生成失败的位置
+
+    // 序列化为紧凑 JSON
+    SObject print() const { return SObject(NPJSON_Print(n_)); }
+
+    // 交出根节点 之后由调用者 NPJSON_ReleaseEx
+    NPJSONNode *release()
+    {
+        NPJSONNode *n = n_;
+        n_            = nullptr;
+        return n;
+    }
+
+private:
+    const char *            err_   = nullptr;   // 先于 n_ 初始化
+    NPJSONNode *            n_     = nullptr;
+    const NPJSON_Allocator *alloc_ = nullptr;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | 拉取游标 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// 拉取游标（只能移动）
+class Cursor
+{
+public:
+    explicit Cursor(std::string_view json, const NPJSON_Allocator *alloc = nullptr) : c_(NPJSON_CreateCursorEx(json.data(), json.size(), alloc)) {}
+    Cursor(const Cursor &) = delete;
+    Cursor &operator=(const Cursor &) = delete;
+    Cursor(Cursor &&o) noexcept : c_(o.c_) { o.c_ = nullptr; }
+    Cursor &operator=(Cursor &&o) noexcept
+    {
+        std::swap(c_, o.c_);
+        return *this;
+    }
+    ~Cursor() { NPJSON_DeleteCursor(c_); }
+
+    explicit operator bool() const { return c_ != nullptr && NPJSON_CursorError(c_) == nullptr; }
+    NPJSON_Cursor *get() const { return c_; }
+
+    bool             next() { return NPJSON_CursorNext(c_); }
+    bool             enter() { return NPJSON_CursorEnter(c_); }
+    bool             skip() { return NPJSON_CursorSkip(c_); }
+    NPJSON_TokenType type() const { return NPJSON_CursorType(c_); }
+    int              depth() const { return NPJSON_CursorDepth(c_); }
+    const char *     error() const { return NPJSON_CursorError(c_); }
+    long long        getInt() const { return NPJSON_CursorGetInt(c_); }
+    double           getNumber() const { return NPJSON_CursorGetNumber(c_); }
+    bool             getBool() const { return NPJSON_CursorGetBool(c_); }
+
+    std::string_view key() const
+    {
+        const char *k = NPJSON_CursorKey(c_);
+        return k ? std::string_view(k) : std::string_view();
+    }
+    // 下一次 getString/next 前有效
+    std::string_view getString()
+    {
+        int         n = 0;
+        const char *s = NPJSON_CursorGetString(c_, &n);
+        return s ? std::string_view(s, n) : std::string_view();
+    }
+
+private:
+    NPJSON_Cursor *c_;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+//                                             | JSON 模板 |
+// ---------------------------------------------------------------------------------------------------------------------
+
+// JSON 模板（只能移动）
+class Template
+{
+public:
+    explicit Template(const char *tpl, const NPJSON_Allocator *alloc = nullptr) : t_(NPJSON_CompileTemplateEx(tpl, alloc, &err_)) {}
+    Template(const Template &) = delete;
+    Template &operator=(const Template &) = delete;
+    Template(Template &&o) noexcept : err_(o.err_), t_(o.t_) { o.t_ = nullptr; }
+    Template &operator=(Template &&o) noexcept
+    {
+        std::swap(t_, o.t_);
+        std::swap(err_, o.err_);
+        return *this;
+    }
+    ~Template() { NPJSON_DeleteTemplate(t_); }
+
+    explicit operator bool() const { return t_ != nullptr; }
+    const NPJSON_Template *get() const { return t_; }
+    const char *          error() const { return err_; }   // 编译失败的位置
+
+    // 参数类型必须与值槽一致：%d int %l long long %f double %b bool %s/%r const char *
+    template <class... A>
+    SObject render(A... a) const
+    {
+        return SObject(NPJSON_TemplateRender(t_, a...));
+    }
+    template <class... A>
+    size_t renderTo(char *buf, size_t size, A... a) const
+    {
+        return NPJSON_TemplateRenderTo(t_, buf, size, a...);
+    }
+
+private:
+    const char *     err_ = nullptr;   // 先于 t_ 初始化
+    NPJSON_Template *t_;
+};
+
+}   // namespace npjson
+
+#endif
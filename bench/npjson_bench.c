@@ -0,0 +1,810 @@
+/**
+ * @file     npjson_bench.c
+ * @brief    NPJSON 吞吐量测试
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * 用法：npjson_bench [--quick] [--scale N] [--json FILE] [--file PATH]...
+ *   --quick   每项只运行很短时间（冒烟测试）
+ *   --scale   语料规模倍数（默认 1，约 1MB/份）
+ *   --json    结果以 JSON 写入 FILE（"-" 为标准输出），用于回归对比
+ *   --file    追加外部语料（例如真实的 twitter.json）
+ *
+ * 内置语料在运行时按固定种子生成，内容结构仿照常用测试集：
+ *   twitter  字符串为主，含转义、\uXXXX 及嵌套对象
+ *   citm     大量短名称、整数及对象数组
+ *   canada   坐标数组，浮点为主
+ *   deep     深层嵌套对象
+ *   wide     单层大量字段
+ *   numeric  整型、浮点大数组
+ */
+#include "NPJSON.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 内存分配统计  |
+// ----------------------------------------------------------------------------------------------------
+
+static size_t g_allocs = 0;   // 分配次数（含重新分配）
+
+void *NPJSON_Malloc(size_t size)
+{
+    g_allocs++;
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    g_allocs++;
+    return realloc(ptr, size);
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 计时  |
+// ----------------------------------------------------------------------------------------------------
+
+static double _Now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 语料生成  |
+// ----------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+    char * str;
+    size_t len;
+    size_t cap;
+} Text;
+
+static void _Put(Text *t, const char *s, size_t n)
+{
+    if (t->len + n + 1 > t->cap) {
+        t->cap = (t->len + n + 1) * 2;
+        t->str = (char *)realloc(t->str, t->cap);
+        if (t->str == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(t->str + t->len, s, n);
+    t->len += n;
+    t->str[t->len] = '\0';
+}
+
+static void _Puts(Text *t, const char *s)
+{
+    _Put(t, s, strlen(s));
+}
+
+static void _Printf(Text *t, const char *fmt, ...)
+{
+    char    buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    _Put(t, buf, n < 0 ? 0 : (size_t)n >= sizeof(buf) ? sizeof(buf) - 1 : (size_t)n);
+}
+
+static unsigned long long g_seed = 0x2545F4914F6CDD1DULL;
+
+static unsigned _Rand(void)
+{
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return (unsigned)(g_seed >> 16);
+}
+
+static void _Word(Text *t)
+{
+    static const char *WORDS[] = {"json", "parser", "fast", "the", "quick", "brown", "fox", "\\u00e9t\\u00e9",
+                                  "\\\"quoted\\\"", "line\\nbreak", "\\u4e2d\\u6587", "tab\\t", "http:\\/\\/x.io", "RT", "@user", "#tag"};
+    _Puts(t, WORDS[_Rand() % (sizeof(WORDS) / sizeof(WORDS[0]))]);
+}
+
+static void _Sentence(Text *t, int words)
+{
+    _Puts(t, "\"");
+    for (int i = 0; i < words; i++) {
+        if (i != 0)
+            _Puts(t, " ");
+        _Word(t);
+    }
+    _Puts(t, "\"");
+}
+
+static void _GenTwitter(Text *t, size_t target)
+{
+    _Puts(t, "{\"statuses\":[");
+    for (int i = 0; t->len < target; i++) {
+        if (i != 0)
+            _Puts(t, ",");
+        _Printf(t, "{\"created_at\":\"Sun Aug 31 00:29:%02d +0000 2014\",\"id\":%llu,\"id_str\":\"%llu\",\"text\":",
+                i % 60, 505874924095815681ULL + i, 505874924095815681ULL + i);
+        _Sentence(t, 8 + _Rand() % 12);
+        _Printf(t, ",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":%u,\"name\":", _Rand());
+        _Sentence(t, 2);
+        _Printf(t, ",\"screen_name\":\"user%u\",\"location\":\"\",\"description\":", _Rand() % 100000);
+        _Sentence(t, 10);
+        _Printf(t, ",\"followers_count\":%u,\"friends_count\":%u,\"verified\":%s,\"lang\":\"ja\"}",
+                _Rand() % 100000, _Rand() % 5000, _Rand() % 2 ? "true" : "false");
+        _Printf(t, ",\"entities\":{\"hashtags\":[],\"urls\":[],\"user_mentions\":[{\"screen_name\":\"u%u\",\"indices\":[%u,%u]}]}",
+                _Rand() % 1000, _Rand() % 10, 10 + _Rand() % 10);
+        _Printf(t, ",\"retweet_count\":%u,\"favorite_count\":%u,\"favorited\":false,\"retweeted\":false}", _Rand() % 1000, _Rand() % 1000);
+    }
+    _Puts(t, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":100}}");
+}
+
+static void _GenCitm(Text *t, size_t target)
+{
+    _Puts(t, "{\"areaNames\":{\"205705993\":\"Arri\\u00e8re-sc\\u00e8ne central\",\"205705994\":\"1er balcon central\"},\"events\":{");
+    int i;
+    for (i = 0; t->len < target / 3; i++) {
+        if (i != 0)
+            _Puts(t, ",");
+        _Printf(t, "\"%d\":{\"description\":null,\"id\":%d,\"logo\":\"\\/images\\/UGC%04d.png\",\"name\":\"Event %d\","
+                   "\"subTopicIds\":[%u,%u,%u],\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[%u,%u]}",
+                138586341 + i, 138586341 + i, i, i, _Rand() % 1000000, _Rand() % 1000000, _Rand() % 1000000,
+                _Rand() % 1000000, _Rand() % 1000000);
+    }
+    _Puts(t, "},\"performances\":[");
+    for (i = 0; t->len < target; i++) {
+        if (i != 0)
+            _Puts(t, ",");
+        _Printf(t, "{\"eventId\":%d,\"id\":%d,\"logo\":null,\"name\":null,\"prices\":[", 138586341 + i % 100, 339887544 + i);
+        int n = 2 + _Rand() % 4;
+        for (int k = 0; k < n; k++)
+            _Printf(t, "%s{\"amount\":%u,\"audienceSubCategoryId\":337100890,\"seatCategoryId\":%u}", k ? "," : "",
+                    9000 + _Rand() % 90000, 338937295 + _Rand() % 10);
+        _Printf(t, "],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]}],\"seatCategoryId\":%u}],"
+                   "\"seatMapImage\":null,\"start\":%llu,\"venueCode\":\"PLEYEL_PLEYEL\"}",
+                338937295 + _Rand() % 10, 1372701600000ULL + i * 86400000ULL);
+    }
+    _Puts(t, "],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}");
+}
+
+static void _GenCanada(Text *t, size_t target)
+{
+    _Puts(t, "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+             "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+    for (int r = 0; t->len < target; r++) {
+        _Puts(t, r ? ",[" : "[");
+        for (int i = 0; i < 512; i++)
+            _Printf(t, "%s[%.15g,%.15g]", i ? "," : "", -65.613616999999977 + (_Rand() % 100000) * 1e-5,
+                    43.420273000000009 + (_Rand() % 100000) * 1e-5);
+        _Puts(t, "]");
+    }
+    _Puts(t, "]}}]}");
+}
+
+static void _GenDeep(Text *t, size_t target)
+{
+    _Puts(t, "{");
+    for (int i = 0; t->len < target; i++) {
+        if (i != 0)
+            _Puts(t, ",");
+        _Printf(t, "\"n%d\":", i);
+        for (int d = 0; d < 100; d++)
+            _Printf(t, "{\"v\":%d,\"s\":\"level\",\"c\":", d);
+        _Puts(t, "null");
+        for (int d = 0; d < 100; d++)
+            _Puts(t, "}");
+    }
+    _Puts(t, "}");
+}
+
+static void _GenWide(Text *t, size_t target)
+{
+    _Puts(t, "{");
+    for (int i = 0; t->len < target; i++) {
+        if (i != 0)
+            _Puts(t, ",");
+        switch (i % 4) {
+            case 0: _Printf(t, "\"field_%d\":%u", i, _Rand()); break;
+            case 1: _Printf(t, "\"field_%d\":\"value %u\"", i, _Rand()); break;
+            case 2: _Printf(t, "\"field_%d\":%s", i, _Rand() % 2 ? "true" : "false"); break;
+            default: _Printf(t, "\"field_%d\":%.6f", i, (_Rand() % 1000000) / 1000.0); break;
+        }
+    }
+    _Puts(t, "}");
+}
+
+static void _GenNumeric(Text *t, size_t target)
+{
+    _Puts(t, "{\"ints\":[");
+    for (int i = 0; t->len < target / 2; i++)
+        _Printf(t, "%s%d", i ? "," : "", (int)(_Rand() % 2000000) - 1000000);
+    _Puts(t, "],\"doubles\":[");
+    for (int i = 0; t->len < target; i++)
+        _Printf(t, "%s%.17g", i ? "," : "", ((int)_Rand() - 0x7fff) / 65536.0);
+    _Puts(t, "]}");
+}
+
+// ----------------------------------------------------------------------------------------------------
+//                                          | 测试项  |
+// ----------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+    const char *name;
+    Text        text;
+    NPJSONNode *doc;   // 预先生成 用于 Find/Synthesizer
+} Corpus;
+
+typedef struct
+{
+    double min_time;   // 每项最少运行时间
+    size_t min_iters;  // 每项最少运行次数
+    FILE * json;
+    bool   first;
+} Options;
+
+static volatile size_t g_sink;   // 防止被优化
+
+static bool _Walk(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)index;
+    (*(size_t *)obj)++;
+    if (re->isObject || re->isArray)
+        return re->Resolve(re, obj, _Walk);
+    return true;
+}
+
+static size_t _RunResolve(Corpus *c)
+{
+    size_t n = 0;
+    if (!NPJSON_Resolve(c->text.str, (int)c->text.len, &n, _Walk, NULL))
+        return 0;
+    return n;
+}
+
+// 数值不转换 只统计个数
+static size_t _RunResolveLazy(Corpus *c)
+{
+    size_t n = 0;
+    if (!NPJSON_ResolveLazy(c->text.str, (int)c->text.len, NULL, &n, _Walk, NULL))
+        return 0;
+    return n;
+}
+
+static NPJSON_ScanResult _ScanAll(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)re;
+    (void)index;
+    (*(size_t *)obj)++;
+    return NPJSON_CONTINUE;
+}
+
+// 只关心顶层成员，跳过所有嵌套内容
+static NPJSON_ScanResult _ScanTop(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)index;
+    (*(size_t *)obj)++;
+    return re->level == 0 ? NPJSON_CONTINUE : NPJSON_SKIP;
+}
+
+static size_t _RunScan(Corpus *c)
+{
+    size_t n = 0;
+    if (!NPJSON_Scan(c->text.str, (int)c->text.len, &n, _ScanAll, NULL))
+        return 0;
+    return n;
+}
+
+static size_t _RunScanSkip(Corpus *c)
+{
+    size_t n = 0;
+    if (!NPJSON_Scan(c->text.str, (int)c->text.len, &n, _ScanTop, NULL))
+        return 0;
+    return n;
+}
+
+// 只校验格式
+static size_t _RunValidate(Corpus *c)
+{
+    const char *err = NULL;
+    return NPJSON_Validate(c->text.str, c->text.len, &err) ? c->text.len : 0;
+}
+
+// 进入所有对象、数组并读取每个标量
+static size_t _RunCursor(Corpus *c)
+{
+    size_t         n  = 0;
+    NPJSON_Cursor *cr = NPJSON_CreateCursor(c->text.str, c->text.len);
+    if (!NPJSON_CursorEnter(cr)) {
+        NPJSON_DeleteCursor(cr);
+        return 0;
+    }
+    while (NPJSON_CursorDepth(cr) > 0) {
+        if (!NPJSON_CursorNext(cr)) {
+            if (NPJSON_CursorError(cr) != NULL)
+                break;
+            continue;
+        }
+        n++;
+        switch (NPJSON_CursorType(cr)) {
+        case NPJSON_TOKEN_OBJECT:
+        case NPJSON_TOKEN_ARRAY:
+            NPJSON_CursorEnter(cr);
+            break;
+        case NPJSON_TOKEN_NUMBER:
+            g_sink += (size_t)NPJSON_CursorGetNumber(cr);
+            break;
+        case NPJSON_TOKEN_STRING: {
+            int len = 0;
+            NPJSON_CursorGetString(cr, &len);
+            g_sink += len;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    if (NPJSON_CursorError(cr) != NULL)
+        n = 0;
+    NPJSON_DeleteCursor(cr);
+    return n;
+}
+
+static size_t _RunBuilder(Corpus *c)
+{
+    NPJSONNode *doc = NPJSON_Builder(c->text.str, c->text.len, NULL);
+    size_t      n   = NPJSON_GetChildCount(doc);
+    NPJSON_Release(&doc);
+    return n;
+}
+
+// 数值保留原文
+static size_t _RunBuilderLazy(Corpus *c)
+{
+    NPJSON_Option opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.lazyNumber  = true;
+    NPJSONNode *doc = NPJSON_BuilderEx(c->text.str, c->text.len, &opt, NULL);
+    size_t      n   = NPJSON_GetChildCount(doc);
+    NPJSON_Release(&doc);
+    return n;
+}
+
+// 网关常见用法：只取少量字段
+static size_t _RunBuilderProjected(Corpus *c)
+{
+    static const char *const PATHS[] = {"statuses.id", "statuses.user.screen_name", "performances.id", "type"};
+    static NPJSON_Projection *proj;
+    if (proj == NULL)
+        proj = NPJSON_CreateProjection(PATHS, (int)(sizeof(PATHS) / sizeof(PATHS[0])));
+    NPJSON_Option opt = {false, NULL, 0, NULL, NULL, proj, false};
+    NPJSONNode *  doc = NPJSON_BuilderEx(c->text.str, c->text.len, &opt, NULL);
+    size_t        n   = NPJSON_GetChildCount(doc) + 1;
+    NPJSON_Release(&doc);
+    return n;
+}
+
+static size_t _RunBuilderPacked(Corpus *c)
+{
+    NPJSON_Option opt = {true, NULL, 0, NULL, NULL, NULL, false};
+    NPJSONNode *  doc = NPJSON_BuilderEx(c->text.str, c->text.len, &opt, NULL);
+    size_t        n   = NPJSON_GetChildCount(doc);
+    NPJSON_Release(&doc);
+    return n;
+}
+
+// 按文档顺序查找根节点的每个字段
+static size_t _RunFind(Corpus *c)
+{
+    size_t n = 0;
+    for (NPJSONNode *t = NPJSON_GetChild(c->doc); t != NULL; t = t->next)
+        n += NPJSON_Find(c->doc, t->name) != NULL;
+    return n;
+}
+
+static void _Emit(NPJSON_Synthesizer *sn, NPJSONNode *n, bool inArray)
+{
+    for (NPJSONNode *t = n; t != NULL; t = t->next) {
+        const char *name = inArray ? NULL : t->name;
+        if (t->isPacked) {
+            if (t->isPackedInt)
+                sn->AddList->Int64(sn, name, (const int64_t *)t->Val.Packed.Data, (int)t->Val.Packed.Count);
+            else
+                sn->AddList->Double(sn, name, (const double *)t->Val.Packed.Data, (int)t->Val.Packed.Count);
+        } else if (t->isObject || t->isArray) {
+            if (t->isObject)
+                sn->StartObject(sn, name);
+            else
+                sn->StartArray(sn, name);
+            _Emit(sn, NPJSON_GetChild(t), t->isArray);
+            if (t->isObject)
+                sn->EndObject(sn);
+            else
+                sn->EndArray(sn);
+        } else if (inArray) {
+            if (t->isString)
+                sn->AddArrayItem->String(sn, t->Val.String);
+            else if (t->isBinValue)
+                sn->AddArrayItem->Bool(sn, t->Val.BinValue);
+            else if (t->isInteger)
+                sn->AddArrayItem->Int(sn, t->Val.Value);
+            else if (t->isNumber)
+                sn->AddArrayItem->Number(sn, t->Val.Number);
+            else
+                sn->AddArrayItem->String(sn, NULL);
+        } else {
+            if (t->isString)
+                sn->Add->String(sn, name, t->Val.String);
+            else if (t->isBinValue)
+                sn->Add->Bool(sn, name, t->Val.BinValue);
+            else if (t->isInteger)
+                sn->Add->Int(sn, name, t->Val.Value);
+            else if (t->isNumber)
+                sn->Add->Number(sn, name, t->Val.Number);
+            else
+                sn->Add->String(sn, name, NULL);
+        }
+    }
+}
+
+static size_t _RunSynthesizer(Corpus *c)
+{
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizer((int)c->text.len);
+    _Emit(&sn, NPJSON_GetChild(c->doc), false);
+    NPJSON_SObject s = NPJSON_CreateSObject(&sn);
+    size_t         n = s.Strlength;
+    NPJSON_DeleteSObject(&s);
+    return n;
+}
+
+// 缓冲池：稳态下不再调用外部分配接口
+static size_t _RunSynthesizerPool(Corpus *c)
+{
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizerEx((int)c->text.len, NPJSON_PoolAllocator());
+    _Emit(&sn, NPJSON_GetChild(c->doc), false);
+    NPJSON_SObject s = NPJSON_CreateSObject(&sn);
+    size_t         n = s.Strlength;
+    NPJSON_DeleteSObject(&s);
+    return n;
+}
+
+static size_t _RunPrint(Corpus *c)
+{
+    NPJSON_SObject s = NPJSON_Print(c->doc);
+    size_t         n = s.Strlength;
+    NPJSON_DeleteSObject(&s);
+    return n;
+}
+
+// 宏接口：固定的小报文
+static const char MACRO_MSG[] = "{\"Version\":1,\"deviceId\":\"A001\",\"data\":[{\"name\":\"t\",\"value\":\"23.5\"},"
+                                "{\"name\":\"h\",\"value\":\"61\"}],\"list\":[1,2,3,4,5,6,7,8]}";
+
+static size_t _RunMacroSerialize(Corpus *c)
+{
+    (void)c;
+    size_t n = 0;
+    NPJSON_Serialization_Begin(256);
+    NPJSON_Object_SetInt(Version, 1);
+    NPJSON_Object_SetString(deviceId, "A001");
+    NPJSON_Array_Start(data);
+    for (int i = 0; i < 2; i++) {
+        NPJSON_Object_Start(NULL);
+        NPJSON_Object_SetString(name, "t");
+        NPJSON_Object_SetString(value, "23.5");
+        NPJSON_Object_End();
+    }
+    NPJSON_Array_End();
+    NPJSON_Array_Start(list);
+    for (int i = 1; i <= 8; i++)
+        NPJSON_Array_AddInt(i);
+    NPJSON_Array_End();
+    NPJSON_Serialization_Complete();
+    n = NPJSON_Serialization_GetJsonStringLength();
+    NPJSON_Serialization_End();
+    return n;
+}
+
+// 模板：与 macro_serialize 相同的报文
+static size_t _RunTemplate(Corpus *c)
+{
+    static NPJSON_Template *t = NULL;
+    (void)c;
+    if (t == NULL)
+        t = NPJSON_CompileTemplate("{\"Version\":%d,\"deviceId\":%s,\"data\":[{\"name\":%s,\"value\":%s},"
+                                   "{\"name\":%s,\"value\":%s}],\"list\":[%d,%d,%d,%d,%d,%d,%d,%d]}",
+                                   NULL);
+    NPJSON_SObject s = NPJSON_TemplateRender(t, 1, "A001", "t", "23.5", "t", "23.5", 1, 2, 3, 4, 5, 6, 7, 8);
+    size_t         n = s.Strlength;
+    NPJSON_DeleteSObject(&s);
+    return n;
+}
+
+// 记录数组：顺序与并行序列化
+typedef struct
+{
+    int    id;
+    double value;
+    char   name[16];
+} Record;
+
+#define RECORD_COUNT 20000
+
+static Record *_Records(void)
+{
+    static Record *rec = NULL;
+    if (rec == NULL) {
+        rec = (Record *)malloc(sizeof(Record) * RECORD_COUNT);
+        for (int i = 0; i < RECORD_COUNT; i++) {
+            rec[i].id    = i;
+            rec[i].value = i * 0.25;
+            snprintf(rec[i].name, sizeof(rec[i].name), "dev-%d", i);
+        }
+    }
+    return rec;
+}
+
+static bool _RecordRow(NPJSON_Synthesizer *sn, const void *record, size_t index, void *ctx)
+{
+    const Record *r = (const Record *)record;
+    (void)index;
+    (void)ctx;
+    sn->StartObject(sn, NULL);
+    sn->Add->Int(sn, "id", r->id);
+    sn->Add->Number(sn, "value", r->value);
+    sn->Add->String(sn, "name", r->name);
+    return sn->EndObject(sn);
+}
+
+static size_t _RunRecords(int threads)
+{
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizer(1024);
+    NPJSON_AddArrayParallel(&sn, "rows", _Records(), RECORD_COUNT, sizeof(Record), _RecordRow, NULL, threads);
+    NPJSON_SObject s = NPJSON_CreateSObject(&sn);
+    size_t         n = s.Strlength;
+    NPJSON_DeleteSObject(&s);
+    return n;
+}
+
+static size_t _RunRecordsSerial(Corpus *c)
+{
+    (void)c;
+    return _RunRecords(1);
+}
+
+static size_t _RunRecordsParallel(Corpus *c)
+{
+    (void)c;
+    return _RunRecords(4);
+}
+
+static size_t _RunMacroDeserialize(Corpus *c)
+{
+    (void)c;
+    size_t      n   = 0;
+    const char *msg = NULL;
+    NPJSON_Builder_Begin(MACRO_MSG, sizeof(MACRO_MSG) - 1, msg);
+    int Version = 0;
+    NPJSON_Object_GetInt(Version, Version);
+    char deviceId[8];
+    NPJSON_Object_GetString(deviceId, deviceId, sizeof(deviceId));
+    NPJSON_Array_Enter(list);
+    int cnt = NPJSON_Array_GetCount();
+    for (int i = 0; i < cnt; i++) {
+        int v = 0;
+        NPJSON_Array_GetInt(v);
+        n += v;
+    }
+    NPJSON_Array_Exit();
+    n += Version;
+    NPJSON_Builder_End();
+    return n;
+}
+
+typedef struct
+{
+    const char *name;
+    size_t (*fun)(Corpus *c);
+    bool needDoc;    // 需要预先生成的文档
+    bool perCorpus;  // false：与语料无关，只运行一次
+    bool bytesIn;    // true：按输入长度计算 MB/s
+} Bench;
+
+static const Bench BENCHES[] = {
+    {"resolve", _RunResolve, false, true, true},
+    {"resolve_lazy", _RunResolveLazy, false, true, true},
+    {"validate", _RunValidate, false, true, true},
+    {"scan", _RunScan, false, true, true},
+    {"scan_skip", _RunScanSkip, false, true, true},
+    {"cursor", _RunCursor, false, true, true},
+    {"builder", _RunBuilder, false, true, true},
+    {"builder_packed", _RunBuilderPacked, false, true, true},
+    {"builder_lazy", _RunBuilderLazy, false, true, true},
+    {"builder_projected", _RunBuilderProjected, false, true, true},
+    {"find", _RunFind, true, true, false},
+    {"synthesizer", _RunSynthesizer, true, true, true},
+    {"synthesizer_pool", _RunSynthesizerPool, true, true, true},
+    {"print", _RunPrint, true, true, true},
+    {"macro_serialize", _RunMacroSerialize, false, false, false},
+    {"template", _RunTemplate, false, false, false},
+    {"records_serial", _RunRecordsSerial, false, false, false},
+    {"records_parallel", _RunRecordsParallel, false, false, false},
+    {"macro_deserialize", _RunMacroDeserialize, false, false, false},
+};
+
+static void _Report(Options *o, const char *bench, const char *corpus, size_t bytes, size_t iters, size_t ops, double sec, size_t allocs)
+{
+    double ns  = sec * 1e9 / (double)ops;
+    double mbs = bytes ? (double)bytes * iters / sec / (1024.0 * 1024.0) : 0;
+    double apo = (double)allocs / (double)ops;
+    printf("%-18s %-10s %10zu %12.1f %10.2f %12.2f\n", bench, corpus, iters, ns, mbs, apo);
+    if (o->json != NULL) {
+        fprintf(o->json, "%s\n  {\"bench\":\"%s\",\"corpus\":\"%s\",\"bytes\":%zu,\"iterations\":%zu,\"ops\":%zu,"
+                         "\"ns_per_op\":%.1f,\"mb_per_s\":%.2f,\"allocs_per_op\":%.2f}",
+                o->first ? "" : ",", bench, corpus, bytes, iters, ops, ns, mbs, apo);
+        o->first = false;
+    }
+}
+
+static void _Run(Options *o, const Bench *b, Corpus *c)
+{
+    size_t bytes = c->text.len;
+    size_t ops_per_iter = 1;
+    if (b->name[0] == 'f') {
+        // Find 按单次查找统计
+        ops_per_iter = NPJSON_GetChildCount(c->doc);
+        if (ops_per_iter == 0)
+            return;
+    }
+    if (o->min_iters > 1)
+        g_sink += b->fun(c);   // 预热
+    size_t iters  = 0;
+    size_t allocs = g_allocs;
+    double start  = _Now();
+    double sec    = 0;
+    do {
+        g_sink += b->fun(c);
+        iters++;
+        sec = _Now() - start;
+    } while (sec < o->min_time || iters < o->min_iters);
+    allocs = g_allocs - allocs;
+    _Report(o, b->name, b->perCorpus ? c->name : "-", b->bytesIn ? bytes : 0, iters, iters * ops_per_iter, sec, allocs);
+}
+
+static bool _LoadFile(const char *path, Text *t)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+    char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        _Put(t, buf, n);
+    fclose(f);
+    return t->len > 0;
+}
+
+int main(int argc, char **argv)
+{
+    Options     o     = {1.0, 3, NULL, true};
+    size_t      scale = 1;
+    const char *files[16];
+    int         nfile = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            o.min_time  = 0.01;
+            o.min_iters = 1;
+        }
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            scale = (size_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            const char *path = argv[++i];
+            o.json           = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+            if (o.json == NULL) {
+                fprintf(stderr, "cannot open %s\n", path);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc && nfile < 16)
+            files[nfile++] = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--quick] [--scale N] [--json FILE|-] [--file PATH]...\n", argv[0]);
+            return 1;
+        }
+    }
+    if (scale == 0)
+        scale = 1;
+
+    Corpus corpus[6 + 16];
+    int    ncorpus = 0;
+    struct
+    {
+        const char *name;
+        void (*gen)(Text *t, size_t target);
+        size_t size;
+    } GEN[] = {
+        {"twitter", _GenTwitter, 640 * 1024},
+        {"citm", _GenCitm, 1700 * 1024},
+        {"canada", _GenCanada, 2200 * 1024},
+        {"deep", _GenDeep, 512 * 1024},
+        {"wide", _GenWide, 1024 * 1024},
+        {"numeric", _GenNumeric, 1024 * 1024},
+    };
+    for (size_t i = 0; i < sizeof(GEN) / sizeof(GEN[0]); i++) {
+        Corpus *c = &corpus[ncorpus++];
+        memset(c, 0, sizeof(Corpus));
+        c->name = GEN[i].name;
+        GEN[i].gen(&c->text, GEN[i].size * scale);
+    }
+    for (int i = 0; i < nfile; i++) {
+        Corpus *c = &corpus[ncorpus];
+        memset(c, 0, sizeof(Corpus));
+        c->name = files[i];
+        if (!_LoadFile(files[i], &c->text)) {
+            fprintf(stderr, "cannot read %s\n", files[i]);
+            return 1;
+        }
+        ncorpus++;
+    }
+    for (int i = 0; i < ncorpus; i++) {
+        const char * err = NULL;
+        NPJSON_Stats st;
+        NPJSON_ResetStats();
+        corpus[i].doc = NPJSON_Builder(corpus[i].text.str, corpus[i].text.len, &err);
+        if (corpus[i].doc == NULL) {
+            fprintf(stderr, "%s: parse failed at offset %ld\n", corpus[i].name,
+                    err ? (long)(err - corpus[i].text.str) : -1L);
+            return 1;
+        }
+        // 以 CFG_NPJSON_STATS 编译时输出扫描放大倍数等统计
+        if (NPJSON_GetStats(&st))
+            printf("stats %-10s scan %.2fx  callbacks %llu  nodes %llu  allocs %llu  depth %u\n", corpus[i].name,
+                   st.inputBytes ? (double)st.scannedBytes / (double)st.inputBytes : 0.0,
+                   (unsigned long long)st.callbacks, (unsigned long long)st.nodes, (unsigned long long)st.allocs,
+                   st.maxDepth);
+    }
+
+    if (o.json != NULL)
+        fprintf(o.json, "{\"version\":1,\"results\":[");
+    printf("%-18s %-10s %10s %12s %10s %12s\n", "bench", "corpus", "iters", "ns/op", "MB/s", "allocs/op");
+    for (size_t b = 0; b < sizeof(BENCHES) / sizeof(BENCHES[0]); b++) {
+        if (!BENCHES[b].perCorpus) {
+            _Run(&o, &BENCHES[b], &corpus[0]);
+            continue;
+        }
+        for (int i = 0; i < ncorpus; i++)
+            _Run(&o, &BENCHES[b], &corpus[i]);
+    }
+    if (o.json != NULL) {
+        fprintf(o.json, "\n]}\n");
+        if (o.json != stdout)
+            fclose(o.json);
+    }
+    for (int i = 0; i < ncorpus; i++) {
+        NPJSON_Release(&corpus[i].doc);
+        free(corpus[i].text.str);
+    }
+    return g_sink == 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file     builder_alloc.c
+ * @brief    NPJSON_Builder_BeginEx/NPJSON_Builder_End、投影使用自定义分配器
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+// 分配的地址偏移 16 字节 交给默认 NPJSON_Free 释放会立即出错
+#define HEAD 16
+
+typedef struct
+{
+    long live;    // 未释放的块数
+    long total;   // 分配次数
+} Counter;
+
+static void *_Malloc(void *ctx, size_t size)
+{
+    char *p = (char *)malloc(size + HEAD);
+    if (p == NULL)
+        return NULL;
+    ((Counter *)ctx)->live++;
+    ((Counter *)ctx)->total++;
+    return p + HEAD;
+}
+
+static void _Free(void *ctx, void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    ((Counter *)ctx)->live--;
+    free((char *)ptr - HEAD);
+}
+
+static void *_Realloc(void *ctx, void *ptr, size_t size)
+{
+    if (ptr == NULL)
+        return _Malloc(ctx, size);
+    char *p = (char *)realloc((char *)ptr - HEAD, size + HEAD);
+    return p == NULL ? NULL : p + HEAD;
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+int main(void)
+{
+    Counter          cnt   = {0, 0};
+    NPJSON_Allocator alloc = {_Malloc, _Free, _Realloc, &cnt};
+    NPJSON_Option    opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.alloc = &alloc;
+
+    const char *str = "{\"ver\":123,\"name\":\"npjson\",\"info\":{\"ok\":true},\"list\":[1,2,3]}";
+    const char *msg;
+    int         ver = 0, a = 0, b = 0;
+    bool        ok  = false;
+    char        name[16] = {0};
+    NPJSON_Builder_BeginEx(str, strlen(str), &opt, msg);
+    NPJSON_Object_GetInt(ver, ver);
+    NPJSON_Object_GetString(name, name, sizeof(name));
+    NPJSON_Object_Enter(info);
+    NPJSON_Object_GetBool(ok, ok);
+    NPJSON_Object_Exit();
+    NPJSON_Array_Enter(list);
+    NPJSON_Array_GetInt(a);
+    NPJSON_Array_GetInt(b);
+    NPJSON_Array_Exit();
+    NPJSON_Builder_End();
+
+    CHECK(msg == NULL);
+    CHECK(ver == 123 && ok && a == 1 && b == 2);
+    CHECK(strcmp(name, "npjson") == 0);
+    CHECK(cnt.total > 0);
+    CHECK(cnt.live == 0);
+
+    // 紧凑数组同样由自定义分配器释放
+    opt.packed = true;
+    NPJSON_Builder_BeginEx(str, strlen(str), &opt, msg);
+    NPJSON_Array_Enter(list);
+    NPJSON_Array_GetInt(a);
+    NPJSON_Array_GetInt(b);
+    NPJSON_Array_Exit();
+    NPJSON_Builder_End();
+    CHECK(msg == NULL && a == 1 && b == 2);
+    CHECK(cnt.live == 0);
+
+    // 解析失败时不遗留分配
+    const char *bad = "{\"ver\":123,\"list\":[1,}";
+    NPJSON_Builder_BeginEx(bad, strlen(bad), &opt, msg);
+    NPJSON_Object_GetInt(ver, ver);
+    NPJSON_Builder_End();
+    CHECK(msg != NULL);
+    CHECK(cnt.live == 0);
+
+    // 投影与文档使用同一分配器
+    const char *const  paths[] = {"ver", "info.ok"};
+    NPJSON_Projection *proj    = NPJSON_CreateProjectionEx(paths, 2, &alloc);
+    CHECK(proj != NULL);
+    opt.projection = proj;
+    ver = 0, ok = false, name[0] = '\0';
+    NPJSON_Builder_BeginEx(str, strlen(str), &opt, msg);
+    NPJSON_Object_GetInt(ver, ver);
+    NPJSON_Object_Enter(info);
+    NPJSON_Object_GetBool(ok, ok);
+    NPJSON_Object_Exit();
+    NPJSON_Builder_End();
+    CHECK(msg == NULL && ver == 123 && ok);
+    NPJSON_DeleteProjection(proj);
+    CHECK(cnt.live == 0);
+    return 0;
+}
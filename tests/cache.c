@@ -0,0 +1,157 @@
+/**
+ * @file     cache.c
+ * @brief    NPJSON_CacheBuilder 按完整生成选项区分缓存
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+// 按大小回收已释放的块 使删除后新建的投影必然复用旧地址
+#define SLOTS 16
+
+typedef struct
+{
+    void * ptr[SLOTS];
+    size_t size[SLOTS];
+    int    count;
+} Recycler;
+
+static void *_Malloc(void *ctx, size_t size)
+{
+    Recycler *r = (Recycler *)ctx;
+    for (int i = r->count - 1; i >= 0; i--) {
+        if (r->size[i] == size) {
+            void *p = r->ptr[i];
+            r->count--;
+            r->ptr[i]  = r->ptr[r->count];
+            r->size[i] = r->size[r->count];
+            return p;
+        }
+    }
+    size_t *p = (size_t *)malloc(size + sizeof(size_t) * 2);
+    if (p == NULL)
+        return NULL;
+    p[0] = size;
+    return p + 2;
+}
+
+static void _Free(void *ctx, void *ptr)
+{
+    Recycler *r = (Recycler *)ctx;
+    if (ptr == NULL)
+        return;
+    size_t *p = (size_t *)ptr - 2;
+    if (r->count < SLOTS) {
+        r->ptr[r->count]  = ptr;
+        r->size[r->count] = p[0];
+        r->count++;
+        return;
+    }
+    free(p);
+}
+
+static void *_Realloc(void *ctx, void *ptr, size_t size)
+{
+    void *p = _Malloc(ctx, size);
+    if (p == NULL || ptr == NULL)
+        return p;
+    size_t old = ((size_t *)ptr)[-2];
+    memcpy(p, ptr, old < size ? old : size);
+    _Free(ctx, ptr);
+    return p;
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+int main(void)
+{
+    Recycler         rec;
+    NPJSON_Allocator alloc = {_Malloc, _Free, _Realloc, &rec};
+    memset(&rec, 0, sizeof(rec));
+
+    NPJSON_Cache *c = NPJSON_CreateCache(1 << 20);
+    CHECK(c != NULL);
+    const char *      str = "{\"a\":1,\"b\":{\"c\":[2]}}";
+    size_t            len = strlen(str);
+    const char *      err = NULL;
+    NPJSON_CacheStats st;
+    NPJSON_Option     opt;
+    memset(&opt, 0, sizeof(opt));
+
+    // 删除后新建的投影复用同一地址 不能命中旧投影的文档
+    const char *const  pa[] = {"a"};
+    const char *const  pb[] = {"b"};
+    NPJSON_Projection *p1   = NPJSON_CreateProjectionEx(pa, 1, &alloc);
+    CHECK(p1 != NULL);
+    opt.projection = p1;
+    NPJSONNode *n  = NPJSON_CacheBuilder(c, str, len, &opt, &err);
+    CHECK(n != NULL && NPJSON_Find(n, "a") != NULL && NPJSON_Find(n, "b") == NULL);
+    NPJSON_CacheRelease(n);
+    NPJSON_DeleteProjection(p1);
+    NPJSON_Projection *p2 = NPJSON_CreateProjectionEx(pb, 1, &alloc);
+    CHECK(p2 == p1);
+    opt.projection = p2;
+    n              = NPJSON_CacheBuilder(c, str, len, &opt, &err);
+    CHECK(n != NULL && NPJSON_Find(n, "a") == NULL && NPJSON_Find(n, "b") != NULL);
+    NPJSON_CacheRelease(n);
+    n = NPJSON_CacheBuilder(c, str, len, &opt, &err);   // 同一投影命中
+    CHECK(n != NULL);
+    NPJSON_CacheRelease(n);
+    NPJSON_CacheGetStats(c, &st);
+    CHECK(st.misses == 2 && st.hits == 1);
+    NPJSON_DeleteProjection(p2);
+    opt.projection = NULL;
+
+    // 最大嵌套深度不同 不能命中可以生成的文档
+    n = NPJSON_CacheBuilder(c, str, len, &opt, &err);
+    CHECK(n != NULL);
+    NPJSON_CacheRelease(n);
+    opt.maxDepth = 2;
+    err          = NULL;
+    n            = NPJSON_CacheBuilder(c, str, len, &opt, &err);
+    CHECK(n == NULL && err != NULL);
+    opt.maxDepth = 0;
+
+    // 分配器不同 不能共享文档
+    NPJSON_CacheGetStats(c, &st);
+    size_t misses = st.misses;
+    opt.alloc     = &alloc;
+    n             = NPJSON_CacheBuilder(c, str, len, &opt, &err);
+    CHECK(n != NULL);
+    NPJSON_CacheRelease(n);
+    NPJSON_CacheGetStats(c, &st);
+    CHECK(st.misses == misses + 1);
+
+    NPJSON_DeleteCache(c);
+    for (int i = 0; i < rec.count; i++)
+        free((size_t *)rec.ptr[i] - 2);
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file     cursor.c
+ * @brief    NPJSON_Cursor 逐个读取值、进入、跳过及错误位置
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+static bool _KeyIs(const NPJSON_Cursor *c, const char *key)
+{
+    const char *k = NPJSON_CursorKey(c);
+    return k != NULL && strcmp(k, key) == 0;
+}
+
+int main(void)
+{
+    const char *str = "{\"id\":7,\"name\":\"a\\\"b\",\"ok\":true,\"n\":null,\"pi\":3.5,"
+                      "\"user\":{\"x\":1,\"y\":[1,2]},\"list\":[10,20,30],"
+                      "\"skip\":{\"deep\":[1,{\"z\":2}]},\"last\":\"end\"}";
+    int         len = 0;
+    const char *s;
+
+    NPJSON_Cursor *c = NPJSON_CreateCursor(str, strlen(str));
+    CHECK(c != NULL);
+    CHECK(NPJSON_CursorType(c) == NPJSON_TOKEN_OBJECT);
+    CHECK(NPJSON_CursorEnter(c) && NPJSON_CursorDepth(c) == 1);
+
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "id"));
+    CHECK(NPJSON_CursorType(c) == NPJSON_TOKEN_NUMBER && NPJSON_CursorGetInt(c) == 7);
+    CHECK(NPJSON_CursorGetString(c, &len) == NULL);   // 不是字符串
+
+    // 有转义时解码
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "name"));
+    s = NPJSON_CursorGetString(c, &len);
+    CHECK(s != NULL && len == 3 && memcmp(s, "a\"b", 3) == 0);
+
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "ok"));
+    CHECK(NPJSON_CursorType(c) == NPJSON_TOKEN_BOOL && NPJSON_CursorGetBool(c) && NPJSON_CursorGetInt(c) == 1);
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "n") && NPJSON_CursorType(c) == NPJSON_TOKEN_NULL);
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "pi") && NPJSON_CursorGetNumber(c) == 3.5);
+
+    // 进入对象 未进入的数组由 Next 跳过
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "user") && NPJSON_CursorType(c) == NPJSON_TOKEN_OBJECT);
+    CHECK(NPJSON_CursorEnter(c) && NPJSON_CursorDepth(c) == 2);
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "x") && NPJSON_CursorGetInt(c) == 1);
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "y") && NPJSON_CursorType(c) == NPJSON_TOKEN_ARRAY);
+    CHECK(!NPJSON_CursorNext(c) && NPJSON_CursorError(c) == NULL);
+    CHECK(NPJSON_CursorDepth(c) == 1);
+
+    // 数组元素没有名称
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "list"));
+    CHECK(NPJSON_CursorEnter(c));
+    long long sum = 0;
+    int       cnt = 0;
+    while (NPJSON_CursorNext(c)) {
+        CHECK(NPJSON_CursorKey(c) == NULL);
+        sum += NPJSON_CursorGetInt(c);
+        cnt++;
+    }
+    CHECK(cnt == 3 && sum == 60 && NPJSON_CursorError(c) == NULL);
+
+    // 未进入的对象整体跳过
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "skip"));
+    CHECK(NPJSON_CursorNext(c) && _KeyIs(c, "last"));
+    s = NPJSON_CursorGetString(c, &len);
+    CHECK(s != NULL && len == 3 && memcmp(s, "end", 3) == 0);
+    CHECK(!NPJSON_CursorNext(c) && NPJSON_CursorError(c) == NULL);
+    CHECK(NPJSON_CursorDepth(c) == 0);
+    NPJSON_DeleteCursor(c);
+
+    // 跳过当前层剩余的值
+    c = NPJSON_CreateCursor(str, strlen(str));
+    CHECK(NPJSON_CursorEnter(c) && NPJSON_CursorNext(c));
+    CHECK(NPJSON_CursorSkip(c) && NPJSON_CursorDepth(c) == 0 && NPJSON_CursorError(c) == NULL);
+    NPJSON_DeleteCursor(c);
+
+    // 非对象、数组不能进入
+    c = NPJSON_CreateCursor(str, strlen(str));
+    CHECK(NPJSON_CursorEnter(c) && NPJSON_CursorNext(c));
+    CHECK(!NPJSON_CursorEnter(c));
+    NPJSON_DeleteCursor(c);
+
+    // 格式错误 返回 false 并给出位置
+    const char *bad = "{\"a\":[1,}";
+    c               = NPJSON_CreateCursor(bad, strlen(bad));
+    CHECK(NPJSON_CursorEnter(c) && NPJSON_CursorNext(c) && NPJSON_CursorEnter(c));
+    while (NPJSON_CursorNext(c))
+        ;
+    CHECK(NPJSON_CursorError(c) != NULL);
+    CHECK(NPJSON_CursorError(c) >= bad && NPJSON_CursorError(c) <= bad + strlen(bad));
+    NPJSON_DeleteCursor(c);
+    return 0;
+}
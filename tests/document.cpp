@@ -0,0 +1,145 @@
+/**
+ * @file     document.cpp
+ * @brief    NPJSON.hpp 封装：错误位置、查找、遍历、所有权转移
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "NPJSON.hpp"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                       \
+        }                                                                   \
+    } while (0)
+
+int main()
+{
+    // 错误位置指向输入内
+    std::string_view bad = "{\"a\":[1,}";
+    npjson::Document doc(bad);
+    CHECK(!doc);
+    CHECK(doc.error() != nullptr);
+    CHECK(doc.error() >= bad.data() && doc.error() <= bad.data() + bad.size());
+
+    // 移动后保留
+    const char *    err = doc.error();
+    npjson::Document moved(std::move(doc));
+    CHECK(moved.error() == err);
+    npjson::Document assigned;
+    assigned = std::move(moved);
+    CHECK(assigned.error() == err);
+
+    // 成功时无错误
+    npjson::Document ok("{\"a\":[1,2]}");
+    CHECK(ok);
+    CHECK(ok.error() == nullptr);
+    CHECK(ok["a"].size() == 2);
+
+    // 空名称成员不影响查找 遍历时名称为空
+    npjson::Document named("{\"\":1,\"b\":2,\"o\":{\"\":{\"c\":3}}}");
+    CHECK(named);
+    CHECK(named["b"].getInt() == 2);
+    CHECK(named["o"].size() == 1);
+    CHECK(!named["none"] && !named["none"]["c"]);
+    std::string names;
+    for (npjson::Node n : named.root())
+        names += std::string(n.name()) + ";";
+    CHECK(names == ";b;o;");
+    for (npjson::Node n : named["o"])
+        CHECK(n.name().empty() && n["c"].getInt() == 3);
+
+    // 数组遍历 字符串直接指向文档
+    npjson::Document list("{\"a\":[1,\"x\",true,null,2.5],\"p\":[1,2,3]}");
+    int  count = 0;
+    for (npjson::Node n : list["a"])
+        count += n ? 1 : 0;
+    CHECK(count == 5);
+    npjson::Node::iterator it = list["a"].begin();
+    CHECK((*it).getInt() == 1 && (*++it).getString() == "x" && (*++it).getBool() && (*++it).isNull());
+    CHECK((*++it).getNumber() == 2.5 && ++it == list["a"].end());
+    CHECK(npjson::Node().begin() == npjson::Node().end());
+
+    // 紧凑数组没有子节点
+    NPJSON_Option opt;
+    std::memset(&opt, 0, sizeof(opt));
+    opt.packed = true;
+    npjson::Document packed("{\"p\":[1,2,3]}", &opt);
+    CHECK(packed["p"].isPacked() && packed["p"].size() == 3);
+    CHECK(packed["p"].begin() == packed["p"].end());
+    npjson::Span<int64_t> span = packed["p"].packedInt64();
+    CHECK(span.size() == 3 && span[0] == 1 && span[2] == 3);
+
+    // 文档转移 节点仍然有效
+    npjson::Node     p = list["p"];
+    npjson::Document owner(std::move(list));
+    CHECK(!list && owner["p"].get() == p.get());
+    NPJSONNode *raw = owner.release();
+    CHECK(!owner && raw != nullptr);
+    npjson::Document back(raw);
+    CHECK(back["p"].size() == 3);
+
+    // 合成器内容转移 不复制
+    npjson::Synthesizer sn(64);
+    sn->Add->Int(sn.get(), "id", 1);
+    npjson::SObject out = sn.finish();
+    CHECK(!sn && out && out.view() == "{\"id\":1}");
+    const char *    buf = out.c_str();
+    npjson::SObject moved_out(std::move(out));
+    CHECK(!out && out.c_str() == nullptr && moved_out.c_str() == buf);
+    npjson::SObject assigned_out;
+    assigned_out = std::move(moved_out);
+    CHECK(!moved_out && assigned_out.c_str() == buf);
+
+    // 共享对象复制只增加引用计数
+    npjson::SharedSObject shared = std::move(assigned_out).share();
+    CHECK(!assigned_out && shared.c_str() == buf);
+    npjson::SharedSObject copy = shared;
+    CHECK(copy.c_str() == buf && copy.view() == shared.view());
+    shared = npjson::SharedSObject();
+    CHECK(!shared && copy.view() == "{\"id\":1}");
+
+    // 解析对象转移
+    npjson::RObject robj("{\"a\":1}");
+    CHECK(robj);
+    const char *    rstr = robj.view().data();
+    npjson::RObject rmoved(std::move(robj));
+    CHECK(!robj && rmoved.view().data() == rstr);
+    npjson::SharedRObject rshared(std::move(rmoved));
+    npjson::SharedRObject rcopy = rshared;
+    CHECK(rcopy.view().data() == rshared.view().data() && rcopy.view() == "{\"a\":1}");
+
+    // 游标、模板
+    npjson::Cursor cur("{\"k\":\"v\"}");
+    CHECK(cur.enter() && cur.next() && cur.key() == "k" && cur.getString() == "v" && !cur.next() && cur);
+    npjson::Template tpl("{\"id\":%d}");
+    CHECK(tpl && tpl.render(5).view() == "{\"id\":5}");
+    npjson::Template bad_tpl("{\"id\":%x}");
+    CHECK(!bad_tpl && bad_tpl.error() != nullptr);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file     image.c
+ * @brief    NPJSON_ImageDump/NPJSON_ImageLoad 镜像查询结果与文档一致
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+int main(void)
+{
+    const char *str = "{\"id\":7,\"name\":\"np\\\"json\",\"ok\":true,\"n\":null,\"pi\":3.5,"
+                      "\"ints\":[1,2,3],\"dbl\":[0.5,1.5],\"obj\":{\"a\":\"x\"},\"mix\":[1,\"s\"]}";
+    NPJSON_Option opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.packed    = true;
+    NPJSONNode *n = NPJSON_BuilderEx(str, strlen(str), &opt, NULL);
+    CHECK(n != NULL);
+
+    size_t size = NPJSON_ImageSize(n);
+    CHECK(size > 0);
+    void *buf = malloc(size);   // malloc 满足 8 字节对齐
+    CHECK(buf != NULL);
+    CHECK(NPJSON_ImageDump(n, buf, size - 1) == 0);   // 空间不足
+    CHECK(NPJSON_ImageDump(n, buf, size) == size);
+    NPJSON_Release(&n);   // 镜像不引用文档
+
+    const NPJSONImageNode *root = NPJSON_ImageLoad(buf, size);
+    CHECK(root != NULL && (root->flags & NPJSON_IMAGE_OBJECT));
+    CHECK(NPJSON_ImageGetChildCount(root) == 9);
+    CHECK(NPJSON_ImageLoad(buf, 8) == NULL);                 // 长度不足
+    CHECK(NPJSON_ImageLoad((char *)buf + 1, size - 1) == NULL);   // 未对齐
+
+    const NPJSONImageNode *t = NPJSON_ImageFind(root, "id");
+    CHECK(t != NULL && (t->flags & NPJSON_IMAGE_INTEGER) && t->Val.Value == 7);
+    size_t      len = 0;
+    const char *s   = NPJSON_ImageGetString(NPJSON_ImageFind(root, "name"), &len);
+    CHECK(s != NULL && len == 7 && strcmp(s, "np\"json") == 0);
+    t = NPJSON_ImageFind(root, "ok");
+    CHECK(t != NULL && (t->flags & NPJSON_IMAGE_BOOL) && t->Val.Value == 1);
+    t = NPJSON_ImageFind(root, "n");
+    CHECK(t != NULL && (t->flags & NPJSON_IMAGE_NULL));
+    t = NPJSON_ImageFind(root, "pi");
+    CHECK(t != NULL && (t->flags & NPJSON_IMAGE_NUMBER) && t->Val.Number == 3.5);
+    CHECK(NPJSON_ImageFind(root, "none") == NULL);
+
+    // 紧凑数组
+    size_t         cnt = 0;
+    const int64_t *iv  = NPJSON_ImageGetPackedInt64(NPJSON_ImageFind(root, "ints"), &cnt);
+    CHECK(iv != NULL && cnt == 3 && iv[0] == 1 && iv[2] == 3);
+    const double *dv = NPJSON_ImageGetPackedDouble(NPJSON_ImageFind(root, "dbl"), &cnt);
+    CHECK(dv != NULL && cnt == 2 && dv[0] == 0.5 && dv[1] == 1.5);
+    CHECK(NPJSON_ImageGetPackedDouble(NPJSON_ImageFind(root, "ints"), &cnt) == NULL);
+    CHECK(NPJSON_ImageGetChild(NPJSON_ImageFind(root, "ints"), 0) == NULL);
+
+    // 嵌套对象、混合数组按下标访问
+    t = NPJSON_ImageFind(NPJSON_ImageFind(root, "obj"), "a");
+    CHECK(t != NULL && strcmp(NPJSON_ImageGetName(t), "a") == 0);
+    CHECK(strcmp(NPJSON_ImageGetString(t, NULL), "x") == 0);
+    const NPJSONImageNode *mix = NPJSON_ImageFind(root, "mix");
+    CHECK(NPJSON_ImageGetChildCount(mix) == 2);
+    t = NPJSON_ImageGetChild(mix, 1);
+    CHECK(t != NULL && NPJSON_ImageGetName(t) == NULL && strcmp(NPJSON_ImageGetString(t, NULL), "s") == 0);
+    CHECK(NPJSON_ImageGetNext(NPJSON_ImageGetChild(mix, 0)) == t);
+    CHECK(NPJSON_ImageGetNext(t) == NULL);
+    CHECK(NPJSON_ImageGetChild(mix, 2) == NULL);
+
+    // 兄弟遍历与按下标一致
+    size_t i = 0;
+    for (t = NPJSON_ImageGetChild(root, 0); t != NULL; t = NPJSON_ImageGetNext(t), i++)
+        CHECK(t == NPJSON_ImageGetChild(root, i));
+    CHECK(i == 9);
+
+    // 映射文件
+    const char *path = "npjson_test_image.bin";
+    FILE *      fp   = fopen(path, "wb");
+    CHECK(fp != NULL);
+    CHECK(fwrite(buf, 1, size, fp) == size);
+    fclose(fp);
+    NPJSON_ImageFile f;
+    if (NPJSON_ImageOpen(path, &f)) {
+        CHECK(f.root != NULL && f.size == size);
+        t = NPJSON_ImageFind(f.root, "id");
+        CHECK(t != NULL && t->Val.Value == 7);
+        NPJSON_ImageClose(&f);
+        CHECK(f.addr == NULL && f.root == NULL);
+    }
+    remove(path);
+    CHECK(!NPJSON_ImageOpen("npjson_test_image.none", &f));
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file     lazy_number.c
+ * @brief    NPJSON_Option.lazyNumber/NPJSON_ResolveLazy 原文校验及原样输出
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+static bool _Count(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)re;
+    (void)index;
+    (*(int *)obj)++;
+    return true;
+}
+
+int main(void)
+{
+    NPJSON_Option opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.lazyNumber = true;
+
+    // 不符合数字语法的原文不能原样输出 生成失败
+    const char *bad[] = {"{\"a\": 1 2}", "{\"a\":1abc}", "{\"a\":-}", "{\"a\":[1.]}", "{\"a\":01}"};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        const char *err = NULL;
+        NPJSONNode *n   = NPJSON_BuilderEx(bad[i], strlen(bad[i]), &opt, &err);
+        CHECK(n == NULL);
+        CHECK(err != NULL);
+        // NPJSON_ResolveLazy 不进入数组 只检查成员值
+        int cnt = 0;
+        if (strchr(bad[i], '[') == NULL)
+            CHECK(!NPJSON_ResolveLazy(bad[i], (int)strlen(bad[i]), NULL, &cnt, _Count, &err));
+    }
+
+    // 合法原文原样输出 超过 64 位的整数不丢失
+    const char *good = "{\"big\":123456789012345678901234567890,\"e\":1.50E+10,\"n\":-0.25,\"i\":42}";
+    const char *err  = NULL;
+    NPJSONNode *n    = NPJSON_BuilderEx(good, strlen(good), &opt, &err);
+    CHECK(n != NULL && err == NULL);
+    CHECK(NPJSON_GetInt(NPJSON_Find(n, "i")) == 42);
+    CHECK(NPJSON_GetNumber(NPJSON_Find(n, "n")) == -0.25);
+    size_t      len;
+    const char *raw = NPJSON_GetRaw(NPJSON_Find(n, "big"), &len);
+    CHECK(raw != NULL && len == 30 && memcmp(raw, "123456789012345678901234567890", 30) == 0);
+    NPJSON_SObject out = NPJSON_Print(n);
+    CHECK(out.str != NULL && strcmp(out.str, good) == 0);
+    CHECK(NPJSON_Validate(out.str, out.Strlength, NULL));
+    NPJSON_DeleteSObject(&out);
+    NPJSON_Release(&n);
+
+    int cnt = 0;
+    CHECK(NPJSON_ResolveLazy(good, (int)strlen(good), NULL, &cnt, _Count, &err));
+    CHECK(cnt == 4);
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file     list_string.c
+ * @brief    AddList->String 与逐个 AddArrayItem->String 输出一致（含转义、null、流式超长元素）
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+#define COUNT 600
+
+typedef struct
+{
+    char * buf;
+    size_t len;
+} Output;
+
+static bool _Sink(void *ctx, const char *data, size_t size)
+{
+    Output *o = (Output *)ctx;
+    char *  p = (char *)realloc(o->buf, o->len + size + 1);
+    if (p == NULL)
+        return false;
+    memcpy(p + o->len, data, size);
+    o->buf = p;
+    o->len += size;
+    o->buf[o->len] = '\0';
+    return true;
+}
+
+// list：批量写入 否则逐个写入
+static bool _Write(NPJSON_Synthesizer *sn, const char *const *value, int count, bool list)
+{
+    if (list)
+        return sn->AddList->String(sn, "a", value, count) && sn->AddList->String(sn, "b", value, 2) &&
+               sn->AddList->String(sn, "c", value, 0);
+    const int n[] = {count, 2, 0};
+    const char *name[] = {"a", "b", "c"};
+    for (int k = 0; k < 3; k++) {
+        if (!sn->StartArray(sn, name[k]))
+            return false;
+        for (int i = 0; i < n[k]; i++)
+            if (!sn->AddArrayItem->String(sn, value[i]))
+                return false;
+        if (!sn->EndArray(sn))
+            return false;
+    }
+    return true;
+}
+
+static char *_Stream(int block, const char *const *value, int count, bool list)
+{
+    Output             o  = {NULL, 0};
+    NPJSON_Synthesizer sn = NPJSON_CreateStreamSynthesizer(block, _Sink, &o);
+    bool               ok = _Write(&sn, value, count, list);
+    if (!NPJSON_StreamSynthesizerEnd(&sn) || !ok) {
+        free(o.buf);
+        return NULL;
+    }
+    return o.buf;
+}
+
+int main(void)
+{
+    static char        text[COUNT][64];
+    static const char *value[COUNT];
+    char *             big = (char *)malloc(3000);
+    CHECK(big != NULL);
+    for (int i = 0; i < 2999; i++)
+        big[i] = i % 7 == 0 ? '"' : (char)('a' + i % 26);
+    big[2999] = '\0';
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(text[i], sizeof(text[i]), "s%d\t\"q\"\\%c", i, (char)(1 + i % 31));
+        value[i] = i % 11 == 5 ? NULL : text[i];
+    }
+    value[300] = big;   // 跨越分段
+    value[599] = big;
+
+    NPJSON_Synthesizer a = NPJSON_CreateSynthesizer(64);
+    NPJSON_Synthesizer b = NPJSON_CreateSynthesizer(64);
+    CHECK(_Write(&a, value, COUNT, true));
+    CHECK(_Write(&b, value, COUNT, false));
+    NPJSON_SObject sa = NPJSON_CreateSObject(&a);
+    NPJSON_SObject sb = NPJSON_CreateSObject(&b);
+    CHECK(sa.str != NULL && sb.str != NULL);
+    CHECK(sa.Strlength == sb.Strlength && strcmp(sa.str, sb.str) == 0);
+    CHECK(NPJSON_Validate(sa.str, sa.Strlength, NULL));
+
+    // 流式输出 超过块大小的元素单独转义输出
+    const int block[] = {128, 1024, 8192};
+    for (int k = 0; k < 3; k++) {
+        char *x = _Stream(block[k], value, COUNT, true);
+        char *y = _Stream(block[k], value, COUNT, false);
+        CHECK(x != NULL && y != NULL);
+        CHECK(strcmp(x, y) == 0);
+        CHECK(strcmp(x, sa.str) == 0);
+        free(x);
+        free(y);
+    }
+    NPJSON_DeleteSObject(&sa);
+    NPJSON_DeleteSObject(&sb);
+    free(big);
+    return 0;
+}
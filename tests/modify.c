@@ -0,0 +1,121 @@
+/**
+ * @file     modify.c
+ * @brief    NPJSON_InsertEx/NPJSON_ReplaceEx/NPJSON_RemoveEx 修改自定义分配器生成的文档
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+// 分配的地址偏移 16 字节 交给默认 NPJSON_Free 释放会立即出错
+#define HEAD 16
+
+typedef struct
+{
+    long live;    // 未释放的块数
+    long total;   // 分配次数
+} Counter;
+
+static void *_Malloc(void *ctx, size_t size)
+{
+    char *p = (char *)malloc(size + HEAD);
+    if (p == NULL)
+        return NULL;
+    ((Counter *)ctx)->live++;
+    ((Counter *)ctx)->total++;
+    return p + HEAD;
+}
+
+static void _Free(void *ctx, void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    ((Counter *)ctx)->live--;
+    free((char *)ptr - HEAD);
+}
+
+static void *_Realloc(void *ctx, void *ptr, size_t size)
+{
+    if (ptr == NULL)
+        return _Malloc(ctx, size);
+    char *p = (char *)realloc((char *)ptr - HEAD, size + HEAD);
+    return p == NULL ? NULL : p + HEAD;
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+int main(void)
+{
+    Counter          cnt   = {0, 0};
+    NPJSON_Allocator alloc = {_Malloc, _Free, _Realloc, &cnt};
+    NPJSON_Option    opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.alloc  = &alloc;
+    opt.packed = true;
+
+    const char *str = "{\"ver\":1,\"name\":\"npjson\",\"list\":[1,2,3]}";
+    const char *err = NULL;
+    NPJSONNode *n   = NPJSON_BuilderEx(str, strlen(str), &opt, &err);
+    CHECK(n != NULL && err == NULL);
+
+    // 插入对象成员 名称由 alloc 分配
+    CHECK(NPJSON_InsertEx(n, -1, "ok", NPJSON_CreateBoolEx(true, &alloc), &alloc));
+    CHECK(NPJSON_InsertEx(n, 0, "pi", NPJSON_CreateNumberEx(3.5, &alloc), &alloc));
+
+    // 紧凑数组使用 alloc 还原为节点
+    NPJSONNode *list = NPJSON_Find(n, "list");
+    CHECK(list != NULL);
+    CHECK(NPJSON_InsertEx(list, 1, NULL, NPJSON_CreateStringEx("x", &alloc), &alloc));
+    CHECK(NPJSON_InsertEx(list, -1, NULL, NPJSON_CreateNullEx(&alloc), &alloc));
+
+    // 替换沿用原名称 原节点由 alloc 释放
+    NPJSONNode *obj = NPJSON_CreateObjectEx(&alloc);
+    CHECK(obj != NULL);
+    CHECK(NPJSON_InsertEx(obj, -1, "id", NPJSON_CreateIntEx(7, &alloc), &alloc));
+    CHECK(NPJSON_InsertEx(obj, -1, "arr", NPJSON_CreateArrayEx(&alloc), &alloc));
+    CHECK(NPJSON_ReplaceEx(n, NPJSON_Find(n, "name"), obj, &alloc));
+    CHECK(NPJSON_RemoveEx(n, NPJSON_Find(n, "ver"), &alloc));
+
+    NPJSON_SObject out = NPJSON_Print(n);
+    CHECK(out.str != NULL);
+    CHECK(strcmp(out.str, "{\"pi\":3.5,\"name\":{\"id\":7,\"arr\":[]},\"list\":[1,\"x\",2,3,null],\"ok\":true}") == 0);
+    NPJSON_DeleteSObject(&out);
+
+    NPJSON_ReleaseEx(&n, &alloc);
+    CHECK(n == NULL);
+    CHECK(cnt.live == 0);
+
+    // 未插入的节点同样由 alloc 释放
+    NPJSONNode *s = NPJSON_CreateStringEx("alone", &alloc);
+    CHECK(s != NULL && cnt.live > 0);
+    NPJSON_ReleaseEx(&s, &alloc);
+    CHECK(cnt.live == 0);
+    return 0;
+}
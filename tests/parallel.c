@@ -0,0 +1,132 @@
+/**
+ * @file     parallel.c
+ * @brief    NPJSON_AddArrayParallel 输出与顺序写入一致，缓冲池不遗留线程缓存
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+// 工作线程同时分配 计数使用原子操作
+static atomic_long _live;
+
+void *NPJSON_Malloc(size_t size)
+{
+    void *p = malloc(size);
+    if (p != NULL)
+        atomic_fetch_add(&_live, 1);
+    return p;
+}
+
+void NPJSON_Free(void *ptr)
+{
+    if (ptr != NULL)
+        atomic_fetch_sub(&_live, 1);
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    if (ptr == NULL)
+        return NPJSON_Malloc(size);
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+typedef struct
+{
+    int         id;
+    double      score;
+    const char *name;
+} Rec;
+
+static bool _Row(NPJSON_Synthesizer *sn, const void *record, size_t index, void *ctx)
+{
+    const Rec *r = (const Rec *)record;
+    (void)index;
+    (void)ctx;
+    sn->StartObject(sn, NULL);
+    sn->Add->Int(sn, "id", r->id);
+    sn->Add->Number(sn, "score", r->score);
+    sn->Add->String(sn, "name", r->name);
+    return sn->EndObject(sn);
+}
+
+static bool _Fail(NPJSON_Synthesizer *sn, const void *record, size_t index, void *ctx)
+{
+    (void)sn;
+    (void)record;
+    (void)ctx;
+    return index != 5000;
+}
+
+// 序列化全部记录 返回文本（调用者释放）
+static char *_Render(const Rec *recs, size_t n, int threads, const NPJSON_Allocator *alloc)
+{
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizerEx(256, alloc);
+    if (!NPJSON_AddArrayParallel(&sn, "rows", recs, n, sizeof(Rec), _Row, NULL, threads)) {
+        NPJSON_DeleteSynthesizer(&sn);
+        return NULL;
+    }
+    NPJSON_SObject out = NPJSON_CreateSObject(&sn);
+    char *         str = (char *)malloc(out.Strlength + 1);
+    memcpy(str, out.str, out.Strlength);
+    str[out.Strlength] = '\0';
+    NPJSON_DeleteSObject(&out);
+    return str;
+}
+
+int main(void)
+{
+    const size_t n    = 20000;
+    Rec *        recs = (Rec *)malloc(sizeof(Rec) * n);
+    for (size_t i = 0; i < n; i++) {
+        recs[i].id    = (int)i;
+        recs[i].score = (double)i / 8;
+        recs[i].name  = i % 2 ? "odd" : "even";
+    }
+
+    // 与顺序写入逐字节一致
+    char *expect = _Render(recs, n, 1, NULL);
+    CHECK(expect != NULL);
+    CHECK(NPJSON_Validate(expect, strlen(expect), NULL));
+    for (int threads = 2; threads <= 8; threads *= 2) {
+        char *got = _Render(recs, n, threads, NULL);
+        CHECK(got != NULL && strcmp(got, expect) == 0);
+        free(got);
+    }
+
+    // 缓冲池：多次调用后工作线程不保留线程缓存
+    long base = atomic_load(&_live);
+    for (int i = 0; i < 20; i++) {
+        char *got = _Render(recs, n, 4, NPJSON_PoolAllocator());
+        CHECK(got != NULL && strcmp(got, expect) == 0);
+        free(got);
+    }
+    NPJSON_PoolTrim();
+    CHECK(atomic_load(&_live) == base);
+
+    // 空数组、回调失败
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizer(64);
+    CHECK(NPJSON_AddArrayParallel(&sn, "rows", recs, 0, sizeof(Rec), _Row, NULL, 4));
+    CHECK(!NPJSON_AddArrayParallel(&sn, "bad", recs, n, sizeof(Rec), _Fail, NULL, 4));
+    NPJSON_DeleteSynthesizer(&sn);
+
+    free(expect);
+    free(recs);
+    return 0;
+}
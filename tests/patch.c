@@ -0,0 +1,138 @@
+/**
+ * @file     patch.c
+ * @brief    NPJSON_RObjectPatch/NPJSON_SObjectPatch 替换后不越界、内容正确
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+// 每块之后放一个哨兵字节 释放时检查 越界写入记入 broken
+#define HEAD  16
+#define GUARD 0xA5
+
+typedef struct
+{
+    long live;
+    long broken;
+} Guard;
+
+static void *_Malloc(void *ctx, size_t size)
+{
+    unsigned char *p = (unsigned char *)malloc(HEAD + size + 1);
+    if (p == NULL)
+        return NULL;
+    *(size_t *)p      = size;
+    p[HEAD + size]    = GUARD;
+    ((Guard *)ctx)->live++;
+    return p + HEAD;
+}
+
+static void _Free(void *ctx, void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    unsigned char *p = (unsigned char *)ptr - HEAD;
+    if (p[HEAD + *(size_t *)p] != GUARD)
+        ((Guard *)ctx)->broken++;
+    ((Guard *)ctx)->live--;
+    free(p);
+}
+
+static void *_Realloc(void *ctx, void *ptr, size_t size)
+{
+    if (ptr == NULL)
+        return _Malloc(ctx, size);
+    unsigned char *p = (unsigned char *)ptr - HEAD;
+    if (p[HEAD + *(size_t *)p] != GUARD)
+        ((Guard *)ctx)->broken++;
+    p = (unsigned char *)realloc(p, HEAD + size + 1);
+    if (p == NULL)
+        return NULL;
+    *(size_t *)p   = size;
+    p[HEAD + size] = GUARD;
+    return p + HEAD;
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+#define CHECK_TEXT(obj, text) CHECK((obj).Strlength == (int)strlen(text) && memcmp((obj).str, text, strlen(text)) == 0)
+
+int main(void)
+{
+    Guard            g     = {0, 0};
+    NPJSON_Allocator alloc = {_Malloc, _Free, _Realloc, &g};
+    const char *     src   = "{\"t\":12,\"s\":\"ab\"}";
+
+    // NPJSON_CreateSafeObject 按 Strlength 分配
+    NPJSON_Result re;
+    memset(&re, 0, sizeof(re));
+    re.str       = src;
+    re.Strlength = (int)strlen(src);
+    re.alloc     = &alloc;
+    NPJSON_RObject sub = NPJSON_CreateSafeObject(&re);
+    CHECK(sub.str != NULL);
+    CHECK(NPJSON_RObjectPatch(&sub, "t", "9", 1));   // 更短
+    CHECK_TEXT(sub, "{\"t\":9,\"s\":\"ab\"}");
+    CHECK(NPJSON_RObjectPatch(&sub, "t", "8", 1));   // 等长
+    CHECK_TEXT(sub, "{\"t\":8,\"s\":\"ab\"}");
+    CHECK(NPJSON_RObjectPatch(&sub, "s", "\"xyz\"", 5));   // 更长
+    CHECK_TEXT(sub, "{\"t\":8,\"s\":\"xyz\"}");
+    CHECK(!NPJSON_RObjectPatch(&sub, "none", "1", 1));
+    NPJSON_DeleteSafeObject(&sub);
+
+    // NPJSON_RObjectUnSafeToSafe 只复制括号之间的内容
+    const char *wrapped = "  {\"t\":12}  ";
+    re.str              = wrapped;
+    re.Strlength        = (int)strlen(wrapped);
+    NPJSON_RObject raw  = NPJSON_CreateUnSafeObject(&re);
+    NPJSON_RObject safe = NPJSON_RObjectUnSafeToSafe(&raw);
+    CHECK_TEXT(safe, "{\"t\":12}");
+    CHECK(NPJSON_RObjectPatch(&safe, "t", "34", 2));
+    CHECK_TEXT(safe, "{\"t\":34}");
+    CHECK(NPJSON_RObjectPatch(&safe, "t", "5", 1));
+    CHECK_TEXT(safe, "{\"t\":5}");
+    NPJSON_DeleteSafeObject(&safe);
+
+    CHECK(g.live == 0);
+    CHECK(g.broken == 0);
+
+    // 合成对象 共享时写时复制 原对象不变
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizer(64);
+    sn.Add->Int(&sn, "id", 1);
+    sn.Add->String(&sn, "name", "ab");
+    NPJSON_SObject out = NPJSON_CreateSObject(&sn);
+    CHECK(NPJSON_SObjectPatch(&out, "id", "2", 1));
+    CHECK(strcmp(out.str, "{\"id\":2,\"name\":\"ab\"}") == 0);
+    CHECK(NPJSON_SObjectPatch(&out, "name", "null", 4));
+    CHECK(strcmp(out.str, "{\"id\":2,\"name\":null}") == 0);
+    NPJSON_DeleteSObject(&out);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file     pool.c
+ * @brief    NPJSON_PoolAllocator 复用空闲块、块内扩容不移动、NPJSON_PoolFlush/NPJSON_PoolTrim 归还
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+// 外部接口未释放的块数、分配次数
+static long _live;
+static long _total;
+
+void *NPJSON_Malloc(size_t size)
+{
+    void *p = malloc(size);
+    if (p != NULL) {
+        _live++;
+        _total++;
+    }
+    return p;
+}
+
+void NPJSON_Free(void *ptr)
+{
+    if (ptr != NULL)
+        _live--;
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+static bool _Fill(char *p, size_t n, char c)
+{
+    memset(p, c, n);
+    return true;
+}
+
+static bool _Same(const char *p, size_t n, char c)
+{
+    for (size_t i = 0; i < n; i++)
+        if (p[i] != c)
+            return false;
+    return true;
+}
+
+static bool _Synth(const NPJSON_Allocator *pool)
+{
+    NPJSON_Synthesizer sn = NPJSON_CreateSynthesizerEx(64, pool);
+    for (int i = 0; i < 200; i++)
+        sn.Add->Int(&sn, "value", i);
+    NPJSON_SObject out = NPJSON_CreateSObject(&sn);
+    bool           ok  = out.str != NULL && NPJSON_Validate(out.str, out.Strlength, NULL);
+    NPJSON_DeleteSObject(&out);
+    return ok;
+}
+
+int main(void)
+{
+    const NPJSON_Allocator *pool = NPJSON_PoolAllocator();
+    CHECK(pool != NULL && pool == NPJSON_PoolAllocator());
+
+    // 块内扩容不移动 超出时移动并保留内容
+    char *p = (char *)pool->Malloc(pool->ctx, 100);
+    CHECK(p != NULL && _Fill(p, 100, 'a'));
+    CHECK(pool->Realloc(pool->ctx, p, 120) == p);
+    p = (char *)pool->Realloc(pool->ctx, p, 5000);
+    CHECK(p != NULL && _Same(p, 100, 'a'));
+    pool->Free(pool->ctx, p);
+
+    // 释放的块再次分配 不调用外部接口
+    long total = _total;
+    p          = (char *)pool->Malloc(pool->ctx, 6000);   // 与上面同一级别
+    CHECK(p != NULL && _total == total);
+    pool->Free(pool->ctx, p);
+
+    // 超过最大块直接使用外部接口
+    p = (char *)pool->Malloc(pool->ctx, 3 << 20);
+    CHECK(p != NULL && _total == total + 1 && _Fill(p, 3 << 20, 'b'));
+    p = (char *)pool->Realloc(pool->ctx, p, 4 << 20);
+    CHECK(p != NULL && _Same(p, 3 << 20, 'b'));
+    long live = _live;
+    pool->Free(pool->ctx, p);
+    CHECK(_live == live - 1);
+    pool->Free(pool->ctx, NULL);
+
+    // 稳定状态下序列化不再分配
+    CHECK(_Synth(pool));
+    total = _total;
+    CHECK(_Synth(pool));
+    CHECK(_total == total);
+
+    // 归还全局缓存后仍可复用
+    NPJSON_PoolFlush();
+    CHECK(_Synth(pool));
+    CHECK(_total == total);
+
+    // 释放全部空闲块
+    CHECK(NPJSON_PoolTrim() > 0);
+    CHECK(_live == 0);
+    CHECK(NPJSON_PoolTrim() == 0);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file     print.c
+ * @brief    NPJSON_Print/NPJSON_PrintTo/NPJSON_PrintSize 输出合法 JSON 且两遍长度一致
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+// 生成后输出 与 expect 比较
+static int _RoundTrip(const char *src, const char *expect, bool packed)
+{
+    NPJSON_Option opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.packed     = packed;
+    const char *err = NULL;
+    NPJSONNode *n   = NPJSON_BuilderEx(src, strlen(src), &opt, &err);
+    CHECK(n != NULL && err == NULL);
+    NPJSON_SObject out = NPJSON_Print(n);
+    CHECK(out.str != NULL);
+    CHECK(strcmp(out.str, expect) == 0);
+    CHECK(NPJSON_Validate(out.str, out.Strlength, NULL));
+    CHECK(NPJSON_PrintSize(n) == (size_t)out.Strlength);
+    char buf[256];
+    CHECK(NPJSON_PrintTo(n, buf, sizeof(buf)) == (size_t)out.Strlength && strcmp(buf, expect) == 0);
+    CHECK(NPJSON_PrintTo(n, buf, (size_t)out.Strlength) == 0);   // 不足以容纳 '\0'
+    NPJSON_DeleteSObject(&out);
+    NPJSON_Release(&n);
+    return 0;
+}
+
+int main(void)
+{
+    // 空名称输出 ""
+    CHECK(_RoundTrip("{\"\":1,\"b\":2}", "{\"\":1,\"b\":2}", false) == 0);
+    CHECK(_RoundTrip("{\"o\":{\"\":[true,null]}}", "{\"o\":{\"\":[true,null]}}", false) == 0);
+
+    // 浮点数最短可还原 紧凑数组与节点一致
+    const char *num = "{\"a\":[0.1,2.5,-1e-7,1.7976931348623157e+308],\"b\":0.30000000000000004}";
+    const char *exp = "{\"a\":[0.1,2.5,-1e-07,1.7976931348623157e+308],\"b\":0.30000000000000004}";
+    CHECK(_RoundTrip(num, exp, false) == 0);
+    CHECK(_RoundTrip(num, exp, true) == 0);
+
+    // 查找跳过空名称成员
+    const char *src = "{\"\":1,\"b\":2}";
+    NPJSONNode *n   = NPJSON_Builder(src, strlen(src), NULL);
+    CHECK(n != NULL);
+    NPJSONNode *b = NPJSON_Find(n, "b");
+    CHECK(b != NULL && NPJSON_GetInt(b) == 2);
+    NPJSON_Release(&n);
+
+    // 大量浮点数 缓存扩容后两遍仍一致
+    size_t cap = 1 << 20, len = 0;
+    char * big = (char *)malloc(cap);
+    len += sprintf(big + len, "{\"v\":[");
+    for (int i = 0; i < 20000; i++)
+        len += sprintf(big + len, "%s%.17g", i ? "," : "", (double)i / 7);
+    len += sprintf(big + len, "]}");
+    for (int packed = 0; packed < 2; packed++) {
+        NPJSON_Option opt;
+        memset(&opt, 0, sizeof(opt));
+        opt.packed         = packed != 0;
+        n                  = NPJSON_BuilderEx(big, len, &opt, NULL);
+        NPJSON_SObject out = NPJSON_Print(n);
+        CHECK(out.str != NULL && (size_t)out.Strlength == NPJSON_PrintSize(n));
+        CHECK(NPJSON_Validate(out.str, out.Strlength, NULL));
+        // 再次生成 数值不变
+        NPJSONNode *again = NPJSON_BuilderEx(out.str, out.Strlength, &opt, NULL);
+        double      x[20000], y[20000];
+        CHECK(NPJSON_CopyDoubleArray(NPJSON_Find(n, "v"), x, 20000) == 20000);
+        CHECK(NPJSON_CopyDoubleArray(NPJSON_Find(again, "v"), y, 20000) == 20000);
+        CHECK(memcmp(x, y, sizeof(x)) == 0);
+        NPJSON_Release(&again);
+        NPJSON_DeleteSObject(&out);
+        NPJSON_Release(&n);
+    }
+    free(big);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file     scan.c
+ * @brief    NPJSON_Scan 回调顺序、层级、NPJSON_SKIP 跳过与 NPJSON_STOP 终止
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+typedef struct
+{
+    char trace[512];   // 回调顺序 名称@层级=值
+    int  stop;         // 第几次回调返回 NPJSON_STOP 0：不停止
+    int  calls;
+} Trace;
+
+static NPJSON_ScanResult _Scan(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    Trace *t = (Trace *)obj;
+    char   item[64];
+    // 数组元素没有名称 记录下标
+    if (name == NULL || name[0] == '\0') {
+        snprintf(item, sizeof(item), "[%d]", index);
+        strcat(t->trace, item);
+        name = "";
+    }
+    if (re->isArray)
+        snprintf(item, sizeof(item), "%s@%d=[", name, re->level);
+    else if (re->isObject)
+        snprintf(item, sizeof(item), "%s@%d={", name, re->level);
+    else if (re->isString)
+        snprintf(item, sizeof(item), "%s@%d=\"%.*s\"", name, re->level, re->Val.String.length, re->Val.String.ptr);
+    else if (re->isNumber)
+        snprintf(item, sizeof(item), "%s@%d=%lld", name, re->level, NPJSON_ResultGetInt(re));
+    else
+        snprintf(item, sizeof(item), "%s@%d=%c", name, re->level, re->isNull ? 'n' : re->Val.BinValue ? 't' : 'f');
+    strcat(t->trace, item);
+    strcat(t->trace, " ");
+    if (++t->calls == t->stop)
+        return NPJSON_STOP;
+    // 跳过的对象、数组不进入
+    return name != NULL && strcmp(name, "skip") == 0 ? NPJSON_SKIP : NPJSON_CONTINUE;
+}
+
+int main(void)
+{
+    const char *str = "{\"id\":7,\"s\":\"a\\u0041b\",\"ok\":true,\"n\":null,\"skip\":{\"deep\":[1,2]},\"o\":{\"x\":[3,{\"y\":false}]}}";
+    const char *err = NULL;
+    Trace       t;
+
+    memset(&t, 0, sizeof(t));
+    CHECK(NPJSON_Scan(str, (int)strlen(str), &t, _Scan, &err));
+    CHECK(err == NULL);
+    // 根对象不回调 顶层成员为 0 层 跳过的对象不进入
+    CHECK(strcmp(t.trace, "id@0=7 s@0=\"aAb\" ok@0=t n@0=n skip@0={ o@0={ x@1=[ [0]@2=3 [1]@2={ y@3=f ") == 0);
+
+    // 终止解析 返回 false
+    memset(&t, 0, sizeof(t));
+    t.stop = 3;
+    CHECK(!NPJSON_Scan(str, (int)strlen(str), &t, _Scan, &err));
+    CHECK(t.calls == 3);
+
+    // 格式错误 返回 false 并给出位置
+    const char *bad = "{\"a\":[1,2},\"b\":1}";
+    memset(&t, 0, sizeof(t));
+    err = NULL;
+    CHECK(!NPJSON_Scan(bad, (int)strlen(bad), &t, _Scan, &err));
+    CHECK(err != NULL && err >= bad && err <= bad + strlen(bad));
+
+    // 跳过的对象只回调一次 按括号索引直接定位到其后的成员
+    const char *skip = "{\"skip\":{\"a\":[1,2]},\"b\":1}";
+    memset(&t, 0, sizeof(t));
+    CHECK(NPJSON_Scan(skip, (int)strlen(skip), &t, _Scan, &err));
+    CHECK(strcmp(t.trace, "skip@0={ b@0=1 ") == 0);
+    return 0;
+}
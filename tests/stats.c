@@ -0,0 +1,89 @@
+/**
+ * @file     stats.c
+ * @brief    CFG_NPJSON_STATS 下 NPJSON_Resolve/NPJSON_Scan/NPJSON_BuilderEx 计数一致
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+static NPJSON_ScanResult _Scan(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)re;
+    (void)index;
+    (void)obj;
+    return NPJSON_CONTINUE;
+}
+
+// 递归解析 对象、数组回调后再进入
+static bool _Resolve(const char *name, NPJSON_Result *re, int index, void *obj)
+{
+    (void)name;
+    (void)index;
+    if (re->isObject || re->isArray)
+        return re->Resolve(re, obj, _Resolve);
+    return true;
+}
+
+int main(void)
+{
+    // 6 个值：a b 1 "y" c d
+    const char * str = "{\"a\":\"x\",\"b\":[1,\"y\"],\"c\":{\"d\":true}}";
+    size_t       len = strlen(str);
+    NPJSON_Stats st;
+
+    NPJSON_ResetStats();
+    NPJSONNode *n = NPJSON_Builder(str, len, NULL);
+    CHECK(n != NULL);
+    NPJSON_Release(&n);
+    CHECK(NPJSON_GetStats(&st));
+    CHECK(st.resolveCalls == 1);
+    CHECK(st.inputBytes == len);
+    CHECK(st.scannedBytes > 0);
+    CHECK(st.callbacks == 6);
+    CHECK(st.nodes == 7);
+
+    NPJSON_ResetStats();
+    CHECK(NPJSON_Scan(str, (int)len, NULL, _Scan, NULL));
+    CHECK(NPJSON_GetStats(&st));
+    CHECK(st.resolveCalls == 1);
+    CHECK(st.inputBytes == len);
+    CHECK(st.callbacks == 6);
+
+    NPJSON_ResetStats();
+    CHECK(NPJSON_Resolve(str, (int)len, NULL, _Resolve, NULL));
+    CHECK(NPJSON_GetStats(&st));
+    CHECK(st.inputBytes == len);
+    CHECK(st.callbacks == 6);
+    return 0;
+}
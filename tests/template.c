@@ -0,0 +1,84 @@
+/**
+ * @file     template.c
+ * @brief    NPJSON_CompileTemplate/NPJSON_TemplateRender 输出与值槽一致
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+int main(void)
+{
+    const char *     err = NULL;
+    NPJSON_Template *t   = NPJSON_CompileTemplate("{\"id\":%d,\"name\":%s,\"t\":%f,\"ok\":%b,\"big\":%l,\"raw\":%r,\"s\":\"100%\"}", &err);
+    CHECK(t != NULL && err == NULL);
+
+    // 字符串值槽转义并加引号 %r 原样写入 字符串内的 % 不是值槽
+    const char *   expect = "{\"id\":7,\"name\":\"a\\\"b\",\"t\":23.5,\"ok\":true,\"big\":1234567890123,\"raw\":[1,2],\"s\":\"100%\"}";
+    NPJSON_SObject out    = NPJSON_TemplateRender(t, 7, "a\"b", 23.5, true, 1234567890123LL, "[1,2]");
+    CHECK(out.str != NULL && strcmp(out.str, expect) == 0 && out.Strlength == (int)strlen(expect));
+    CHECK(NPJSON_Validate(out.str, out.Strlength, NULL));
+    NPJSON_DeleteSObject(&out);
+
+    // 长度上限 输出到指定缓存
+    size_t size = NPJSON_TemplateSize(t, -2147483647 - 1, "x\n", -1e300, false, -9223372036854775807LL - 1, "{}");
+    char   buf[512];
+    CHECK(size > 0 && size < sizeof(buf));
+    size_t n = NPJSON_TemplateRenderTo(t, buf, sizeof(buf), -2147483647 - 1, "x\n", -1e300, false, -9223372036854775807LL - 1, "{}");
+    CHECK(n > 0 && n <= size && n == strlen(buf));
+    CHECK(strcmp(buf, "{\"id\":-2147483648,\"name\":\"x\\n\",\"t\":-1e+300,\"ok\":false,\"big\":-9223372036854775808,\"raw\":{},\"s\":\"100%\"}") == 0);
+    CHECK(NPJSON_Validate(buf, n, NULL));
+    CHECK(NPJSON_TemplateRenderTo(t, buf, 16, 1, "x", 1.0, true, 1LL, "1") == 0);   // 空间不足
+
+    // NULL 字符串输出 null
+    out = NPJSON_TemplateRender(t, 0, (const char *)NULL, 0.0, false, 0LL, (const char *)NULL);
+    CHECK(out.str != NULL && strstr(out.str, "\"name\":null") != NULL && strstr(out.str, "\"raw\":null") != NULL);
+    NPJSON_DeleteSObject(&out);
+    NPJSON_DeleteTemplate(t);
+
+    // 没有值槽的模板
+    t = NPJSON_CompileTemplate("[1,2]", &err);
+    CHECK(t != NULL);
+    out = NPJSON_TemplateRender(t);
+    CHECK(out.str != NULL && strcmp(out.str, "[1,2]") == 0);
+    NPJSON_DeleteSObject(&out);
+    NPJSON_DeleteTemplate(t);
+
+    // 编译失败 给出位置
+    const char *bad[] = {"{\"a\":%x}", "{\"a\":%d", "{\"a\" %d}", "{%d:1}"};
+    for (int i = 0; i < 4; i++) {
+        err = NULL;
+        CHECK(NPJSON_CompileTemplate(bad[i], &err) == NULL);
+        CHECK(err != NULL && err >= bad[i] && err <= bad[i] + strlen(bad[i]));
+    }
+    return 0;
+}
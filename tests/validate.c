@@ -0,0 +1,109 @@
+/**
+ * @file     validate.c
+ * @brief    NPJSON_Validate/NPJSON_CheckUTF8 按 RFC 8259 接受合法输入、拒绝非法输入
+ * @author   CXS (chenxiangshu@outlook.com)
+ * @date     2026-10-18
+ *
+ * @copyright Copyright (c) 2024  chenxiangshu@outlook.com
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NPJSON.h"
+
+void *NPJSON_Malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void NPJSON_Free(void *ptr)
+{
+    free(ptr);
+}
+
+void *NPJSON_Realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond)) {                                                 \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                  \
+        }                                                              \
+    } while (0)
+
+static bool _Valid(const char *s)
+{
+    return NPJSON_Validate(s, strlen(s), NULL);
+}
+
+int main(void)
+{
+    // 合法
+    CHECK(_Valid("{}"));
+    CHECK(_Valid("[]"));
+    CHECK(_Valid(" { \"a\" : [ 1 , -0.5e+3 , 0 , 1E9 , true , false , null ] } "));
+    CHECK(_Valid("{\"s\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\uD83D\\uDE00\"}"));
+    CHECK(_Valid("{\"u\":\"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\"}"));
+    CHECK(_Valid("[{\"a\":{}},[[]]]"));
+
+    // 数字格式
+    CHECK(!_Valid("{\"a\":01}"));
+    CHECK(!_Valid("{\"a\":1.}"));
+    CHECK(!_Valid("{\"a\":.5}"));
+    CHECK(!_Valid("{\"a\":+1}"));
+    CHECK(!_Valid("{\"a\":-}"));
+    CHECK(!_Valid("{\"a\":1e}"));
+    CHECK(!_Valid("{\"a\":NaN}"));
+
+    // 字符串转义、控制字符、UTF-8
+    CHECK(!_Valid("{\"a\":\"\\x\"}"));
+    CHECK(!_Valid("{\"a\":\"\\u12\"}"));
+    CHECK(!_Valid("{\"a\":\"\x01\"}"));
+    CHECK(!_Valid("{\"a\":\"\xC0\x80\"}"));
+    CHECK(!_Valid("{\"a\":\"abc}"));
+
+    // 结构
+    CHECK(!_Valid(""));
+    CHECK(!_Valid("{"));
+    CHECK(!_Valid("{\"a\":1,}"));
+    CHECK(!_Valid("[1,]"));
+    CHECK(!_Valid("{\"a\" 1}"));
+    CHECK(!_Valid("{'a':1}"));
+    CHECK(!_Valid("[tru]"));
+    CHECK(!_Valid("[1 2]"));
+    CHECK(!_Valid("{} x"));
+    CHECK(!_Valid("{\"a\":1]"));
+
+    // 错误位置指向输入内
+    const char *bad = "{\"a\":[1,2,}";
+    const char *err = NULL;
+    CHECK(!NPJSON_Validate(bad, strlen(bad), &err));
+    CHECK(err != NULL && err >= bad && err <= bad + strlen(bad));
+
+    // 按长度校验 不依赖 '\0'
+    CHECK(NPJSON_Validate("[1]xyz", 3, NULL));
+
+    // 嵌套深度上限
+    size_t n   = NPJSON_MAX_DEPTH + 1;
+    char * deep = (char *)malloc(n * 2);
+    CHECK(deep != NULL);
+    memset(deep, '[', n);
+    memset(deep + n, ']', n);
+    CHECK(!NPJSON_Validate(deep, n * 2, NULL));
+    CHECK(NPJSON_Validate(deep + 1, (n - 1) * 2, NULL));
+    free(deep);
+
+    // UTF-8
+    CHECK(NPJSON_CheckUTF8("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", 10));
+    CHECK(!NPJSON_CheckUTF8("\xC0\x80", 2));           // 超长编码
+    CHECK(!NPJSON_CheckUTF8("\xED\xA0\x80", 3));       // 代理区
+    CHECK(!NPJSON_CheckUTF8("\xF4\x90\x80\x80", 4));   // 超过 U+10FFFF
+    CHECK(!NPJSON_CheckUTF8("\xE2\x82", 2));           // 截断
+    CHECK(!NPJSON_CheckUTF8("\x80", 1));
+    return 0;
+}